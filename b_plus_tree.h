@@ -1,27 +1,720 @@
 #pragma once
 
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
 
-template<typename K, typename V>
-class b_plus_tree 
+// Keys and values live in separate arrays inside each leaf so scans and in-node
+// searches touch only key bytes. NodeBytes sets the target node footprint.
+template<typename K, typename V, typename Compare = std::less<K>, std::size_t NodeBytes = 512>
+class b_plus_tree
 {
+    struct node_base
+    {
+        std::uint16_t count = 0;
+        bool leaf;
+
+        explicit node_base(const bool is_leaf) : leaf(is_leaf) {}
+    };
+
+    static constexpr std::size_t cache_line = 64;
+    static constexpr std::size_t header_bytes = sizeof(node_base) + sizeof(void*);
+
+    static constexpr std::size_t fit(const std::size_t payload, const std::size_t per_entry) noexcept
+    {
+        return payload > per_entry * 4 ? payload / per_entry : 4;
+    }
+
+public:
+    static constexpr std::size_t leaf_capacity = fit(NodeBytes - header_bytes - sizeof(void*), sizeof(K) + sizeof(V));
+    static constexpr std::size_t inner_capacity = fit(NodeBytes - header_bytes, sizeof(K) + sizeof(void*));
+
+private:
+    static_assert(leaf_capacity < 65535 && inner_capacity < 65535, "node too large");
+
+    static constexpr std::size_t min_leaf = leaf_capacity / 2;
+    static constexpr std::size_t min_inner = (inner_capacity - 1) / 2;
+
+    struct alignas(cache_line) leaf_node : node_base
+    {
+        leaf_node* prev = nullptr;
+        leaf_node* next = nullptr;
+        K keys[leaf_capacity];
+        V values[leaf_capacity];
+
+        leaf_node() : node_base(true) {}
+    };
+
+    struct alignas(cache_line) inner_node : node_base
+    {
+        K keys[inner_capacity];
+        node_base* children[inner_capacity + 1];
+
+        inner_node() : node_base(false) {}
+    };
+
+    template<bool Const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, std::conditional_t<Const, const V&, V&>>;
+        using pointer = void;
+
+        basic_iterator() = default;
+
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& other) : leaf_(other.leaf_), pos_(other.pos_) {}
+
+        const K& key() const
+        {
+            return leaf_->keys[pos_];
+        }
+
+        std::conditional_t<Const, const V&, V&> value() const
+        {
+            return leaf_->values[pos_];
+        }
+
+        reference operator*() const
+        {
+            return reference(leaf_->keys[pos_], leaf_->values[pos_]);
+        }
+
+        basic_iterator& operator++()
+        {
+            if (++pos_ == leaf_->count)
+            {
+                leaf_ = leaf_->next;
+                pos_ = 0;
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            basic_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const basic_iterator& o) const noexcept
+        {
+            return leaf_ == o.leaf_ && pos_ == o.pos_;
+        }
+
+        bool operator!=(const basic_iterator& o) const noexcept
+        {
+            return !(*this == o);
+        }
+
+    private:
+        friend class b_plus_tree;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(leaf_node* leaf, const std::size_t pos) : leaf_(leaf), pos_(pos)
+        {
+            if (leaf_ && pos_ == leaf_->count)
+            {
+                leaf_ = leaf_->next;
+                pos_ = 0;
+            }
+        }
+
+        leaf_node* leaf_ = nullptr;
+        std::size_t pos_ = 0;
+    };
+
 public:
-    void insert(const K& k, const V& v) 
-    { 
-        data_[k] = v; 
+    using key_type = K;
+    using mapped_type = V;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    b_plus_tree() = default;
+    explicit b_plus_tree(const Compare& comp) : comp_(comp) {}
+
+    b_plus_tree(const b_plus_tree& other) : comp_(other.comp_)
+    {
+        bulk_load(other.begin(), other.end());
+    }
+
+    b_plus_tree(b_plus_tree&& other) noexcept
+        : root_(other.root_), first_(other.first_), size_(other.size_), comp_(std::move(other.comp_))
+    {
+        other.root_ = nullptr;
+        other.first_ = nullptr;
+        other.size_ = 0;
+    }
+
+    b_plus_tree& operator=(b_plus_tree other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~b_plus_tree()
+    {
+        clear();
+    }
+
+    void swap(b_plus_tree& other) noexcept
+    {
+        using std::swap;
+        swap(root_, other.root_);
+        swap(first_, other.first_);
+        swap(size_, other.size_);
+        swap(comp_, other.comp_);
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_;
     }
 
-    V* find(const K& k) 
+    [[nodiscard]] bool empty() const noexcept
     {
-        auto it = data_.find(k);
-        
-        if (it == data_.end()) 
+        return size_ == 0;
+    }
+
+    void clear() noexcept
+    {
+        destroy(root_);
+        root_ = nullptr;
+        first_ = nullptr;
+        size_ = 0;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(first_, 0);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(first_, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator();
+    }
+
+    void insert(const K& k, const V& v)
+    {
+        if (!root_)
+        {
+            auto* leaf = new leaf_node();
+            root_ = leaf;
+            first_ = leaf;
+        }
+
+        if (is_full(root_))
+        {
+            auto* new_root = new inner_node();
+            new_root->children[0] = root_;
+            root_ = new_root;
+            split_child(new_root, 0);
+        }
+
+        node_base* cur = root_;
+        while (!cur->leaf)
+        {
+            auto* inner = static_cast<inner_node*>(cur);
+            std::size_t i = child_index(inner, k);
+
+            if (is_full(inner->children[i]))
+            {
+                split_child(inner, i);
+                if (!comp_(k, inner->keys[i]))
+                {
+                    ++i;
+                }
+            }
+            cur = inner->children[i];
+        }
+
+        auto* leaf = static_cast<leaf_node*>(cur);
+        const std::size_t pos = leaf_lower(leaf, k);
+
+        if (pos < leaf->count && !comp_(k, leaf->keys[pos]))
+        {
+            leaf->values[pos] = v;
+            return;
+        }
+
+        std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+        std::move_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+        leaf->keys[pos] = k;
+        leaf->values[pos] = v;
+        ++leaf->count;
+        ++size_;
+    }
+
+    V* find(const K& k)
+    {
+        return const_cast<V*>(std::as_const(*this).find(k));
+    }
+
+    const V* find(const K& k) const
+    {
+        const leaf_node* leaf = find_leaf(k);
+        if (!leaf)
         {
             return nullptr;
         }
-        return &it->second;
+
+        const std::size_t pos = leaf_lower(leaf, k);
+        if (pos < leaf->count && !comp_(k, leaf->keys[pos]))
+        {
+            return &leaf->values[pos];
+        }
+        return nullptr;
+    }
+
+    bool contains(const K& k) const
+    {
+        return find(k) != nullptr;
+    }
+
+    iterator lower_bound(const K& k)
+    {
+        leaf_node* leaf = find_leaf(k);
+        return leaf ? iterator(leaf, leaf_lower(leaf, k)) : end();
+    }
+
+    const_iterator lower_bound(const K& k) const
+    {
+        leaf_node* leaf = find_leaf(k);
+        return leaf ? const_iterator(leaf, leaf_lower(leaf, k)) : end();
+    }
+
+    template<typename F>
+    void for_each_range(const K& lo, const K& hi, F&& f) const
+    {
+        const leaf_node* leaf = find_leaf(lo);
+        if (!leaf)
+        {
+            return;
+        }
+
+        std::size_t pos = leaf_lower(leaf, lo);
+        while (leaf)
+        {
+            for (; pos < leaf->count; ++pos)
+            {
+                if (!comp_(leaf->keys[pos], hi))
+                {
+                    return;
+                }
+                f(leaf->keys[pos], leaf->values[pos]);
+            }
+            leaf = leaf->next;
+            pos = 0;
+        }
+    }
+
+    bool erase(const K& k)
+    {
+        if (!root_ || !erase_rec(root_, k))
+        {
+            return false;
+        }
+
+        --size_;
+
+        if (!root_->leaf && root_->count == 0)
+        {
+            auto* old = static_cast<inner_node*>(root_);
+            root_ = old->children[0];
+            delete old;
+        }
+        else if (root_->leaf && root_->count == 0)
+        {
+            delete static_cast<leaf_node*>(root_);
+            root_ = nullptr;
+            first_ = nullptr;
+        }
+        return true;
+    }
+
+    // Replaces the contents with [first, last), which must be sorted by key; for equal
+    // keys the last value wins. Throws std::invalid_argument, leaving the tree as it
+    // was, if a key is less than the one before it.
+    template<typename InputIt>
+    void bulk_load(InputIt first, InputIt last)
+    {
+        std::vector<std::pair<K, V>> items;
+        for (; first != last; ++first)
+        {
+            auto&& kv = *first;
+            if (!items.empty() && !comp_(items.back().first, kv.first))
+            {
+                if (comp_(kv.first, items.back().first))
+                {
+                    throw std::invalid_argument("b_plus_tree::bulk_load: input not sorted");
+                }
+                items.back().second = kv.second;
+                continue;
+            }
+            items.emplace_back(kv.first, kv.second);
+        }
+
+        clear();
+        if (items.empty())
+        {
+            return;
+        }
+
+        std::vector<std::pair<node_base*, K>> level;
+        const std::size_t leaf_count = (items.size() + leaf_capacity - 1) / leaf_capacity;
+        leaf_node* prev = nullptr;
+        std::size_t idx = 0;
+
+        for (std::size_t l = 0; l < leaf_count; ++l)
+        {
+            const std::size_t take = share(items.size(), leaf_count, l);
+            auto* leaf = new leaf_node();
+
+            for (std::size_t j = 0; j < take; ++j, ++idx)
+            {
+                leaf->keys[j] = std::move(items[idx].first);
+                leaf->values[j] = std::move(items[idx].second);
+            }
+            leaf->count = static_cast<std::uint16_t>(take);
+            leaf->prev = prev;
+
+            if (prev)
+            {
+                prev->next = leaf;
+            }
+            else
+            {
+                first_ = leaf;
+            }
+
+            prev = leaf;
+            level.emplace_back(leaf, leaf->keys[0]);
+        }
+
+        while (level.size() > 1)
+        {
+            std::vector<std::pair<node_base*, K>> parents;
+            const std::size_t fan = inner_capacity + 1;
+            const std::size_t node_count = (level.size() + fan - 1) / fan;
+            std::size_t c = 0;
+
+            for (std::size_t p = 0; p < node_count; ++p)
+            {
+                const std::size_t take = share(level.size(), node_count, p);
+                auto* inner = new inner_node();
+
+                for (std::size_t j = 0; j < take; ++j, ++c)
+                {
+                    inner->children[j] = level[c].first;
+                    if (j > 0)
+                    {
+                        inner->keys[j - 1] = level[c].second;
+                    }
+                }
+                inner->count = static_cast<std::uint16_t>(take - 1);
+                parents.emplace_back(inner, level[c - take].second);
+            }
+            level.swap(parents);
+        }
+
+        root_ = level.front().first;
+        size_ = items.size();
+    }
+
+    template<typename Map>
+    void bulk_load(const Map& sorted)
+    {
+        bulk_load(std::begin(sorted), std::end(sorted));
     }
 
 private:
-    std::map<K,V> data_;
+    static std::size_t share(const std::size_t total, const std::size_t parts, const std::size_t i) noexcept
+    {
+        return total / parts + (i < total % parts ? 1 : 0);
+    }
+
+    static bool is_full(const node_base* n) noexcept
+    {
+        return n->count == (n->leaf ? leaf_capacity : inner_capacity);
+    }
+
+    std::size_t child_index(const inner_node* n, const K& k) const
+    {
+        return std::upper_bound(n->keys, n->keys + n->count, k, comp_) - n->keys;
+    }
+
+    std::size_t leaf_lower(const leaf_node* n, const K& k) const
+    {
+        return std::lower_bound(n->keys, n->keys + n->count, k, comp_) - n->keys;
+    }
+
+    leaf_node* find_leaf(const K& k) const
+    {
+        node_base* cur = root_;
+        if (!cur)
+        {
+            return nullptr;
+        }
+
+        while (!cur->leaf)
+        {
+            auto* inner = static_cast<inner_node*>(cur);
+            cur = inner->children[child_index(inner, k)];
+        }
+        return static_cast<leaf_node*>(cur);
+    }
+
+    void split_child(inner_node* parent, const std::size_t i)
+    {
+        node_base* child = parent->children[i];
+        K separator;
+        node_base* right_node;
+
+        if (child->leaf)
+        {
+            auto* left = static_cast<leaf_node*>(child);
+            auto* right = new leaf_node();
+            const std::size_t keep = leaf_capacity / 2;
+            const std::size_t moved = left->count - keep;
+
+            std::move(left->keys + keep, left->keys + left->count, right->keys);
+            std::move(left->values + keep, left->values + left->count, right->values);
+            right->count = static_cast<std::uint16_t>(moved);
+            left->count = static_cast<std::uint16_t>(keep);
+
+            right->next = left->next;
+            right->prev = left;
+            if (left->next)
+            {
+                left->next->prev = right;
+            }
+            left->next = right;
+
+            separator = right->keys[0];
+            right_node = right;
+        }
+        else
+        {
+            auto* left = static_cast<inner_node*>(child);
+            auto* right = new inner_node();
+            const std::size_t mid = inner_capacity / 2;
+
+            separator = std::move(left->keys[mid]);
+            std::move(left->keys + mid + 1, left->keys + left->count, right->keys);
+            std::copy(left->children + mid + 1, left->children + left->count + 1, right->children);
+            right->count = static_cast<std::uint16_t>(left->count - mid - 1);
+            left->count = static_cast<std::uint16_t>(mid);
+
+            right_node = right;
+        }
+
+        std::move_backward(parent->keys + i, parent->keys + parent->count, parent->keys + parent->count + 1);
+        std::copy_backward(parent->children + i + 1, parent->children + parent->count + 1, parent->children + parent->count + 2);
+        parent->keys[i] = std::move(separator);
+        parent->children[i + 1] = right_node;
+        ++parent->count;
+    }
+
+    bool erase_rec(node_base* n, const K& k)
+    {
+        if (n->leaf)
+        {
+            auto* leaf = static_cast<leaf_node*>(n);
+            const std::size_t pos = leaf_lower(leaf, k);
+
+            if (pos == leaf->count || comp_(k, leaf->keys[pos]))
+            {
+                return false;
+            }
+
+            std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+            std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+            --leaf->count;
+            return true;
+        }
+
+        auto* inner = static_cast<inner_node*>(n);
+        const std::size_t i = child_index(inner, k);
+
+        if (!erase_rec(inner->children[i], k))
+        {
+            return false;
+        }
+
+        node_base* child = inner->children[i];
+        if (child->count < (child->leaf ? min_leaf : min_inner))
+        {
+            rebalance(inner, i);
+        }
+        return true;
+    }
+
+    void rebalance(inner_node* parent, const std::size_t i)
+    {
+        node_base* left = i > 0 ? parent->children[i - 1] : nullptr;
+        node_base* right = i < parent->count ? parent->children[i + 1] : nullptr;
+        const std::size_t min_count = parent->children[i]->leaf ? min_leaf : min_inner;
+
+        if (left && left->count > min_count)
+        {
+            borrow_from_left(parent, i);
+        }
+        else if (right && right->count > min_count)
+        {
+            borrow_from_right(parent, i);
+        }
+        else if (left)
+        {
+            merge(parent, i - 1);
+        }
+        else if (right)
+        {
+            merge(parent, i);
+        }
+    }
+
+    void borrow_from_left(inner_node* parent, const std::size_t i)
+    {
+        if (parent->children[i]->leaf)
+        {
+            auto* child = static_cast<leaf_node*>(parent->children[i]);
+            auto* left = static_cast<leaf_node*>(parent->children[i - 1]);
+
+            std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+            std::move_backward(child->values, child->values + child->count, child->values + child->count + 1);
+            child->keys[0] = std::move(left->keys[left->count - 1]);
+            child->values[0] = std::move(left->values[left->count - 1]);
+            ++child->count;
+            --left->count;
+            parent->keys[i - 1] = child->keys[0];
+            return;
+        }
+
+        auto* child = static_cast<inner_node*>(parent->children[i]);
+        auto* left = static_cast<inner_node*>(parent->children[i - 1]);
+
+        std::move_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+        std::copy_backward(child->children, child->children + child->count + 1, child->children + child->count + 2);
+        child->keys[0] = std::move(parent->keys[i - 1]);
+        child->children[0] = left->children[left->count];
+        parent->keys[i - 1] = std::move(left->keys[left->count - 1]);
+        ++child->count;
+        --left->count;
+    }
+
+    void borrow_from_right(inner_node* parent, const std::size_t i)
+    {
+        if (parent->children[i]->leaf)
+        {
+            auto* child = static_cast<leaf_node*>(parent->children[i]);
+            auto* right = static_cast<leaf_node*>(parent->children[i + 1]);
+
+            child->keys[child->count] = std::move(right->keys[0]);
+            child->values[child->count] = std::move(right->values[0]);
+            ++child->count;
+
+            std::move(right->keys + 1, right->keys + right->count, right->keys);
+            std::move(right->values + 1, right->values + right->count, right->values);
+            --right->count;
+            parent->keys[i] = right->keys[0];
+            return;
+        }
+
+        auto* child = static_cast<inner_node*>(parent->children[i]);
+        auto* right = static_cast<inner_node*>(parent->children[i + 1]);
+
+        child->keys[child->count] = std::move(parent->keys[i]);
+        child->children[child->count + 1] = right->children[0];
+        ++child->count;
+
+        parent->keys[i] = std::move(right->keys[0]);
+        std::move(right->keys + 1, right->keys + right->count, right->keys);
+        std::copy(right->children + 1, right->children + right->count + 1, right->children);
+        --right->count;
+    }
+
+    void merge(inner_node* parent, const std::size_t i)
+    {
+        node_base* l = parent->children[i];
+        node_base* r = parent->children[i + 1];
+
+        if (l->leaf)
+        {
+            auto* left = static_cast<leaf_node*>(l);
+            auto* right = static_cast<leaf_node*>(r);
+
+            std::move(right->keys, right->keys + right->count, left->keys + left->count);
+            std::move(right->values, right->values + right->count, left->values + left->count);
+            left->count = static_cast<std::uint16_t>(left->count + right->count);
+
+            left->next = right->next;
+            if (right->next)
+            {
+                right->next->prev = left;
+            }
+            delete right;
+        }
+        else
+        {
+            auto* left = static_cast<inner_node*>(l);
+            auto* right = static_cast<inner_node*>(r);
+
+            left->keys[left->count] = std::move(parent->keys[i]);
+            std::move(right->keys, right->keys + right->count, left->keys + left->count + 1);
+            std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+            left->count = static_cast<std::uint16_t>(left->count + right->count + 1);
+            delete right;
+        }
+
+        std::move(parent->keys + i + 1, parent->keys + parent->count, parent->keys + i);
+        std::copy(parent->children + i + 2, parent->children + parent->count + 1, parent->children + i + 1);
+        --parent->count;
+    }
+
+    static void destroy(node_base* n) noexcept
+    {
+        if (!n)
+        {
+            return;
+        }
+
+        if (n->leaf)
+        {
+            delete static_cast<leaf_node*>(n);
+            return;
+        }
+
+        auto* inner = static_cast<inner_node*>(n);
+        for (std::size_t i = 0; i <= inner->count; ++i)
+        {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+
+    node_base* root_ = nullptr;
+    leaf_node* first_ = nullptr;
+    size_type size_ = 0;
+    Compare comp_;
 };
@@ -0,0 +1,105 @@
+#include "bench_common.h"
+#include "b_plus_tree.h"
+#include "map.h"
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 10000000);
+    const std::size_t lookups = mib_bench::arg_or(argc, argv, 2, 5000000);
+    const std::size_t scans = mib_bench::arg_or(argc, argv, 3, 100000);
+    const std::size_t scan_len = 100;
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> sorted(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        sorted[i] = {i * 2, i};
+    }
+
+    std::mt19937_64 rng(7);
+    std::vector<std::uint64_t> probes(lookups);
+    for (auto& p : probes)
+    {
+        p = rng() % (2 * n);
+    }
+
+    b_plus_tree<std::uint64_t, std::uint64_t> bpt;
+    mib_bench::report("b_plus_tree bulk_load", n, mib_bench::time_ms([&]
+    {
+        bpt.bulk_load(sorted.begin(), sorted.end());
+    }));
+
+    map<std::uint64_t, std::uint64_t> rb;
+    mib_bench::report("map insert (sorted)", n, mib_bench::time_ms([&]
+    {
+        for (const auto& kv : sorted)
+        {
+            rb.insert(kv);
+        }
+    }));
+
+    std::shuffle(sorted.begin(), sorted.end(), rng);
+    b_plus_tree<std::uint64_t, std::uint64_t> bpt_random;
+    mib_bench::report("b_plus_tree insert (random)", n, mib_bench::time_ms([&]
+    {
+        for (const auto& kv : sorted)
+        {
+            bpt_random.insert(kv.first, kv.second);
+        }
+    }));
+
+    std::uint64_t sink = 0;
+    mib_bench::report("b_plus_tree find", lookups, mib_bench::time_ms([&]
+    {
+        for (const std::uint64_t k : probes)
+        {
+            if (const auto* v = bpt.find(k))
+            {
+                sink += *v;
+            }
+        }
+    }));
+
+    mib_bench::report("map find", lookups, mib_bench::time_ms([&]
+    {
+        for (const std::uint64_t k : probes)
+        {
+            auto it = rb.find(k);
+            if (it != rb.end())
+            {
+                sink += it->second;
+            }
+        }
+    }));
+
+    mib_bench::report("b_plus_tree range scan x100", scans * scan_len, mib_bench::time_ms([&]
+    {
+        for (std::size_t s = 0; s < scans; ++s)
+        {
+            const std::uint64_t lo = probes[s];
+            bpt.for_each_range(lo, lo + 2 * scan_len, [&](const std::uint64_t, const std::uint64_t v)
+            {
+                sink += v;
+            });
+        }
+    }));
+
+    mib_bench::report("map range scan x100", scans * scan_len, mib_bench::time_ms([&]
+    {
+        for (std::size_t s = 0; s < scans; ++s)
+        {
+            const std::uint64_t lo = probes[s];
+            for (auto it = rb.lower_bound(lo); it != rb.end() && it->first < lo + 2 * scan_len; ++it)
+            {
+                sink += it->second;
+            }
+        }
+    }));
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
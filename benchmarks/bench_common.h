@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+#include <utility>
+
+namespace mib_bench
+{
+template<typename T>
+inline void do_not_optimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+template<typename F>
+double time_ms(F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::forward<F>(f)();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+inline std::size_t arg_or(const int argc, char** argv, const int index, const std::size_t fallback)
+{
+    if (argc > index)
+    {
+        return static_cast<std::size_t>(std::strtoull(argv[index], nullptr, 10));
+    }
+    return fallback;
+}
+
+inline void report(const char* name, const std::size_t n, const double ms)
+{
+    const double ns_per_op = n ? ms * 1e6 / static_cast<double>(n) : 0.0;
+    std::printf("%-32s n=%-12zu %10.3f ms %8.2f ns/op\n", name, n, ms, ns_per_op);
+}
+}
@@ -0,0 +1,105 @@
+#include "bench_common.h"
+#include "dynamic_bitset.h"
+
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 1000000000);
+    const std::size_t queries = mib_bench::arg_or(argc, argv, 2, 10000000);
+
+    std::mt19937_64 rng(14);
+    dynamic_bitset a(n);
+    dynamic_bitset b(n);
+    for (std::size_t i = 0; i < n / 8; ++i)
+    {
+        a.set(rng() % n);
+        b.set(rng() % n);
+    }
+
+    std::uint64_t sink = 0;
+    const std::size_t words = (n + 63) / 64;
+
+    mib_bench::report("scalar word popcount", n, mib_bench::time_ms([&]
+    {
+        const std::uint64_t* w = a.data();
+        std::size_t c = 0;
+        for (std::size_t i = 0; i < words; ++i)
+        {
+            c += static_cast<std::size_t>(mib::detail::popcount(w[i]));
+        }
+        sink += c;
+    }));
+
+    mib_bench::report("dynamic_bitset::count", n, mib_bench::time_ms([&]
+    {
+        sink += a.count();
+    }));
+
+    mib_bench::report("dynamic_bitset::any (all zero)", n, mib_bench::time_ms([&]
+    {
+        sink += dynamic_bitset(n).any();
+    }));
+
+    mib_bench::report("dynamic_bitset &=", n, mib_bench::time_ms([&]
+    {
+        a &= b;
+    }));
+
+    mib_bench::report("dynamic_bitset |=", n, mib_bench::time_ms([&]
+    {
+        a |= b;
+    }));
+
+    mib_bench::report("dynamic_bitset ~ (copy)", n, mib_bench::time_ms([&]
+    {
+        sink += (~a).data()[0];
+    }));
+
+    std::size_t ones = 0;
+    mib_bench::report("find_first/find_next scan", n, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = a.find_first(); i != dynamic_bitset::npos; i = a.find_next(i))
+        {
+            ++ones;
+        }
+    }));
+    std::printf("    set bits: %zu\n", ones);
+
+    mib_bench::report("build_rank_index", n, mib_bench::time_ms([&]
+    {
+        a.build_rank_index();
+    }));
+
+    mib_bench::report("rank (random)", queries, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < queries; ++i)
+        {
+            sink += a.rank(rng() % n);
+        }
+    }));
+
+    mib_bench::report("select (random)", queries, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < queries; ++i)
+        {
+            sink += a.select(rng() % ones);
+        }
+    }));
+
+    std::vector<bool> ref(n);
+    for (std::size_t i = a.find_first(); i != dynamic_bitset::npos; i = a.find_next(i))
+    {
+        ref[i] = true;
+    }
+    mib_bench::report("std::vector<bool> count", n, mib_bench::time_ms([&]
+    {
+        sink += static_cast<std::uint64_t>(std::count(ref.begin(), ref.end(), true));
+    }));
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "bench_common.h"
+#include "dynamic_bitset_view.h"
+
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+
+// Startup paths for a large filter: rebuild from source ids, stream load, and mmap.
+// The file was just written, so the load numbers assume a warm page cache.
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 1000000000);
+    const std::string path = argc > 2 ? argv[2] : "bitset_startup.bin";
+
+    std::mt19937_64 rng(16);
+    std::vector<std::uint64_t> ids(n / 16);
+    for (auto& id : ids)
+    {
+        id = rng() % n;
+    }
+
+    dynamic_bitset built;
+    mib_bench::report("rebuild from ids", ids.size(), mib_bench::time_ms([&]
+    {
+        built = dynamic_bitset(n);
+        for (const std::uint64_t id : ids)
+        {
+            built.set(id);
+        }
+    }));
+
+    mib_bench::report("save", n, mib_bench::time_ms([&]
+    {
+        std::ofstream out(path, std::ios::binary);
+        built.save(out);
+    }));
+
+    std::size_t loaded_count = 0;
+    mib_bench::report("dynamic_bitset::load", n, mib_bench::time_ms([&]
+    {
+        std::ifstream in(path, std::ios::binary);
+        loaded_count = dynamic_bitset::load(in).count();
+    }));
+
+    std::size_t mapped_count = 0;
+    mib_bench::report("map_file (header only)", n, mib_bench::time_ms([&]
+    {
+        const dynamic_bitset_view view = dynamic_bitset_view::map_file(path);
+        mapped_count = view.size();
+    }));
+
+    mib_bench::report("map_file + test(1000 bits)", 1000, mib_bench::time_ms([&]
+    {
+        const dynamic_bitset_view view = dynamic_bitset_view::map_file(path);
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            mapped_count += view.test(rng() % n);
+        }
+    }));
+
+    mib_bench::report("map_file + count", n, mib_bench::time_ms([&]
+    {
+        mapped_count = dynamic_bitset_view::map_file(path).count();
+    }));
+
+    mib_bench::report("map_file(verify_checksum)", n, mib_bench::time_ms([&]
+    {
+        mib_bench::do_not_optimize(dynamic_bitset_view::map_file(path, true).size());
+    }));
+
+    if (loaded_count != mapped_count || loaded_count != built.count())
+    {
+        std::printf("mismatch: %zu loaded, %zu mapped\n", loaded_count, mapped_count);
+    }
+    std::remove(path.c_str());
+    return 0;
+}
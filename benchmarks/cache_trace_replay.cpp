@@ -0,0 +1,98 @@
+#include "bench_common.h"
+#include "lru_cache.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+// One key per line; distinct keys are numbered in order of first appearance.
+std::vector<std::uint64_t> read_trace(const char* path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        std::fprintf(stderr, "cannot open trace %s\n", path);
+        std::exit(1);
+    }
+
+    std::unordered_map<std::string, std::uint64_t> ids;
+    std::vector<std::uint64_t> trace;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!line.empty())
+        {
+            trace.push_back(ids.emplace(line, ids.size()).first->second);
+        }
+    }
+    return trace;
+}
+
+// Without a trace file: a skewed daytime workload, with a long scan of one-off keys
+// every `period` requests, like a nightly batch job.
+std::vector<std::uint64_t> synthetic_trace(const std::size_t n, const std::uint64_t key_space, const std::size_t period)
+{
+    std::mt19937_64 rng(22);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<std::uint64_t> trace;
+    trace.reserve(n);
+    std::uint64_t scan_key = key_space;
+    while (trace.size() < n)
+    {
+        for (std::size_t i = 0; i < period && trace.size() < n; ++i)
+        {
+            trace.push_back(static_cast<std::uint64_t>(std::pow(static_cast<double>(key_space), u(rng))) - 1);
+        }
+        for (std::size_t i = 0; i < period / 2 && trace.size() < n; ++i)
+        {
+            trace.push_back(scan_key++);
+        }
+    }
+    return trace;
+}
+
+// Read-through replay: every miss is followed by a put.
+template<typename Policy>
+void replay(const char* name, const std::vector<std::uint64_t>& trace, const std::size_t capacity)
+{
+    lru_cache<std::uint64_t, std::uint64_t, Policy> cache(capacity);
+    std::size_t hits = 0;
+    const double ms = mib_bench::time_ms([&]
+    {
+        for (const std::uint64_t k : trace)
+        {
+            if (cache.get(k))
+            {
+                ++hits;
+            }
+            else
+            {
+                cache.put(k, k);
+            }
+        }
+    });
+    mib_bench::report(name, trace.size(), ms);
+    std::printf("%-32s hit rate %.2f%%, %.2f Mops/s\n", "", 100.0 * static_cast<double>(hits) / static_cast<double>(trace.size()),
+                static_cast<double>(trace.size()) / ms / 1e3);
+}
+}
+
+// bench_cache_policies [capacity] [trace file]
+int main(const int argc, char** argv)
+{
+    const std::size_t capacity = mib_bench::arg_or(argc, argv, 1, 10000);
+    const std::vector<std::uint64_t> trace = argc > 2 ? read_trace(argv[2]) : synthetic_trace(10000000, 1000000, 200000);
+
+    replay<mib::lru_policy>("lru", trace, capacity);
+    replay<mib::slru_policy>("slru", trace, capacity);
+    replay<mib::clock_policy>("clock", trace, capacity);
+    replay<mib::w_tinylfu_policy>("w-tinylfu", trace, capacity);
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "bench_common.h"
+#include "lru_cache.h"
+
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <unordered_map>
+
+namespace
+{
+using clock_type = std::chrono::steady_clock;
+
+// Simulated time, advanced by the replay so the runs do not depend on wall-clock speed.
+clock_type::time_point fake_now;
+
+clock_type::time_point read_fake_clock()
+{
+    return fake_now;
+}
+
+struct request
+{
+    std::uint64_t key;
+    std::uint32_t ttl_ms;
+    std::uint32_t bytes;
+};
+
+// Skewed keys, TTLs from 10 ms to 10 min, value sizes from 100 B to about 10 MB
+// (log-uniform, so most are small).
+std::vector<request> make_requests(const std::size_t n, const std::uint64_t key_space)
+{
+    std::mt19937_64 rng(23);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<request> out(n);
+    for (request& r : out)
+    {
+        r.key = static_cast<std::uint64_t>(std::pow(static_cast<double>(key_space), u(rng))) - 1;
+        r.ttl_ms = static_cast<std::uint32_t>(std::pow(60000.0, u(rng))) * 10;
+        r.bytes = static_cast<std::uint32_t>(100.0 * std::pow(100000.0, u(rng)));
+    }
+    return out;
+}
+
+// Each request advances time by 10 us and does a read-through get/put.
+template<typename Cache, typename Put>
+void replay(const char* name, Cache& cache, const std::vector<request>& requests, Put&& put)
+{
+    fake_now = clock_type::time_point(std::chrono::hours(1));
+    std::size_t hits = 0;
+    const double ms = mib_bench::time_ms([&]
+    {
+        for (const request& r : requests)
+        {
+            fake_now += std::chrono::microseconds(10);
+            if (cache.get(r.key))
+            {
+                ++hits;
+            }
+            else
+            {
+                put(r);
+            }
+        }
+    });
+    mib_bench::report(name, requests.size(), ms);
+    std::printf("%-32s hit rate %.2f%%\n", "", 100.0 * static_cast<double>(hits) / static_cast<double>(requests.size()));
+}
+
+// Expiry by periodically scanning every entry, as the unbounded map-based caches do.
+class scanning_ttl_cache
+{
+public:
+    explicit scanning_ttl_cache(const std::size_t sweep_every): sweep_every_(sweep_every) {}
+
+    const std::uint64_t* get(const std::uint64_t k)
+    {
+        tick();
+        const auto it = map_.find(k);
+        if (it == map_.end() || it->second.deadline <= fake_now)
+        {
+            return nullptr;
+        }
+        return &it->second.value;
+    }
+
+    void put(const std::uint64_t k, const std::uint64_t v, const clock_type::duration ttl)
+    {
+        tick();
+        map_[k] = entry{v, fake_now + ttl};
+    }
+
+private:
+    struct entry
+    {
+        std::uint64_t value;
+        clock_type::time_point deadline;
+    };
+
+    void tick()
+    {
+        if (++ops_ % sweep_every_)
+        {
+            return;
+        }
+        for (auto it = map_.begin(); it != map_.end();)
+        {
+            it = it->second.deadline <= fake_now ? map_.erase(it) : std::next(it);
+        }
+    }
+
+    std::unordered_map<std::uint64_t, entry> map_;
+    std::size_t sweep_every_;
+    std::size_t ops_ = 0;
+};
+
+struct request_bytes
+{
+    std::size_t operator()(std::uint64_t, const std::uint32_t bytes) const noexcept
+    {
+        return bytes;
+    }
+};
+}
+
+// bench_cache_ttl_weight [requests] [capacity in entries]
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 5000000);
+    const std::size_t capacity = mib_bench::arg_or(argc, argv, 2, 100000);
+    const std::vector<request> requests = make_requests(n, capacity * 10);
+
+    {
+        lru_cache<std::uint64_t, std::uint64_t> cache(capacity);
+        replay("lru, no ttl", cache, requests, [&](const request& r) { cache.put(r.key, r.key); });
+    }
+    {
+        lru_cache<std::uint64_t, std::uint64_t> cache(capacity);
+        cache.set_clock(&read_fake_clock);
+        replay("lru, ttl via timing wheel", cache, requests, [&](const request& r)
+        {
+            cache.put(r.key, r.key, std::chrono::milliseconds(r.ttl_ms));
+        });
+        const mib::cache_stats s = cache.stats();
+        std::printf("%-32s size %zu, evictions %zu, expirations %zu\n", "", s.size, s.evictions, s.expirations);
+    }
+    {
+        scanning_ttl_cache cache(capacity);
+        replay("map, ttl via periodic scan", cache, requests, [&](const request& r)
+        {
+            cache.put(r.key, r.key, std::chrono::milliseconds(r.ttl_ms));
+        });
+    }
+    {
+        // Same entry budget expressed in bytes, at the mean value size.
+        std::uint64_t total = 0;
+        for (const request& r : requests)
+        {
+            total += r.bytes;
+        }
+        const std::size_t budget = capacity * static_cast<std::size_t>(total / n);
+        lru_cache<std::uint64_t, std::uint32_t, mib::w_tinylfu_policy, request_bytes> cache(budget);
+        cache.set_clock(&read_fake_clock);
+        replay("w-tinylfu, byte capacity + ttl", cache, requests, [&](const request& r)
+        {
+            cache.put(r.key, r.bytes, std::chrono::milliseconds(r.ttl_ms));
+        });
+        const mib::cache_stats s = cache.stats();
+        std::printf("%-32s %zu entries, %zu of %zu bytes, evictions %zu, expirations %zu\n", "", s.size, s.weight,
+                    budget, s.evictions, s.expirations);
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "bench_common.h"
+#include "disjoint_set.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <utility>
+
+namespace
+{
+// The previous implementation: recursive path compression and a separate rank array.
+class legacy_disjoint_set
+{
+public:
+    explicit legacy_disjoint_set(const std::size_t n): parent_(n), rank_(n, 0)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            parent_[i] = i;
+        }
+    }
+
+    std::size_t find(const std::size_t x)
+    {
+        if (parent_[x] != x)
+        {
+            parent_[x] = find(parent_[x]);
+        }
+        return parent_[x];
+    }
+
+    bool unite(std::size_t a, std::size_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a == b)
+        {
+            return false;
+        }
+        if (rank_[a] < rank_[b])
+        {
+            std::swap(a, b);
+        }
+        parent_[b] = a;
+        if (rank_[a] == rank_[b])
+        {
+            ++rank_[a];
+        }
+        return true;
+    }
+
+private:
+    std::vector<std::size_t> parent_;
+    std::vector<int> rank_;
+};
+
+using edge = std::pair<std::uint32_t, std::uint32_t>;
+
+template<typename Set>
+void sequential(const char* name, const std::size_t n, const std::vector<edge>& edges)
+{
+    std::size_t merged = 0;
+    mib_bench::report(name, edges.size(), mib_bench::time_ms([&]
+    {
+        Set s(n);
+        for (const auto& [a, b] : edges)
+        {
+            merged += s.unite(a, b);
+        }
+    }));
+    mib_bench::do_not_optimize(merged);
+}
+
+void concurrent(const std::size_t threads, const std::size_t n, const std::vector<edge>& edges)
+{
+    const std::string name = "concurrent_disjoint_set x" + std::to_string(threads);
+    concurrent_disjoint_set<std::uint32_t> s(n);
+    std::vector<std::thread> pool;
+
+    mib_bench::report(name.c_str(), edges.size(), mib_bench::time_ms([&]
+    {
+        for (std::size_t t = 0; t < threads; ++t)
+        {
+            pool.emplace_back([&, t]
+            {
+                for (std::size_t i = t; i < edges.size(); i += threads)
+                {
+                    s.unite(edges[i].first, edges[i].second);
+                }
+            });
+        }
+        for (auto& th : pool)
+        {
+            th.join();
+        }
+    }));
+    mib_bench::do_not_optimize(s.count());
+}
+}
+
+// Random graph ingestion: n vertices, m uniformly random edges.
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 10000000);
+    const std::size_t m = mib_bench::arg_or(argc, argv, 2, 20000000);
+    const std::size_t max_threads = mib_bench::arg_or(argc, argv, 3, 8);
+
+    std::mt19937_64 rng(19);
+    std::vector<edge> edges(m);
+    for (auto& e : edges)
+    {
+        e = {static_cast<std::uint32_t>(rng() % n), static_cast<std::uint32_t>(rng() % n)};
+    }
+
+    sequential<legacy_disjoint_set>("legacy recursive + rank", n, edges);
+    sequential<disjoint_set>("disjoint_set", n, edges);
+    sequential<disjoint_set32>("disjoint_set32", n, edges);
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        concurrent(threads, n, edges);
+    }
+    return 0;
+}
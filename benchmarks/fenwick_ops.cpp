@@ -0,0 +1,132 @@
+#include "bench_common.h"
+#include "fenwick_tree.h"
+
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+// The baselines keep a plain prefix-sum array and recompute it after every update,
+// so they run far fewer ops.
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 1000000);
+    const std::size_t ops = mib_bench::arg_or(argc, argv, 2, 1000000);
+    const std::size_t recompute_ops = mib_bench::arg_or(argc, argv, 3, 200);
+    const std::size_t side = mib_bench::arg_or(argc, argv, 4, 2000);
+
+    std::mt19937_64 rng(18);
+    std::vector<std::int64_t> a(n);
+    for (auto& x : a)
+    {
+        x = static_cast<std::int64_t>(rng() % 100);
+    }
+    std::int64_t sink = 0;
+
+    mib_bench::report("build via n adds", n, mib_bench::time_ms([&]
+    {
+        fenwick_tree<std::int64_t> f(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            f.add(i, a[i]);
+        }
+        sink += f.sum(n - 1);
+    }));
+
+    fenwick_tree<std::int64_t> f(std::vector<std::int64_t>{});
+    mib_bench::report("build O(n)", n, mib_bench::time_ms([&]
+    {
+        f = fenwick_tree<std::int64_t>(a);
+    }));
+
+    mib_bench::report("fenwick add + range_sum", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < ops; ++i)
+        {
+            f.add(rng() % n, 1);
+            const std::size_t l = rng() % n;
+            sink += f.range_sum(l, l + rng() % (n - l));
+        }
+    }));
+
+    std::vector<std::int64_t> prefix(n);
+    mib_bench::report("recompute prefix + range_sum", recompute_ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < recompute_ops; ++i)
+        {
+            a[rng() % n] += 1;
+            std::partial_sum(a.begin(), a.end(), prefix.begin());
+            const std::size_t l = rng() % n;
+            const std::size_t r = l + rng() % (n - l);
+            sink += prefix[r] - (l ? prefix[l - 1] : 0);
+        }
+    }));
+
+    range_fenwick_tree<std::int64_t> rf(a);
+    mib_bench::report("range_fenwick add + range_sum", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < ops; ++i)
+        {
+            std::size_t l = rng() % n;
+            rf.add(l, l + rng() % (n - l), 1);
+            l = rng() % n;
+            sink += rf.range_sum(l, l + rng() % (n - l));
+        }
+    }));
+
+    const std::int64_t total = f.sum(n - 1);
+    mib_bench::report("fenwick add + lower_bound", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < ops; ++i)
+        {
+            f.add(rng() % n, 1);
+            sink += static_cast<std::int64_t>(f.lower_bound(static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(total))));
+        }
+    }));
+
+    mib_bench::report("recompute prefix + lower_bound", recompute_ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < recompute_ops; ++i)
+        {
+            a[rng() % n] += 1;
+            std::partial_sum(a.begin(), a.end(), prefix.begin());
+            const auto target = static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(total));
+            sink += std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin();
+        }
+    }));
+
+    std::vector<std::int64_t> grid(side * side, 1);
+    fenwick_tree_2d<std::int64_t> f2(grid, side, side);
+    mib_bench::report("fenwick_2d add + rect sum", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < ops; ++i)
+        {
+            f2.add(rng() % side, rng() % side, 1);
+            const std::size_t r = rng() % side;
+            const std::size_t c = rng() % side;
+            sink += f2.range_sum(r, c, r + rng() % (side - r), c + rng() % (side - c));
+        }
+    }));
+
+    std::vector<std::int64_t> table((side + 1) * (side + 1));
+    mib_bench::report("recompute 2D prefix + rect sum", recompute_ops / 10, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < recompute_ops / 10; ++i)
+        {
+            grid[(rng() % side) * side + rng() % side] += 1;
+            for (std::size_t r = 0; r < side; ++r)
+            {
+                for (std::size_t c = 0; c < side; ++c)
+                {
+                    table[(r + 1) * (side + 1) + c + 1] = grid[r * side + c] + table[r * (side + 1) + c + 1] +
+                        table[(r + 1) * (side + 1) + c] - table[r * (side + 1) + c];
+                }
+            }
+            sink += table[side * (side + 1) + side];
+        }
+    }));
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
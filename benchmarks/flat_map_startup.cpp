@@ -0,0 +1,90 @@
+#include "bench_common.h"
+#include "flat_map.h"
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 5000000);
+    const std::size_t single_n = mib_bench::arg_or(argc, argv, 2, 100000);
+
+    std::mt19937_64 rng(13);
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> input(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        input[i] = {rng(), i};
+    }
+
+    {
+        flat_map<std::uint64_t, std::uint64_t> m;
+        mib_bench::report("bulk insert (unsorted)", n, mib_bench::time_ms([&]
+        {
+            m.insert(input.begin(), input.end());
+        }));
+        mib_bench::do_not_optimize(m.size());
+    }
+
+    {
+        flat_map<std::uint64_t, std::uint64_t> m;
+        const std::size_t chunk = n / 10;
+        mib_bench::report("bulk insert (10 batches)", n, mib_bench::time_ms([&]
+        {
+            for (std::size_t i = 0; i < n; i += chunk)
+            {
+                const auto first = input.begin() + static_cast<std::ptrdiff_t>(i);
+                m.insert(first, first + static_cast<std::ptrdiff_t>(std::min(chunk, n - i)));
+            }
+        }));
+        mib_bench::do_not_optimize(m.size());
+    }
+
+    auto sorted = input;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), [](const auto& a, const auto& b)
+    {
+        return a.first == b.first;
+    }), sorted.end());
+
+    {
+        auto copy = sorted;
+        double ms = mib_bench::time_ms([&]
+        {
+            flat_map<std::uint64_t, std::uint64_t> m(mib::sorted_unique, std::move(copy));
+            mib_bench::do_not_optimize(m.size());
+        });
+        mib_bench::report("sorted_unique adopt", sorted.size(), ms);
+    }
+
+    {
+        flat_map<std::uint64_t, std::uint64_t> m;
+        mib_bench::report("single insert (lower_bound)", single_n, mib_bench::time_ms([&]
+        {
+            for (std::size_t i = 0; i < single_n; ++i)
+            {
+                m.insert(input[i].first, input[i].second);
+            }
+        }));
+        mib_bench::do_not_optimize(m.size());
+    }
+
+    {
+        const std::size_t resort_n = std::min<std::size_t>(single_n, 5000);
+        std::vector<std::pair<std::uint64_t, std::uint64_t>> v;
+        mib_bench::report("push_back + full sort (old)", resort_n, mib_bench::time_ms([&]
+        {
+            for (std::size_t i = 0; i < resort_n; ++i)
+            {
+                v.push_back(input[i]);
+                std::sort(v.begin(), v.end(), [](const auto& a, const auto& b)
+                {
+                    return a.first < b.first;
+                });
+            }
+        }));
+        mib_bench::do_not_optimize(v.size());
+    }
+    return 0;
+}
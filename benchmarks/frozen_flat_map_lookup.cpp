@@ -0,0 +1,59 @@
+#include "bench_common.h"
+#include "frozen_flat_map.h"
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+
+int main(const int argc, char** argv)
+{
+    const std::size_t max_n = mib_bench::arg_or(argc, argv, 1, 10000000);
+    const std::size_t lookups = mib_bench::arg_or(argc, argv, 2, 5000000);
+
+    std::mt19937_64 rng(17);
+    for (std::size_t n = 10000; n <= max_n; n *= 10)
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> sorted(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            sorted[i] = {static_cast<std::uint32_t>(2 * i), static_cast<std::uint32_t>(i)};
+        }
+
+        std::vector<std::uint32_t> probes(lookups);
+        for (auto& p : probes)
+        {
+            p = static_cast<std::uint32_t>(rng() % (2 * n));
+        }
+
+        const flat_map<std::uint32_t, std::uint32_t> sorted_map(mib::sorted_unique, std::move(sorted));
+        const frozen_flat_map<std::uint32_t, std::uint32_t> frozen(sorted_map);
+
+        std::uint64_t sink = 0;
+        const std::string suffix = " n=" + std::to_string(n);
+
+        mib_bench::report(("lower_bound" + suffix).c_str(), lookups, mib_bench::time_ms([&]
+        {
+            for (const std::uint32_t k : probes)
+            {
+                if (const auto* v = sorted_map.find(k))
+                {
+                    sink += *v;
+                }
+            }
+        }));
+
+        mib_bench::report(("eytzinger" + suffix).c_str(), lookups, mib_bench::time_ms([&]
+        {
+            for (const std::uint32_t k : probes)
+            {
+                if (const auto* v = frozen.find(k))
+                {
+                    sink += *v;
+                }
+            }
+        }));
+        mib_bench::do_not_optimize(sink);
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "bench_common.h"
+#include "unordered_set.h"
+#include "unordered_map.h"
+
+#include <random>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <unordered_set>
+
+namespace
+{
+void print_stats(const char* name, const mib::flat_hash_stats& st)
+{
+    std::printf("%-24s size=%-10zu cap=%-10zu load=%.3f bytes/elem=%6.2f tombstones=%zu probes:",
+        name, st.size, st.capacity, st.load_factor, st.bytes_per_element, st.tombstones);
+    for (const std::size_t count : st.probe_histogram)
+    {
+        std::printf(" %zu", count);
+    }
+    std::printf("\n");
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 2000000);
+
+    std::mt19937_64 rng(5);
+    std::vector<std::uint64_t> keys(n);
+    for (auto& k : keys)
+    {
+        k = rng();
+    }
+
+    unordered_set<std::uint64_t> set;
+    mib_bench::report("unordered_set insert", n, mib_bench::time_ms([&]
+    {
+        for (const std::uint64_t k : keys)
+        {
+            set.insert(k);
+        }
+    }));
+
+    std::unordered_set<std::uint64_t> std_set;
+    mib_bench::report("std::unordered_set insert", n, mib_bench::time_ms([&]
+    {
+        for (const std::uint64_t k : keys)
+        {
+            std_set.insert(k);
+        }
+    }));
+
+    print_stats("unordered_set<u64>", set.memory_stats());
+
+    for (std::size_t i = 0; i < n / 2; ++i)
+    {
+        set.erase(keys[i]);
+    }
+    print_stats("  after erasing half", set.memory_stats());
+
+    unordered_map<std::uint64_t, std::uint64_t> map;
+    map.reserve(n);
+    for (const std::uint64_t k : keys)
+    {
+        map.insert(k, k);
+    }
+    print_stats("unordered_map<u64,u64>", map.memory_stats());
+
+    // Each value is copied from another entry of the same table, so the inserts that
+    // grow it must read their argument before the old slots are freed.
+    unordered_map<std::uint64_t, std::string> chain;
+    chain.try_emplace(keys[0], std::string(40, 'x'));
+    mib_bench::report("try_emplace from own entry", n, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            chain.try_emplace(keys[i], chain.at(keys[i - 1]));
+        }
+    }));
+    if (chain.at(keys[n - 1]) != std::string(40, 'x'))
+    {
+        std::fprintf(stderr, "try_emplace from own entry: value corrupted\n");
+        return 1;
+    }
+
+    const std::size_t std_bucket_bytes = std_set.bucket_count() * sizeof(void*);
+    const std::size_t std_node_bytes = std_set.size() * (sizeof(void*) + sizeof(std::uint64_t));
+    std::printf("%-24s bytes/elem=%6.2f (estimated, excluding malloc headers)\n", "std::unordered_set<u64>",
+        static_cast<double>(std_bucket_bytes + std_node_bytes) / static_cast<double>(std_set.size()));
+    return 0;
+}
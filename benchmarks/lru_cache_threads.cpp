@@ -0,0 +1,185 @@
+#include "bench_common.h"
+#include "lru_cache.h"
+#include "concurrent_lru_cache.h"
+
+#include <list>
+#include <mutex>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+namespace
+{
+// The previous implementation: a std::list of entries plus an unordered_map of iterators.
+template<typename K, typename V>
+class legacy_lru_cache
+{
+public:
+    explicit legacy_lru_cache(const std::size_t capacity): capacity_(capacity) {}
+
+    void put(const K& k, const V& v)
+    {
+        auto it = map_.find(k);
+        if (it != map_.end())
+        {
+            it->second->second = v;
+            items_.splice(items_.begin(), items_, it->second);
+            return;
+        }
+        items_.emplace_front(k, v);
+        map_[k] = items_.begin();
+        if (map_.size() > capacity_)
+        {
+            map_.erase(items_.back().first);
+            items_.pop_back();
+        }
+    }
+
+    bool get(const K& k, V& out)
+    {
+        auto it = map_.find(k);
+        if (it == map_.end())
+        {
+            return false;
+        }
+        out = it->second->second;
+        items_.splice(items_.begin(), items_, it->second);
+        return true;
+    }
+
+private:
+    std::size_t capacity_;
+    std::list<std::pair<K, V>> items_;
+    std::unordered_map<K, typename std::list<std::pair<K, V>>::iterator> map_;
+};
+
+// Cached responses are a few cache lines, so copying one out is not free.
+struct response
+{
+    std::uint64_t words[16];
+};
+
+// Roughly Zipfian keys: a few hot keys, a long tail.
+std::vector<std::uint64_t> make_keys(const std::size_t n, const std::uint64_t key_space)
+{
+    std::mt19937_64 rng(21);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<std::uint64_t> keys(n);
+    for (auto& k : keys)
+    {
+        k = static_cast<std::uint64_t>(std::pow(static_cast<double>(key_space), u(rng))) - 1;
+    }
+    return keys;
+}
+
+template<typename Body>
+double run_threads(const unsigned threads, Body body)
+{
+    return mib_bench::time_ms([&]
+    {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            pool.emplace_back(body, t);
+        }
+        for (auto& th : pool)
+        {
+            th.join();
+        }
+    });
+}
+}
+
+// 90% get, 10% put; a miss is followed by a put, as a read-through cache would do.
+int main(const int argc, char** argv)
+{
+    const auto max_threads = static_cast<unsigned>(mib_bench::arg_or(argc, argv, 1, 64));
+    const std::size_t ops_per_thread = mib_bench::arg_or(argc, argv, 2, 200000);
+    const std::uint64_t key_space = mib_bench::arg_or(argc, argv, 3, 1 << 20);
+    const std::size_t capacity = mib_bench::arg_or(argc, argv, 4, 1 << 16);
+
+    const std::vector<std::uint64_t> keys = make_keys(1 << 22, key_space);
+    const response filler{};
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const std::size_t total = ops_per_thread * threads;
+
+        legacy_lru_cache<std::uint64_t, response> legacy(capacity);
+        std::mutex mutex;
+        const double legacy_ms = run_threads(threads, [&](const unsigned t)
+        {
+            std::uint64_t sink = 0;
+            response out;
+            for (std::size_t i = 0, j = t * 7919; i < ops_per_thread; ++i, ++j)
+            {
+                const std::uint64_t k = keys[j & (keys.size() - 1)];
+                std::lock_guard<std::mutex> lock(mutex);
+                if (i % 10 == 0 || !legacy.get(k, out))
+                {
+                    legacy.put(k, filler);
+                }
+                else
+                {
+                    sink += out.words[0];
+                }
+            }
+            mib_bench::do_not_optimize(sink);
+        });
+
+        lru_cache<std::uint64_t, response> single(capacity);
+        const double single_ms = run_threads(threads, [&](const unsigned t)
+        {
+            std::uint64_t sink = 0;
+            for (std::size_t i = 0, j = t * 7919; i < ops_per_thread; ++i, ++j)
+            {
+                const std::uint64_t k = keys[j & (keys.size() - 1)];
+                std::lock_guard<std::mutex> lock(mutex);
+                const response* v = i % 10 ? single.get(k) : nullptr;
+                if (v)
+                {
+                    sink += v->words[0];
+                }
+                else
+                {
+                    single.put(k, filler);
+                }
+            }
+            mib_bench::do_not_optimize(sink);
+        });
+
+        concurrent_lru_cache<std::uint64_t, response> sharded(capacity);
+        const double sharded_ms = run_threads(threads, [&](const unsigned t)
+        {
+            std::uint64_t sink = 0;
+            for (std::size_t i = 0, j = t * 7919; i < ops_per_thread; ++i, ++j)
+            {
+                const std::uint64_t k = keys[j & (keys.size() - 1)];
+                auto h = i % 10 ? sharded.get(k) : concurrent_lru_cache<std::uint64_t, response>::handle();
+                if (h)
+                {
+                    sink += h->words[0];
+                }
+                else
+                {
+                    sharded.put(k, filler);
+                }
+            }
+            mib_bench::do_not_optimize(sink);
+        });
+
+        std::printf("threads=%-3u ", threads);
+        mib_bench::report("legacy lru_cache + mutex", total, legacy_ms);
+        std::printf("threads=%-3u ", threads);
+        mib_bench::report("lru_cache + mutex", total, single_ms);
+        std::printf("threads=%-3u ", threads);
+        mib_bench::report("concurrent_lru_cache", total, sharded_ms);
+    }
+
+    const concurrent_lru_cache<std::uint64_t, response> probe(capacity);
+    std::printf("concurrent_lru_cache shards: %zu\n", probe.shard_count());
+    return 0;
+}
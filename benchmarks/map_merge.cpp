@@ -0,0 +1,86 @@
+#include "bench_common.h"
+#include "map.h"
+
+#include <map>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+using key_map = map<std::uint64_t, std::uint64_t>;
+
+// Random keys with about 10% of small's keys also present in large.
+std::vector<std::uint64_t> random_keys(const std::size_t n, std::mt19937_64& rng)
+{
+    std::vector<std::uint64_t> keys(n);
+    for (auto& k : keys)
+    {
+        k = rng() % (n * 10 + 1);
+    }
+    return keys;
+}
+
+template<typename M>
+M fill(const std::vector<std::uint64_t>& keys)
+{
+    M m;
+    for (const std::uint64_t k : keys)
+    {
+        m.insert({k, k});
+    }
+    return m;
+}
+
+// The previous merge: copy the smallest pair out, free its node, allocate a new one.
+void copying_merge(key_map& into, key_map& from)
+{
+    while (!from.empty())
+    {
+        const auto it = from.begin();
+        const std::pair<const std::uint64_t, std::uint64_t> kv = *it;
+        from.erase(it);
+        into.insert(kv);
+    }
+}
+
+template<typename M, typename Merge>
+void run(const char* name, const std::vector<std::uint64_t>& into_keys, const std::vector<std::uint64_t>& from_keys,
+         Merge&& merge)
+{
+    M into = fill<M>(into_keys);
+    M from = fill<M>(from_keys);
+    const std::size_t moved = from.size();
+    mib_bench::report(name, moved, mib_bench::time_ms([&]
+    {
+        merge(into, from);
+    }));
+    mib_bench::do_not_optimize(into.size());
+}
+
+void run_all(const std::vector<std::uint64_t>& into_keys, const std::vector<std::uint64_t>& from_keys)
+{
+    using std_map = std::map<std::uint64_t, std::uint64_t>;
+
+    std::printf("-- %zu keys into %zu\n", from_keys.size(), into_keys.size());
+    run<key_map>("copy, erase + insert", into_keys, from_keys, copying_merge);
+    run<key_map>("map::merge", into_keys, from_keys, [](key_map& a, key_map& b) { a.merge(b); });
+    run<std_map>("std::map::merge", into_keys, from_keys, [](std_map& a, std_map& b) { a.merge(b); });
+}
+}
+
+// bench_map_merge [large size]
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 1000000);
+    std::mt19937_64 rng(24);
+    const std::vector<std::uint64_t> large_keys = random_keys(n, rng);
+
+    for (const std::size_t ratio : {1, 2, 4, 16, 64, 256, 1024})
+    {
+        run_all(large_keys, random_keys(n / ratio, rng));
+    }
+    run_all(random_keys(n / 64, rng), large_keys);
+    return 0;
+}
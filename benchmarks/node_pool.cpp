@@ -0,0 +1,137 @@
+#include "bench_common.h"
+#include "map.h"
+#include "set.h"
+#include "list.h"
+#include "pool_allocator.h"
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+namespace
+{
+using key_t_ = std::uint64_t;
+
+std::vector<key_t_> make_keys(const std::size_t n)
+{
+    std::mt19937_64 rng(42);
+    std::vector<key_t_> keys(n);
+
+    for (auto& k : keys)
+    {
+        k = rng();
+    }
+    return keys;
+}
+
+template<typename Map>
+void map_round(Map& m, const std::vector<key_t_>& keys)
+{
+    for (const key_t_ k : keys)
+    {
+        m.insert({k, k});
+    }
+    for (const key_t_ k : keys)
+    {
+        m.erase(k);
+    }
+}
+
+template<typename Set>
+void set_round(Set& s, const std::vector<key_t_>& keys)
+{
+    for (const key_t_ k : keys)
+    {
+        s.insert(k);
+    }
+    for (const key_t_ k : keys)
+    {
+        s.erase(k);
+    }
+}
+
+template<typename List>
+void list_round(List& l, const std::vector<key_t_>& keys)
+{
+    for (const key_t_ k : keys)
+    {
+        l.push_back(k);
+    }
+    while (!l.empty())
+    {
+        l.pop_front();
+    }
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 10000);
+    const std::size_t rounds = mib_bench::arg_or(argc, argv, 2, 200);
+    const std::vector<key_t_> keys = make_keys(n);
+    const std::size_t ops = 2 * n * rounds;
+
+    using pair_t = std::pair<const key_t_, key_t_>;
+    using pool_map = map<key_t_, key_t_, std::less<key_t_>, mib::pool_allocator<pair_t>>;
+    using pool_set = set<key_t_, std::less<key_t_>, mib::pool_allocator<key_t_>>;
+    using pool_list = list<key_t_, mib::pool_allocator<key_t_>>;
+
+    mib_bench::report("map std::allocator", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            map<key_t_, key_t_> m;
+            map_round(m, keys);
+        }
+    }));
+
+    mib_bench::report("map pool_allocator", ops, mib_bench::time_ms([&]
+    {
+        mib::arena_resource arena;
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            pool_map m(std::less<key_t_>(), &arena);
+            map_round(m, keys);
+        }
+    }));
+
+    mib_bench::report("set std::allocator", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            set<key_t_> s;
+            set_round(s, keys);
+        }
+    }));
+
+    mib_bench::report("set pool_allocator", ops, mib_bench::time_ms([&]
+    {
+        mib::arena_resource arena;
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            pool_set s(std::less<key_t_>(), &arena);
+            set_round(s, keys);
+        }
+    }));
+
+    mib_bench::report("list std::allocator", ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            list<key_t_> l;
+            list_round(l, keys);
+        }
+    }));
+
+    mib_bench::report("list pool_allocator", ops, mib_bench::time_ms([&]
+    {
+        mib::arena_resource arena;
+        for (std::size_t r = 0; r < rounds; ++r)
+        {
+            pool_list l(&arena);
+            list_round(l, keys);
+        }
+    }));
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include "bench_common.h"
+#include "priority_queue.h"
+
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+// The previous implementation: a std::push_heap/pop_heap binary heap.
+template<typename T>
+class legacy_priority_queue
+{
+public:
+    void push(const T& v)
+    {
+        data_.push_back(v);
+        std::push_heap(data_.begin(), data_.end());
+    }
+
+    void pop()
+    {
+        std::pop_heap(data_.begin(), data_.end());
+        data_.pop_back();
+    }
+
+    const T& top() const
+    {
+        return data_.front();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return data_.empty();
+    }
+
+private:
+    std::vector<T> data_;
+};
+
+// Fills the queue to `live` elements, then alternates push and pop.
+template<typename Queue>
+void push_pop(const char* name, const std::vector<std::uint64_t>& keys, const std::size_t live)
+{
+    std::uint64_t sink = 0;
+    mib_bench::report(name, keys.size(), mib_bench::time_ms([&]
+    {
+        Queue q;
+        std::size_t i = 0;
+        for (; i < live; ++i)
+        {
+            q.push(keys[i]);
+        }
+        for (; i + 1 < keys.size(); i += 2)
+        {
+            q.push(keys[i]);
+            sink += q.top();
+            q.pop();
+        }
+        while (!q.empty())
+        {
+            sink += q.top();
+            q.pop();
+        }
+    }));
+    mib_bench::do_not_optimize(sink);
+}
+
+struct graph
+{
+    std::vector<std::size_t> offsets;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> arcs;
+};
+
+graph random_graph(const std::size_t vertices, const std::size_t degree, std::mt19937_64& rng)
+{
+    graph g;
+    g.offsets.resize(vertices + 1);
+    g.arcs.resize(vertices * degree);
+    for (std::size_t v = 0; v < vertices; ++v)
+    {
+        g.offsets[v + 1] = g.offsets[v] + degree;
+        for (std::size_t k = 0; k < degree; ++k)
+        {
+            g.arcs[v * degree + k] = {static_cast<std::uint32_t>(rng() % vertices), static_cast<std::uint32_t>(rng() % 1000 + 1)};
+        }
+    }
+    return g;
+}
+
+// Textbook lazy deletion: push a new entry on every relaxation, skip stale ones on pop.
+template<typename Queue>
+std::uint64_t dijkstra_lazy(const graph& g, Queue& q)
+{
+    const std::size_t n = g.offsets.size() - 1;
+    std::vector<std::uint64_t> dist(n, UINT64_MAX);
+    dist[0] = 0;
+    q.push({0, 0});
+    while (!q.empty())
+    {
+        const auto [d, v] = q.top();
+        q.pop();
+        if (d != dist[v])
+        {
+            continue;
+        }
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            const auto [to, w] = g.arcs[k];
+            if (d + w < dist[to])
+            {
+                dist[to] = d + w;
+                q.push({d + w, to});
+            }
+        }
+    }
+    return dist[n - 1];
+}
+
+std::uint64_t dijkstra_indexed(const graph& g)
+{
+    using item = std::pair<std::uint64_t, std::uint32_t>;
+    const std::size_t n = g.offsets.size() - 1;
+    std::vector<std::uint64_t> dist(n, UINT64_MAX);
+    std::vector<std::size_t> handle(n, SIZE_MAX);
+    indexed_priority_queue<item, std::greater<item>> q;
+    dist[0] = 0;
+    handle[0] = q.push({0, 0});
+    while (!q.empty())
+    {
+        const auto [d, v] = q.top();
+        q.pop();
+        handle[v] = SIZE_MAX;
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k)
+        {
+            const auto [to, w] = g.arcs[k];
+            if (d + w < dist[to])
+            {
+                const bool queued = handle[to] != SIZE_MAX;
+                dist[to] = d + w;
+                if (queued)
+                {
+                    q.promote(handle[to], {d + w, to});
+                }
+                else
+                {
+                    handle[to] = q.push({d + w, to});
+                }
+            }
+        }
+    }
+    return dist[n - 1];
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t ops = mib_bench::arg_or(argc, argv, 1, 10000000);
+    const std::size_t live = mib_bench::arg_or(argc, argv, 2, 1000000);
+    const std::size_t vertices = mib_bench::arg_or(argc, argv, 3, 1000000);
+    const std::size_t degree = mib_bench::arg_or(argc, argv, 4, 8);
+
+    std::mt19937_64 rng(20);
+    std::vector<std::uint64_t> keys(ops);
+    for (auto& k : keys)
+    {
+        k = rng();
+    }
+
+    push_pop<legacy_priority_queue<std::uint64_t>>("legacy binary heap push/pop", keys, live);
+    push_pop<priority_queue<std::uint64_t, std::less<std::uint64_t>, 2>>("2-ary push/pop", keys, live);
+    push_pop<priority_queue<std::uint64_t>>("4-ary push/pop", keys, live);
+    push_pop<priority_queue<std::uint64_t, std::less<std::uint64_t>, 8>>("8-ary push/pop", keys, live);
+
+    std::uint64_t sink = 0;
+    mib_bench::report("legacy build via pushes", ops, mib_bench::time_ms([&]
+    {
+        legacy_priority_queue<std::uint64_t> q;
+        for (const auto k : keys)
+        {
+            q.push(k);
+        }
+        sink += q.top();
+    }));
+    mib_bench::report("4-ary make_heap build", ops, mib_bench::time_ms([&]
+    {
+        priority_queue<std::uint64_t> q(keys);
+        sink += q.top();
+    }));
+
+    const graph g = random_graph(vertices, degree, rng);
+    using item = std::pair<std::uint64_t, std::uint32_t>;
+    mib_bench::report("dijkstra legacy lazy", g.arcs.size(), mib_bench::time_ms([&]
+    {
+        legacy_priority_queue<std::pair<std::uint64_t, std::uint32_t>> q;
+        // The legacy queue is a max-heap with no comparator, so negate the distance.
+        struct negated
+        {
+            void push(const item& x) { q.push({UINT64_MAX - x.first, x.second}); }
+            void pop() { q.pop(); }
+            item top() const { return {UINT64_MAX - q.top().first, q.top().second}; }
+            bool empty() const { return q.empty(); }
+            legacy_priority_queue<item>& q;
+        } wrapped{q};
+        sink += dijkstra_lazy(g, wrapped);
+    }));
+    mib_bench::report("dijkstra 4-ary lazy", g.arcs.size(), mib_bench::time_ms([&]
+    {
+        priority_queue<item, std::greater<item>> q;
+        sink += dijkstra_lazy(g, q);
+    }));
+    mib_bench::report("dijkstra 4-ary decrease-key", g.arcs.size(), mib_bench::time_ms([&]
+    {
+        sink += dijkstra_indexed(g);
+    }));
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
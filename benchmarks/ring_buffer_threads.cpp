@@ -0,0 +1,215 @@
+#include "bench_common.h"
+#include "ring_buffer.h"
+#include "spsc_ring_buffer.h"
+#include "mpmc_ring_buffer.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace
+{
+constexpr std::size_t queue_capacity = 4096;
+constexpr std::size_t batch = 32;
+
+struct locked_ring_buffer
+{
+    bool try_push(const std::uint64_t v)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (buf.full())
+        {
+            return false;
+        }
+        buf.push(v);
+        return true;
+    }
+
+    bool try_pop(std::uint64_t& out)
+    {
+        std::lock_guard<std::mutex> lock(m);
+        if (buf.empty())
+        {
+            return false;
+        }
+        out = buf.pop();
+        return true;
+    }
+
+    std::mutex m;
+    ring_buffer<std::uint64_t> buf{queue_capacity};
+};
+
+template<typename Queue>
+void single_items(const char* name, Queue& q, const std::size_t producers, const std::size_t consumers, const std::size_t n)
+{
+    const std::size_t per_producer = n / producers;
+    const std::size_t per_consumer = per_producer * producers / consumers;
+    std::vector<std::thread> threads;
+    std::uint64_t sinks[64] = {};
+
+    mib_bench::report(name, per_producer * producers, mib_bench::time_ms([&]
+    {
+        for (std::size_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([&]
+            {
+                for (std::uint64_t i = 0; i < per_producer;)
+                {
+                    if (q.try_push(i))
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (std::size_t c = 0; c < consumers; ++c)
+        {
+            threads.emplace_back([&, c]
+            {
+                std::uint64_t v;
+                for (std::size_t got = 0; got < per_consumer;)
+                {
+                    if (q.try_pop(v))
+                    {
+                        sinks[c] += v;
+                        ++got;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+    }));
+    mib_bench::do_not_optimize(sinks);
+}
+
+template<typename Queue>
+void batched(const char* name, Queue& q, const std::size_t n)
+{
+    std::uint64_t sink = 0;
+    mib_bench::report(name, n, mib_bench::time_ms([&]
+    {
+        std::thread producer([&]
+        {
+            std::uint64_t items[batch];
+            for (std::size_t i = 0; i < n;)
+            {
+                const std::size_t want = std::min(batch, n - i);
+                for (std::size_t j = 0; j < want; ++j)
+                {
+                    items[j] = i + j;
+                }
+
+                const std::size_t pushed = q.push_n(items, want);
+                i += pushed;
+                if (pushed < want)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        std::uint64_t items[batch];
+        for (std::size_t got = 0; got < n;)
+        {
+            const std::size_t popped = q.pop_n(items, batch);
+            for (std::size_t j = 0; j < popped; ++j)
+            {
+                sink += items[j];
+            }
+            got += popped;
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+    }));
+    mib_bench::do_not_optimize(sink);
+}
+
+// Round trip: ping over one queue, echo back over another.
+void ping_pong(const std::size_t rounds)
+{
+    spsc_ring_buffer<std::uint64_t> ping(64);
+    spsc_ring_buffer<std::uint64_t> pong(64);
+
+    const double ms = mib_bench::time_ms([&]
+    {
+        std::thread echo([&]
+        {
+            std::uint64_t v;
+            for (std::size_t i = 0; i < rounds; ++i)
+            {
+                while (!ping.try_pop(v))
+                {
+                    std::this_thread::yield();
+                }
+                while (!pong.try_push(v))
+                {
+                }
+            }
+        });
+
+        std::uint64_t v;
+        for (std::uint64_t i = 0; i < rounds; ++i)
+        {
+            while (!ping.try_push(i))
+            {
+            }
+            while (!pong.try_pop(v))
+            {
+                std::this_thread::yield();
+            }
+        }
+        echo.join();
+    });
+    mib_bench::report("spsc round-trip latency", rounds, ms);
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 10000000);
+    const std::size_t rounds = mib_bench::arg_or(argc, argv, 2, 200000);
+
+    {
+        locked_ring_buffer q;
+        single_items("mutex + ring_buffer 1p/1c", q, 1, 1, n);
+    }
+    {
+        spsc_ring_buffer<std::uint64_t> q(queue_capacity);
+        single_items("spsc try_push/try_pop", q, 1, 1, n);
+    }
+    {
+        spsc_ring_buffer<std::uint64_t> q(queue_capacity);
+        batched("spsc push_n/pop_n x32", q, n);
+    }
+    {
+        mpmc_ring_buffer<std::uint64_t> q(queue_capacity);
+        single_items("mpmc 1p/1c", q, 1, 1, n);
+    }
+    {
+        mpmc_ring_buffer<std::uint64_t> q(queue_capacity);
+        single_items("mpmc 4p/4c", q, 4, 4, n);
+    }
+    {
+        mpmc_ring_buffer<std::uint64_t> q(queue_capacity);
+        batched("mpmc push_n/pop_n x32", q, n);
+    }
+    ping_pong(rounds);
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include "bench_common.h"
+#include "roaring_bitmap.h"
+
+#include <random>
+#include <cstdint>
+
+namespace
+{
+dynamic_bitset random_bits(std::mt19937_64& rng, const std::size_t n, const double density)
+{
+    dynamic_bitset bits(n);
+    if (density >= 0.5)
+    {
+        for (std::size_t i = 0; i < n; i += 64)
+        {
+            const std::uint64_t w = rng();
+            for (std::size_t b = 0; b < 64 && i + b < n; ++b)
+            {
+                if (w >> b & 1)
+                {
+                    bits.set(i + b);
+                }
+            }
+        }
+        return bits;
+    }
+
+    const auto count = static_cast<std::size_t>(static_cast<double>(n) * density);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        bits.set(rng() % n);
+    }
+    return bits;
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, std::size_t{1} << 30);
+    const double densities[] = {0.00001, 0.0001, 0.001, 0.01, 0.1, 0.5};
+
+    std::mt19937_64 rng(15);
+    std::uint64_t sink = 0;
+
+    for (const double density : densities)
+    {
+        const dynamic_bitset da = random_bits(rng, n, density);
+        const dynamic_bitset db = random_bits(rng, n, density);
+        const roaring_bitmap ra(da);
+        const roaring_bitmap rb(db);
+
+        const auto counts = ra.container_counts();
+        std::printf("density %.3f%%: dynamic_bitset %.1f MiB, roaring_bitmap %.3f MiB (%zu array, %zu bitmap, %zu run)\n",
+                    density * 100, static_cast<double>(n / 8) / (1 << 20),
+                    static_cast<double>(ra.memory_bytes()) / (1 << 20), counts[0], counts[1], counts[2]);
+
+        std::size_t dense = 0;
+        std::size_t compressed = 0;
+        mib_bench::report("  dynamic_bitset a & b", n, mib_bench::time_ms([&]
+        {
+            dense = (da & db).count();
+        }));
+        mib_bench::report("  roaring_bitmap a & b", n, mib_bench::time_ms([&]
+        {
+            compressed = (ra & rb).cardinality();
+        }));
+        mib_bench::report("  roaring_bitmap a | b", n, mib_bench::time_ms([&]
+        {
+            sink += (ra | rb).cardinality();
+        }));
+        mib_bench::report("  roaring_bitmap a - b", n, mib_bench::time_ms([&]
+        {
+            sink += (ra - rb).cardinality();
+        }));
+
+        if (dense != compressed)
+        {
+            std::printf("  mismatch: %zu vs %zu\n", dense, compressed);
+            return 1;
+        }
+        sink += dense;
+    }
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include "bench_common.h"
+#include "rope.h"
+
+#include <string>
+#include <random>
+#include <cstdint>
+
+int main(const int argc, char** argv)
+{
+    const std::size_t doc_bytes = mib_bench::arg_or(argc, argv, 1, 100u << 20);
+    const std::size_t edits = mib_bench::arg_or(argc, argv, 2, 200000);
+    const std::size_t string_edits = mib_bench::arg_or(argc, argv, 3, 200);
+
+    std::mt19937_64 rng(21);
+    std::string doc(doc_bytes, ' ');
+    for (auto& c : doc)
+    {
+        c = static_cast<char>('a' + rng() % 26);
+    }
+    const std::string snippet = "inserted text 16";
+
+    rope r;
+    mib_bench::report("rope build", doc_bytes, mib_bench::time_ms([&]
+    {
+        r = rope(doc);
+    }));
+
+    mib_bench::report("rope random insert+erase", edits, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < edits; ++i)
+        {
+            r.insert(rng() % r.size(), snippet);
+            r.erase(rng() % (r.size() - snippet.size()), snippet.size());
+        }
+    }));
+    std::printf("    depth after edits: %d\n", r.depth());
+
+    std::uint64_t sink = 0;
+    mib_bench::report("rope char_at", edits, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < edits; ++i)
+        {
+            sink += static_cast<unsigned char>(r.char_at(rng() % r.size()));
+        }
+    }));
+
+    mib_bench::report("rope substr(64KiB)", edits, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < edits; ++i)
+        {
+            sink += r.substr(rng() % (r.size() - 65536), 65536).size();
+        }
+    }));
+
+    mib_bench::report("rope iterate", r.size(), mib_bench::time_ms([&]
+    {
+        for (const char c : r)
+        {
+            sink += static_cast<unsigned char>(c);
+        }
+    }));
+
+    mib_bench::report("std::string random insert+erase", string_edits, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < string_edits; ++i)
+        {
+            doc.insert(rng() % doc.size(), snippet);
+            doc.erase(rng() % (doc.size() - snippet.size()), snippet.size());
+        }
+    }));
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "bench_common.h"
+#include "rope.h"
+
+#include <string>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+// Editor-style workload: every edit keeps an undo snapshot, the last `history` of which stay alive.
+template<typename Rope>
+void run(const char* name, const std::string& doc, const std::size_t edits, const std::size_t history)
+{
+    std::mt19937_64 rng(34);
+    const std::string snippet = "inserted text 16";
+
+    Rope r(doc);
+    std::vector<Rope> undo(history);
+    std::uint64_t sink = 0;
+
+    std::printf("%s\n", name);
+    mib_bench::report("  snapshot+insert+erase", edits, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < edits; ++i)
+        {
+            undo[i % history] = r;
+            r.insert(rng() % r.size(), snippet);
+            r.erase(rng() % (r.size() - snippet.size()), snippet.size());
+        }
+    }));
+
+    mib_bench::report("  snapshot char_at", edits, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < edits; ++i)
+        {
+            const Rope& s = undo[i % history];
+            sink += static_cast<unsigned char>(s.char_at(rng() % s.size()));
+        }
+    }));
+
+    const mib::rope_memory_stats st = r.memory_stats();
+    const auto arena = Rope::arena_stats();
+    std::printf("    live rope: %zu leaves, %zu internal, %.1f bytes/node, %.4f overhead/text byte\n",
+                st.leaves, st.internal_nodes, st.bytes_per_node, st.overhead_per_text_byte);
+    std::printf("    arena with %zu snapshots: %zu nodes, %.1f MiB in use, %.1f MiB reserved\n",
+                history, arena.blocks_in_use,
+                static_cast<double>(arena.bytes_in_use) / (1 << 20),
+                static_cast<double>(arena.bytes_reserved) / (1 << 20));
+
+    mib_bench::do_not_optimize(sink);
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t doc_bytes = mib_bench::arg_or(argc, argv, 1, 100u << 20);
+    const std::size_t edits = mib_bench::arg_or(argc, argv, 2, 200000);
+    const std::size_t history = mib_bench::arg_or(argc, argv, 3, 1000);
+
+    std::mt19937_64 rng(21);
+    std::string doc(doc_bytes, ' ');
+    for (auto& c : doc)
+    {
+        c = static_cast<char>('a' + rng() % 26);
+    }
+
+    run<rope>("rope (atomic refcounts)", doc, edits, history);
+    run<local_rope>("local_rope (plain refcounts)", doc, edits, history);
+    return 0;
+}
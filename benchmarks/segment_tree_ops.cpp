@@ -0,0 +1,136 @@
+#include "bench_common.h"
+#include "segment_tree.h"
+#include "fenwick_tree.h"
+
+#include <random>
+#include <vector>
+#include <cstdint>
+
+// Half point updates, half range sums; the naive loop runs far fewer ops since each
+// query is O(n).
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 1000000);
+    const std::size_t ops = mib_bench::arg_or(argc, argv, 2, 10000000);
+    const std::size_t naive_ops = mib_bench::arg_or(argc, argv, 3, 2000);
+
+    std::mt19937_64 rng(17);
+    std::vector<std::int64_t> base(n);
+    for (auto& x : base)
+    {
+        x = static_cast<std::int64_t>(rng() % 1000);
+    }
+
+    struct op
+    {
+        bool update;
+        std::size_t l;
+        std::size_t r;
+        std::int64_t v;
+    };
+    std::vector<op> trace(ops);
+    for (auto& o : trace)
+    {
+        o.update = rng() & 1;
+        o.l = rng() % n;
+        o.r = o.l + 1 + rng() % (n - o.l);
+        o.v = static_cast<std::int64_t>(rng() % 100);
+    }
+
+    std::int64_t sink = 0;
+
+    segment_tree<std::int64_t> seg(base);
+    mib_bench::report("segment_tree set/query", ops, mib_bench::time_ms([&]
+    {
+        for (const op& o : trace)
+        {
+            if (o.update)
+            {
+                seg.set(o.l, seg.get(o.l) + o.v);
+            }
+            else
+            {
+                sink += seg.query(o.l, o.r);
+            }
+        }
+    }));
+
+    fenwick_tree<std::int64_t> fen(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        fen.add(i, base[i]);
+    }
+    mib_bench::report("fenwick_tree add/sum", ops, mib_bench::time_ms([&]
+    {
+        for (const op& o : trace)
+        {
+            if (o.update)
+            {
+                fen.add(o.l, o.v);
+            }
+            else
+            {
+                sink += fen.sum(o.r - 1) - (o.l ? fen.sum(o.l - 1) : 0);
+            }
+        }
+    }));
+
+    std::vector<std::int64_t> naive = base;
+    mib_bench::report("naive point add/loop sum", naive_ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < naive_ops; ++i)
+        {
+            const op& o = trace[i];
+            if (o.update)
+            {
+                naive[o.l] += o.v;
+            }
+            else
+            {
+                for (std::size_t k = o.l; k < o.r; ++k)
+                {
+                    sink += naive[k];
+                }
+            }
+        }
+    }));
+
+    lazy_segment_tree<mib::sum_monoid<std::int64_t>, mib::range_add<mib::sum_monoid<std::int64_t>>> lazy(base);
+    mib_bench::report("lazy_segment_tree add/query", ops, mib_bench::time_ms([&]
+    {
+        for (const op& o : trace)
+        {
+            if (o.update)
+            {
+                lazy.apply(o.l, o.r, o.v);
+            }
+            else
+            {
+                sink += lazy.query(o.l, o.r);
+            }
+        }
+    }));
+
+    naive = base;
+    mib_bench::report("naive range add/loop sum", naive_ops, mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < naive_ops; ++i)
+        {
+            const op& o = trace[i];
+            for (std::size_t k = o.l; k < o.r; ++k)
+            {
+                if (o.update)
+                {
+                    naive[k] += o.v;
+                }
+                else
+                {
+                    sink += naive[k];
+                }
+            }
+        }
+    }));
+
+    mib_bench::do_not_optimize(sink);
+    return 0;
+}
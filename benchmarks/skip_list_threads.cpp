@@ -0,0 +1,90 @@
+#include "bench_common.h"
+#include "skip_list.h"
+#include "concurrent_skip_list.h"
+
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace
+{
+template<typename Body>
+double run_threads(const unsigned threads, Body body)
+{
+    return mib_bench::time_ms([&]
+    {
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            pool.emplace_back(body, t);
+        }
+        for (auto& th : pool)
+        {
+            th.join();
+        }
+    });
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const unsigned hw = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 4;
+    const auto max_threads = static_cast<unsigned>(mib_bench::arg_or(argc, argv, 1, hw));
+    const std::size_t ops_per_thread = mib_bench::arg_or(argc, argv, 2, 1000000);
+    const std::uint64_t key_space = mib_bench::arg_or(argc, argv, 3, 1 << 20);
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+    {
+        const std::size_t total = ops_per_thread * threads;
+
+        concurrent_skip_list<std::uint64_t, std::uint64_t> lock_free;
+        const double lf_ms = run_threads(threads, [&](const unsigned t)
+        {
+            std::mt19937_64 rng(t + 1);
+            std::uint64_t sink = 0;
+            for (std::size_t i = 0; i < ops_per_thread; ++i)
+            {
+                const std::uint64_t k = rng() % key_space;
+                if (i % 10 == 0)
+                {
+                    lock_free.insert(k, k);
+                }
+                else if (const auto* v = lock_free.find(k))
+                {
+                    sink += *v;
+                }
+            }
+            mib_bench::do_not_optimize(sink);
+        });
+
+        skip_list<std::uint64_t, std::uint64_t> locked;
+        std::mutex mutex;
+        const double mx_ms = run_threads(threads, [&](const unsigned t)
+        {
+            std::mt19937_64 rng(t + 1);
+            std::uint64_t sink = 0;
+            for (std::size_t i = 0; i < ops_per_thread; ++i)
+            {
+                const std::uint64_t k = rng() % key_space;
+                std::lock_guard<std::mutex> lock(mutex);
+                if (i % 10 == 0)
+                {
+                    locked.insert(k, k);
+                }
+                else if (const auto* v = locked.find(k))
+                {
+                    sink += *v;
+                }
+            }
+            mib_bench::do_not_optimize(sink);
+        });
+
+        std::printf("threads=%-3u ", threads);
+        mib_bench::report("concurrent_skip_list 90% find", total, lf_ms);
+        std::printf("threads=%-3u ", threads);
+        mib_bench::report("skip_list + mutex 90% find", total, mx_ms);
+    }
+    return 0;
+}
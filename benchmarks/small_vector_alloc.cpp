@@ -0,0 +1,97 @@
+#include "bench_common.h"
+#include "small_vector.h"
+
+#include <new>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+namespace
+{
+std::size_t allocations = 0;
+}
+
+void* operator new(const std::size_t n)
+{
+    ++allocations;
+    if (void* p = std::malloc(n ? n : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+template<typename Vec>
+void run(const char* name, const std::size_t n, const std::size_t elems)
+{
+    const std::size_t before = allocations;
+    std::uint64_t sink = 0;
+
+    const double ms = mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            Vec v;
+            for (std::size_t j = 0; j < elems; ++j)
+            {
+                v.push_back(static_cast<std::uint32_t>(i + j));
+            }
+            sink += v[elems / 2];
+        }
+    });
+
+    mib_bench::report(name, n, ms);
+    std::printf("    %zu elements: %.3f allocations per construct/destroy\n", elems,
+        static_cast<double>(allocations - before) / static_cast<double>(n));
+    mib_bench::do_not_optimize(sink);
+}
+
+template<typename Vec>
+void run_many(const char* name, const std::size_t count, const std::size_t elems)
+{
+    const std::size_t before = allocations;
+    std::vector<Vec> all(count);
+
+    const double ms = mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (std::size_t j = 0; j < elems; ++j)
+            {
+                all[i].push_back(static_cast<std::uint32_t>(j));
+            }
+        }
+    });
+
+    mib_bench::report(name, count, ms);
+    std::printf("    %zu live vectors: %zu allocations\n", count, allocations - before - 1);
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 10000000);
+    const std::size_t live = mib_bench::arg_or(argc, argv, 2, 1000000);
+
+    for (const std::size_t elems : {std::size_t(2), std::size_t(8), std::size_t(20)})
+    {
+        run<small_vector<std::uint32_t, 8>>("small_vector<u32,8>", n, elems);
+        run<std::vector<std::uint32_t>>("std::vector<u32>", n, elems);
+    }
+
+    run_many<small_vector<std::uint32_t, 8>>("small_vector<u32,8> x live", live, 4);
+    run_many<std::vector<std::uint32_t>>("std::vector<u32> x live", live, 4);
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "bench_common.h"
+#include "map.h"
+#include "set.h"
+
+#include <map>
+#include <set>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <algorithm>
+
+namespace
+{
+using entry = std::pair<std::uint64_t, std::uint64_t>;
+
+// Sorted keys with every 100th entry swapped with a random one up to 64 places ahead,
+// like a dump that was appended to out of order now and then.
+std::vector<entry> nearly_sorted(std::vector<entry> v, std::mt19937_64& rng)
+{
+    for (std::size_t i = 0; i + 64 < v.size(); i += 100)
+    {
+        std::swap(v[i], v[i + 1 + rng() % 64]);
+    }
+    return v;
+}
+
+template<typename Build>
+void run(const char* name, const std::size_t n, Build&& build)
+{
+    std::size_t size = 0;
+    mib_bench::report(name, n, mib_bench::time_ms([&]
+    {
+        size = build();
+    }));
+    mib_bench::do_not_optimize(size);
+}
+
+void run_input(const char* label, const std::vector<entry>& input)
+{
+    using key_map = map<std::uint64_t, std::uint64_t>;
+
+    std::vector<std::uint64_t> keys(input.size());
+    std::transform(input.begin(), input.end(), keys.begin(), [](const entry& e) { return e.first; });
+    const std::size_t n = input.size();
+
+    std::printf("-- %s\n", label);
+    run("map, insert one by one", n, [&]
+    {
+        key_map m;
+        for (const entry& e : input)
+        {
+            m.insert(e);
+        }
+        return m.size();
+    });
+    run("map, insert at end() hint", n, [&]
+    {
+        key_map m;
+        for (const entry& e : input)
+        {
+            m.insert(m.end(), e);
+        }
+        return m.size();
+    });
+    run("map, range constructor", n, [&]
+    {
+        key_map m(input.begin(), input.end());
+        return m.size();
+    });
+    run("std::map, range constructor", n, [&]
+    {
+        std::map<std::uint64_t, std::uint64_t> m(input.begin(), input.end());
+        return m.size();
+    });
+    run("set, insert one by one", n, [&]
+    {
+        set<std::uint64_t> s;
+        for (const std::uint64_t k : keys)
+        {
+            s.insert(k);
+        }
+        return s.size();
+    });
+    run("set, range constructor", n, [&]
+    {
+        set<std::uint64_t> s(keys.begin(), keys.end());
+        return s.size();
+    });
+    run("std::set, range constructor", n, [&]
+    {
+        std::set<std::uint64_t> s(keys.begin(), keys.end());
+        return s.size();
+    });
+}
+}
+
+// bench_tree_bulk_build [entries]
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 2000000);
+    std::mt19937_64 rng(25);
+
+    std::vector<entry> sorted(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        sorted[i] = {i * 3, i};
+    }
+    std::vector<entry> shuffled = sorted;
+    std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+    run_input("sorted", sorted);
+    run_input("nearly sorted (1% displaced)", nearly_sorted(sorted, rng));
+    run_input("random", shuffled);
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include "bench_common.h"
+#include "unordered_map.h"
+
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+namespace
+{
+// The bucket-of-vectors design unordered_map.h used before the flat table, kept for comparison.
+template<typename K, typename V, typename Hash = std::hash<K>>
+class chained_unordered_map
+{
+public:
+    std::optional<V> get(const K& key) const
+    {
+        if (buckets_.empty())
+        {
+            return {};
+        }
+        for (const auto& kv : buckets_[Hash{}(key) % buckets_.size()])
+        {
+            if (kv.first == key)
+            {
+                return kv.second;
+            }
+        }
+        return {};
+    }
+
+    void insert(const K& key, const V& val)
+    {
+        if (buckets_.empty())
+        {
+            buckets_.resize(16);
+        }
+
+        auto& bucket = buckets_[Hash{}(key) % buckets_.size()];
+        for (auto& kv : bucket)
+        {
+            if (kv.first == key)
+            {
+                kv.second = val;
+                return;
+            }
+        }
+
+        bucket.emplace_back(key, val);
+        if (++size_ > buckets_.size())
+        {
+            std::vector<std::vector<std::pair<K, V>>> next(buckets_.size() * 2);
+            for (const auto& b : buckets_)
+            {
+                for (const auto& kv : b)
+                {
+                    next[Hash{}(kv.first) % next.size()].push_back(kv);
+                }
+            }
+            buckets_.swap(next);
+        }
+    }
+
+private:
+    std::vector<std::vector<std::pair<K, V>>> buckets_;
+    std::size_t size_ = 0;
+};
+
+template<typename K, typename V>
+struct std_adapter
+{
+    std::optional<V> get(const K& key) const
+    {
+        const auto it = map.find(key);
+        if (it == map.end())
+        {
+            return {};
+        }
+        return it->second;
+    }
+
+    void insert(const K& key, const V& val)
+    {
+        map.insert_or_assign(key, val);
+    }
+
+    std::unordered_map<K, V> map;
+};
+
+template<typename Map, typename K>
+void run(const char* name, const std::vector<K>& keys, const std::vector<K>& hits, const std::vector<K>& misses)
+{
+    std::string label(name);
+    Map m;
+    mib_bench::report((label + " insert").c_str(), keys.size(), mib_bench::time_ms([&]
+    {
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            m.insert(keys[i], i);
+        }
+    }));
+
+    std::size_t sink = 0;
+    mib_bench::report((label + " lookup hit").c_str(), hits.size(), mib_bench::time_ms([&]
+    {
+        for (const auto& k : hits)
+        {
+            sink += *m.get(k);
+        }
+    }));
+
+    mib_bench::report((label + " lookup miss").c_str(), misses.size(), mib_bench::time_ms([&]
+    {
+        for (const auto& k : misses)
+        {
+            sink += m.get(k).has_value();
+        }
+    }));
+    mib_bench::do_not_optimize(sink);
+}
+
+template<typename K>
+void run_all(const std::vector<K>& keys, const std::vector<K>& hits, const std::vector<K>& misses)
+{
+    run<unordered_map<K, std::size_t>>("flat", keys, hits, misses);
+    run<chained_unordered_map<K, std::size_t>>("chained", keys, hits, misses);
+    run<std_adapter<K, std::size_t>>("std::unordered_map", keys, hits, misses);
+}
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t n = mib_bench::arg_or(argc, argv, 1, 1000000);
+    const std::size_t lookups = mib_bench::arg_or(argc, argv, 2, 5000000);
+
+    std::mt19937_64 rng(11);
+    std::vector<std::uint64_t> keys(n);
+    for (auto& k : keys)
+    {
+        k = rng() >> 1;
+    }
+
+    std::vector<std::uint64_t> hits(lookups);
+    std::vector<std::uint64_t> misses(lookups);
+    for (std::size_t i = 0; i < lookups; ++i)
+    {
+        hits[i] = keys[rng() % n];
+        misses[i] = (rng() >> 1) | (std::uint64_t(1) << 63);
+    }
+
+    std::printf("-- uint64_t keys\n");
+    run_all(keys, hits, misses);
+
+    std::vector<std::string> skeys(n);
+    std::vector<std::string> shits(lookups / 4);
+    std::vector<std::string> smisses(lookups / 4);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        skeys[i] = "key:" + std::to_string(keys[i]);
+    }
+    for (std::size_t i = 0; i < shits.size(); ++i)
+    {
+        shits[i] = skeys[rng() % n];
+        smisses[i] = "miss:" + std::to_string(rng());
+    }
+
+    std::printf("-- std::string keys\n");
+    run_all(skeys, shits, smisses);
+    return 0;
+}
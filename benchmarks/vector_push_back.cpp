@@ -0,0 +1,60 @@
+#include "bench_common.h"
+#include "vector.h"
+#include "malloc_allocator.h"
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+template<typename Vec>
+double bench_push_back(const std::size_t n)
+{
+    return mib_bench::time_ms([n]
+    {
+        Vec v;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            v.push_back(static_cast<typename Vec::value_type>(i));
+        }
+        mib_bench::do_not_optimize(v.data());
+    });
+}
+
+template<typename Vec>
+double bench_push_back_string(const std::size_t n)
+{
+    return mib_bench::time_ms([n]
+    {
+        Vec v;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            v.push_back(std::string(24, 'x'));
+        }
+        mib_bench::do_not_optimize(v.data());
+    });
+}
+
+int main(const int argc, char** argv)
+{
+    const std::size_t max_n = mib_bench::arg_or(argc, argv, 1, 100000000);
+
+    for (std::size_t n = 1000; n <= max_n; n *= 10)
+    {
+        mib_bench::report("std::vector<uint64_t>", n, bench_push_back<std::vector<std::uint64_t>>(n));
+        mib_bench::report("vector<uint64_t> x2", n, bench_push_back<vector<std::uint64_t>>(n));
+        mib_bench::report("vector<uint64_t> x1.5", n,
+            bench_push_back<vector<std::uint64_t, std::allocator<std::uint64_t>, mib::growth_factor_1_5>>(n));
+        mib_bench::report("vector<uint64_t> page", n,
+            bench_push_back<vector<std::uint64_t, std::allocator<std::uint64_t>, mib::page_rounded_growth<>>>(n));
+        mib_bench::report("vector<uint64_t> realloc", n,
+            bench_push_back<vector<std::uint64_t, mib::malloc_allocator<std::uint64_t>>>(n));
+
+        if (n <= 10000000)
+        {
+            mib_bench::report("std::vector<string>", n, bench_push_back_string<std::vector<std::string>>(n));
+            mib_bench::report("vector<string>", n, bench_push_back_string<vector<std::string>>(n));
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
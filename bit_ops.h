@@ -0,0 +1,403 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Word-level kernels shared by bitset and dynamic_bitset. Loops over whole words use
+// AVX2 when the target has it and plain 64-bit words otherwise.
+
+namespace mib
+{
+namespace detail
+{
+constexpr std::size_t bits_npos = static_cast<std::size_t>(-1);
+
+inline int countr_zero(const std::uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    for (std::uint64_t v = x; (v & 1) == 0; v >>= 1)
+    {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline int countl_zero(const std::uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for (std::uint64_t v = x; (v >> 63) == 0; v <<= 1)
+    {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline int popcount(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Position of the k-th (0-based) set bit of w; k must be below popcount(w).
+inline int select_in_word(std::uint64_t w, unsigned k) noexcept
+{
+#if defined(__BMI2__)
+    return countr_zero(_pdep_u64(std::uint64_t{1} << k, w));
+#else
+    int base = 0;
+    for (int c = popcount(w & 0xff); c <= static_cast<int>(k); c = popcount(w & 0xff))
+    {
+        k -= static_cast<unsigned>(c);
+        w >>= 8;
+        base += 8;
+    }
+    for (; k; --k)
+    {
+        w &= w - 1;
+    }
+    return base + countr_zero(w);
+#endif
+}
+
+inline std::uint64_t tail_mask(const std::size_t nbits) noexcept
+{
+    const std::size_t r = nbits % 64;
+    return r ? (std::uint64_t{1} << r) - 1 : ~std::uint64_t{0};
+}
+
+#if defined(__AVX2__)
+// Nibble lookup through vpshufb, summed per 64-bit lane with vpsadbw (Mula et al.).
+inline __m256i popcount_256(const __m256i v) noexcept
+{
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+    const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+    return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+#endif
+
+inline std::size_t popcount_words(const std::uint64_t* w, const std::size_t n) noexcept
+{
+    std::size_t i = 0;
+    std::size_t total = 0;
+
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    const std::size_t vec_end = n - n % 4;
+    for (; i < vec_end; i += 4)
+    {
+        acc = _mm256_add_epi64(acc, popcount_256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i))));
+    }
+    total = static_cast<std::size_t>(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+                                     _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+#endif
+
+    for (; i < n; ++i)
+    {
+        total += static_cast<std::size_t>(popcount(w[i]));
+    }
+    return total;
+}
+
+inline bool any_words(const std::uint64_t* w, const std::size_t n) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const std::size_t vec_end = n - n % 8;
+    for (; i < vec_end; i += 8)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i + 4));
+        const __m256i v = _mm256_or_si256(a, b);
+        if (!_mm256_testz_si256(v, v))
+        {
+            return true;
+        }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        if (w[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool all_words(const std::uint64_t* w, const std::size_t nbits) noexcept
+{
+    const std::size_t full = nbits / 64;
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const std::size_t vec_end = full - full % 4;
+    for (; i < vec_end; i += 4)
+    {
+        if (!_mm256_testc_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i)), ones))
+        {
+            return false;
+        }
+    }
+#endif
+
+    for (; i < full; ++i)
+    {
+        if (~w[i])
+        {
+            return false;
+        }
+    }
+    return nbits % 64 == 0 || w[full] == tail_mask(nbits);
+}
+
+struct bit_and
+{
+    static std::uint64_t apply(const std::uint64_t a, const std::uint64_t b) noexcept { return a & b; }
+#if defined(__AVX2__)
+    static __m256i apply(const __m256i a, const __m256i b) noexcept { return _mm256_and_si256(a, b); }
+#endif
+};
+
+struct bit_or
+{
+    static std::uint64_t apply(const std::uint64_t a, const std::uint64_t b) noexcept { return a | b; }
+#if defined(__AVX2__)
+    static __m256i apply(const __m256i a, const __m256i b) noexcept { return _mm256_or_si256(a, b); }
+#endif
+};
+
+struct bit_xor
+{
+    static std::uint64_t apply(const std::uint64_t a, const std::uint64_t b) noexcept { return a ^ b; }
+#if defined(__AVX2__)
+    static __m256i apply(const __m256i a, const __m256i b) noexcept { return _mm256_xor_si256(a, b); }
+#endif
+};
+
+struct bit_and_not
+{
+    static std::uint64_t apply(const std::uint64_t a, const std::uint64_t b) noexcept { return a & ~b; }
+#if defined(__AVX2__)
+    static __m256i apply(const __m256i a, const __m256i b) noexcept { return _mm256_andnot_si256(b, a); }
+#endif
+};
+
+template<typename Op>
+void apply_words(std::uint64_t* dst, const std::uint64_t* src, const std::size_t n) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const std::size_t vec_end = n - n % 4;
+    for (; i < vec_end; i += 4)
+    {
+        auto* d = reinterpret_cast<__m256i*>(dst + i);
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(d, Op::apply(_mm256_loadu_si256(d), s));
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        dst[i] = Op::apply(dst[i], src[i]);
+    }
+}
+
+inline void flip_words(std::uint64_t* w, const std::size_t n) noexcept
+{
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const std::size_t vec_end = n - n % 4;
+    for (; i < vec_end; i += 4)
+    {
+        auto* d = reinterpret_cast<__m256i*>(w + i);
+        _mm256_storeu_si256(d, _mm256_xor_si256(_mm256_loadu_si256(d), ones));
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        w[i] = ~w[i];
+    }
+}
+
+// First set bit at or after bit `from`, or bits_npos.
+inline std::size_t find_from(const std::uint64_t* w, const std::size_t nwords, const std::size_t from) noexcept
+{
+    std::size_t i = from / 64;
+    if (i >= nwords)
+    {
+        return bits_npos;
+    }
+
+    std::uint64_t word = w[i] & (~std::uint64_t{0} << (from % 64));
+    while (!word)
+    {
+        if (++i == nwords)
+        {
+            return bits_npos;
+        }
+        word = w[i];
+    }
+    return i * 64 + static_cast<std::size_t>(countr_zero(word));
+}
+
+// Two-level rank directory over 512-bit blocks: an absolute count per 2^32 bits and a
+// 32-bit relative count per block (about 6% of the bitmap), plus a sampled position
+// for every select_sample-th one so select only binary-searches a short block range.
+class rank_index
+{
+public:
+    static constexpr std::size_t block_words = 8;
+    static constexpr std::size_t block_bits = block_words * 64;
+    static constexpr std::size_t blocks_per_super = std::size_t{1} << 23;
+    static constexpr std::size_t select_sample = 4096;
+
+    void build(const std::uint64_t* w, const std::size_t nwords)
+    {
+        const std::size_t nblocks = (nwords + block_words - 1) / block_words;
+        blocks_.assign(nblocks + 1, 0);
+        super_.assign(nblocks / blocks_per_super + 1, 0);
+        samples_.clear();
+
+        std::size_t total = 0;
+        for (std::size_t b = 0; b <= nblocks; ++b)
+        {
+            if (b % blocks_per_super == 0)
+            {
+                super_[b / blocks_per_super] = total;
+            }
+            blocks_[b] = static_cast<std::uint32_t>(total - super_[b / blocks_per_super]);
+            if (b == nblocks)
+            {
+                break;
+            }
+
+            const std::size_t first = b * block_words;
+            const std::size_t count = std::min(block_words, nwords - first);
+            const std::size_t ones = popcount_words(w + first, count);
+            for (std::size_t next = (total + select_sample - 1) / select_sample * select_sample;
+                 next < total + ones; next += select_sample)
+            {
+                samples_.push_back(b);
+            }
+            total += ones;
+        }
+        ones_ = total;
+    }
+
+    // Called by every mutator of the owning bitset; a stale index must not be queried.
+    void invalidate() noexcept
+    {
+        blocks_.clear();
+    }
+
+    [[nodiscard]] bool built() const noexcept
+    {
+        return !blocks_.empty();
+    }
+
+    [[nodiscard]] std::size_t ones() const noexcept
+    {
+        return ones_;
+    }
+
+    // Number of set bits in [0, i).
+    [[nodiscard]] std::size_t rank(const std::uint64_t* w, const std::size_t i) const
+    {
+        const std::size_t b = i / block_bits;
+        std::size_t r = cumulative(b);
+        for (std::size_t k = b * block_words; k < i / 64; ++k)
+        {
+            r += static_cast<std::size_t>(popcount(w[k]));
+        }
+        if (i % 64)
+        {
+            r += static_cast<std::size_t>(popcount(w[i / 64] & tail_mask(i)));
+        }
+        return r;
+    }
+
+    // Position of the k-th (0-based) set bit, or bits_npos.
+    [[nodiscard]] std::size_t select(const std::uint64_t* w, const std::size_t nwords, std::size_t k) const
+    {
+        if (k >= ones_)
+        {
+            return bits_npos;
+        }
+
+        std::size_t lo = samples_[k / select_sample];
+        std::size_t hi = k / select_sample + 1 < samples_.size() ? samples_[k / select_sample + 1] + 1 : blocks_.size() - 1;
+        while (hi - lo > 1)
+        {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (cumulative(mid) <= k)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        k -= cumulative(lo);
+        for (std::size_t i = lo * block_words; i < nwords; ++i)
+        {
+            const auto c = static_cast<std::size_t>(popcount(w[i]));
+            if (k < c)
+            {
+                return i * 64 + static_cast<std::size_t>(select_in_word(w[i], static_cast<unsigned>(k)));
+            }
+            k -= c;
+        }
+        return bits_npos;
+    }
+
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        return blocks_.capacity() * sizeof(std::uint32_t) + super_.capacity() * sizeof(std::uint64_t) +
+            samples_.capacity() * sizeof(std::size_t);
+    }
+
+private:
+    std::size_t cumulative(const std::size_t block) const noexcept
+    {
+        return super_[block / blocks_per_super] + blocks_[block];
+    }
+
+    std::vector<std::uint32_t> blocks_;
+    std::vector<std::size_t> super_;
+    std::vector<std::size_t> samples_;
+    std::size_t ones_ = 0;
+};
+}
+}
@@ -2,19 +2,29 @@
 #include <vector>
 #include <cstdint>
 #include <cstddef>
+#include <stdexcept>
 
+#include "bit_ops.h"
+#include "bitset_io.h"
+
+// Bits past size() in the last word are always kept zero, so whole-word kernels
+// (count, any, comparisons) never need to mask.
 class bitset
 {
 public:
-    explicit bitset(const std::size_t n): bits_((n + 63) / 64) {}
+    static constexpr std::size_t npos = mib::detail::bits_npos;
+
+    explicit bitset(const std::size_t n): bits_((n + 63) / 64), size_(n) {}
 
     void set(const std::size_t i)
     {
+        rank_.invalidate();
         bits_[i / 64] |= static_cast<uint64_t>(1) << i % 64;
     }
 
     void reset(const std::size_t i)
     {
+        rank_.invalidate();
         bits_[i / 64] &= ~(static_cast<uint64_t>(1) << i % 64);
     }
 
@@ -22,6 +32,179 @@ public:
     {
         return bits_[i / 64] & static_cast<uint64_t>(1) << i % 64;
     }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return mib::detail::popcount_words(bits_.data(), bits_.size());
+    }
+
+    [[nodiscard]] bool any() const noexcept
+    {
+        return mib::detail::any_words(bits_.data(), bits_.size());
+    }
+
+    [[nodiscard]] bool none() const noexcept
+    {
+        return !any();
+    }
+
+    [[nodiscard]] bool all() const noexcept
+    {
+        return mib::detail::all_words(bits_.data(), size_);
+    }
+
+    bitset& operator&=(const bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_and>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    bitset& operator|=(const bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_or>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    bitset& operator^=(const bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_xor>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    // this & ~o without materialising ~o.
+    bitset& and_not(const bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_and_not>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    bitset& flip() noexcept
+    {
+        rank_.invalidate();
+        mib::detail::flip_words(bits_.data(), bits_.size());
+        clear_tail();
+        return *this;
+    }
+
+    bitset operator~() const
+    {
+        return bitset(*this).flip();
+    }
+
+    friend bitset operator&(bitset a, const bitset& b)
+    {
+        return a &= b;
+    }
+
+    friend bitset operator|(bitset a, const bitset& b)
+    {
+        return a |= b;
+    }
+
+    friend bitset operator^(bitset a, const bitset& b)
+    {
+        return a ^= b;
+    }
+
+    bool operator==(const bitset& o) const
+    {
+        return size_ == o.size_ && bits_ == o.bits_;
+    }
+
+    bool operator!=(const bitset& o) const
+    {
+        return !(*this == o);
+    }
+
+    [[nodiscard]] std::size_t find_first() const noexcept
+    {
+        return mib::detail::find_from(bits_.data(), bits_.size(), 0);
+    }
+
+    // First set bit strictly after i, or npos.
+    [[nodiscard]] std::size_t find_next(const std::size_t i) const noexcept
+    {
+        return i + 1 >= size_ ? npos : mib::detail::find_from(bits_.data(), bits_.size(), i + 1);
+    }
+
+    // rank/select need a fresh build_rank_index() after any change to the bits; until
+    // then they throw std::logic_error.
+    void build_rank_index()
+    {
+        rank_.build(bits_.data(), bits_.size());
+    }
+
+    // Number of set bits in [0, i).
+    [[nodiscard]] std::size_t rank(const std::size_t i) const
+    {
+        check_rank_index();
+        return rank_.rank(bits_.data(), i);
+    }
+
+    // Position of the k-th (0-based) set bit, or npos.
+    [[nodiscard]] std::size_t select(const std::size_t k) const
+    {
+        check_rank_index();
+        return rank_.select(bits_.data(), bits_.size(), k);
+    }
+
+    [[nodiscard]] const uint64_t* data() const noexcept
+    {
+        return bits_.data();
+    }
+
+    // Writes the bitset_io.h format; load() checks the header and checksum.
+    void save(std::ostream& out) const
+    {
+        mib::detail::write_bits(out, bits_.data(), bits_.size(), size_);
+    }
+
+    static bitset load(std::istream& in)
+    {
+        bitset out(0);
+        out.size_ = mib::detail::read_bits(in, out.bits_);
+        return out;
+    }
+
 private:
+    void clear_tail() noexcept
+    {
+        if (!bits_.empty())
+        {
+            bits_.back() &= mib::detail::tail_mask(size_);
+        }
+    }
+
+    void check_same_size(const bitset& o) const
+    {
+        if (size_ != o.size_)
+        {
+            throw std::invalid_argument("bitset: size mismatch");
+        }
+    }
+
+    void check_rank_index() const
+    {
+        if (!rank_.built())
+        {
+            throw std::logic_error("bitset: build_rank_index() not called");
+        }
+    }
+
     std::vector<uint64_t> bits_;
+    std::size_t size_;
+    mib::detail::rank_index rank_;
 };
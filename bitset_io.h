@@ -0,0 +1,176 @@
+#pragma once
+
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "bit_ops.h"
+
+// On-disk layout shared by bitset, dynamic_bitset and dynamic_bitset_view: a 64-byte
+// header followed by the 64-bit words in the writer's byte order. Keeping the header
+// a multiple of the word size lets a mapped file be read in place.
+
+namespace mib
+{
+namespace detail
+{
+constexpr char bitset_magic[8] = {'M', 'I', 'B', 'B', 'I', 'T', 'S', '\0'};
+constexpr std::uint32_t bitset_format_version = 1;
+constexpr std::uint32_t bitset_byte_order_mark = 0x01020304;
+
+struct bitset_header
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t word_bits;
+    std::uint32_t byte_order;
+    std::uint32_t reserved0;
+    std::uint64_t bit_length;
+    std::uint64_t word_count;
+    std::uint64_t checksum;
+    std::uint8_t reserved[16];
+};
+
+static_assert(sizeof(bitset_header) == 64, "bitset_header must stay 64 bytes");
+
+inline std::uint32_t byte_swap(const std::uint32_t x) noexcept
+{
+    return (x >> 24) | ((x >> 8) & 0xff00) | ((x << 8) & 0xff0000) | (x << 24);
+}
+
+inline std::uint64_t byte_swap(const std::uint64_t x) noexcept
+{
+    return static_cast<std::uint64_t>(byte_swap(static_cast<std::uint32_t>(x))) << 32 |
+        byte_swap(static_cast<std::uint32_t>(x >> 32));
+}
+
+// Four independent multiply-xor lanes so the loop is not bound by one multiply chain.
+inline std::uint64_t bitset_checksum(const std::uint64_t* w, const std::size_t n) noexcept
+{
+    constexpr std::uint64_t prime = 0x9E3779B97F4A7C15ull;
+    std::uint64_t lanes[4] = {prime, prime ^ 1, prime ^ 2, prime ^ 3};
+
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        for (std::size_t k = 0; k < 4; ++k)
+        {
+            lanes[k] = (lanes[k] ^ w[i + k]) * prime;
+        }
+    }
+    for (; i < n; ++i)
+    {
+        lanes[0] = (lanes[0] ^ w[i]) * prime;
+    }
+
+    std::uint64_t h = n;
+    for (const std::uint64_t lane : lanes)
+    {
+        h = (h ^ (lane >> 29) ^ lane) * prime;
+    }
+    return h ^ (h >> 32);
+}
+
+inline bitset_header make_bitset_header(const std::uint64_t* w, const std::size_t nwords, const std::size_t nbits) noexcept
+{
+    bitset_header h{};
+    std::memcpy(h.magic, bitset_magic, sizeof(h.magic));
+    h.version = bitset_format_version;
+    h.word_bits = 64;
+    h.byte_order = bitset_byte_order_mark;
+    h.bit_length = nbits;
+    h.word_count = nwords;
+    h.checksum = bitset_checksum(w, nwords);
+    return h;
+}
+
+// Validates everything except the checksum; returns true if the writer's byte order
+// differs from ours (the header is returned already swapped to native order).
+inline bool check_bitset_header(bitset_header& h)
+{
+    if (std::memcmp(h.magic, bitset_magic, sizeof(h.magic)) != 0)
+    {
+        throw std::runtime_error("bitset file: bad magic");
+    }
+
+    bool swapped = false;
+    if (h.byte_order == byte_swap(bitset_byte_order_mark))
+    {
+        swapped = true;
+        h.version = byte_swap(h.version);
+        h.word_bits = byte_swap(h.word_bits);
+        h.bit_length = byte_swap(h.bit_length);
+        h.word_count = byte_swap(h.word_count);
+        h.checksum = byte_swap(h.checksum);
+    }
+    else if (h.byte_order != bitset_byte_order_mark)
+    {
+        throw std::runtime_error("bitset file: unknown byte order");
+    }
+
+    if (h.version != bitset_format_version)
+    {
+        throw std::runtime_error("bitset file: unsupported version");
+    }
+    if (h.bit_length > std::numeric_limits<std::size_t>::max())
+    {
+        throw std::runtime_error("bitset file: bit length too large");
+    }
+    // Written so a bit length near 2^64 cannot wrap.
+    if (h.word_bits != 64 || h.word_count != h.bit_length / 64 + (h.bit_length % 64 != 0))
+    {
+        throw std::runtime_error("bitset file: inconsistent header");
+    }
+    return swapped;
+}
+
+inline void write_bits(std::ostream& out, const std::uint64_t* w, const std::size_t nwords, const std::size_t nbits)
+{
+    const bitset_header h = make_bitset_header(w, nwords, nbits);
+    out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    out.write(reinterpret_cast<const char*>(w), static_cast<std::streamsize>(nwords * sizeof(std::uint64_t)));
+    if (!out)
+    {
+        throw std::runtime_error("bitset file: write failed");
+    }
+}
+
+// Reads a whole file into words, returning the bit length.
+inline std::size_t read_bits(std::istream& in, std::vector<std::uint64_t>& words)
+{
+    bitset_header h;
+    if (!in.read(reinterpret_cast<char*>(&h), sizeof(h)))
+    {
+        throw std::runtime_error("bitset file: truncated header");
+    }
+    const bool swapped = check_bitset_header(h);
+
+    words.resize(static_cast<std::size_t>(h.word_count));
+    if (!in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(std::uint64_t))))
+    {
+        throw std::runtime_error("bitset file: truncated data");
+    }
+    if (swapped)
+    {
+        for (auto& w : words)
+        {
+            w = byte_swap(w);
+        }
+    }
+    if (bitset_checksum(words.data(), words.size()) != h.checksum)
+    {
+        throw std::runtime_error("bitset file: checksum mismatch");
+    }
+    if (!words.empty())
+    {
+        words.back() &= tail_mask(static_cast<std::size_t>(h.bit_length));
+    }
+    return static_cast<std::size_t>(h.bit_length);
+}
+}
+}
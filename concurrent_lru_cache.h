@@ -0,0 +1,337 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+#include "lru_cache.h"
+
+// LRU cache split into independently locked shards picked by the top hash bits, so
+// threads only contend when they hit the same shard. Each shard preallocates its
+// slots, so after construction put/get/erase never allocate and entries never move.
+//
+// get(k) returns a handle that pins the entry: while any handle is alive the value is
+// neither evicted nor destroyed, and a put or erase on that key unhooks the old entry
+// and leaves it to be reclaimed once the last handle is gone. Unpinning is a single
+// atomic decrement. A put fails, returning false, only if every slot of its shard is
+// pinned. Handles must not outlive the cache.
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class concurrent_lru_cache
+{
+    using table_type = mib::detail::cache_table<K, V, Hash, KeyEqual>;
+    using index_type = typename table_type::index_type;
+
+public:
+    static constexpr std::size_t cache_line = 64;
+
+    class handle
+    {
+    public:
+        handle() = default;
+
+        handle(const handle&) = delete;
+        handle& operator=(const handle&) = delete;
+
+        handle(handle&& other) noexcept
+            : value_(std::exchange(other.value_, nullptr))
+            , pin_(std::exchange(other.pin_, nullptr))
+        {}
+
+        handle& operator=(handle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                value_ = std::exchange(other.value_, nullptr);
+                pin_ = std::exchange(other.pin_, nullptr);
+            }
+            return *this;
+        }
+
+        ~handle()
+        {
+            reset();
+        }
+
+        void reset() noexcept
+        {
+            if (pin_)
+            {
+                pin_->fetch_sub(1, std::memory_order_release);
+            }
+            value_ = nullptr;
+            pin_ = nullptr;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return value_ != nullptr;
+        }
+
+        const V& operator*() const noexcept
+        {
+            return *value_;
+        }
+
+        const V* operator->() const noexcept
+        {
+            return value_;
+        }
+
+    private:
+        friend class concurrent_lru_cache;
+
+        handle(const V* value, std::atomic<std::uint32_t>* pin) noexcept: value_(value), pin_(pin) {}
+
+        const V* value_ = nullptr;
+        std::atomic<std::uint32_t>* pin_ = nullptr;
+    };
+
+    // shards == 0 picks four per hardware thread; the count is rounded up to a power of two.
+    explicit concurrent_lru_cache(const std::size_t capacity, std::size_t shards = 0, const Hash& hash = Hash(),
+                                  const KeyEqual& eq = KeyEqual())
+        : capacity_(capacity)
+    {
+        if (shards == 0)
+        {
+            shards = 4 * std::max<std::size_t>(1, std::thread::hardware_concurrency());
+        }
+        while (shards > 1 && shards > capacity)
+        {
+            shards /= 2;
+        }
+        while ((std::size_t{1} << shard_bits_) < shards)
+        {
+            ++shard_bits_;
+        }
+
+        const std::size_t count = std::size_t{1} << shard_bits_;
+        const std::size_t per_shard = (capacity + count - 1) / count;
+        shards_.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            shards_.push_back(std::make_unique<shard>(per_shard, hash, eq));
+        }
+    }
+
+    concurrent_lru_cache(const concurrent_lru_cache&) = delete;
+    concurrent_lru_cache& operator=(const concurrent_lru_cache&) = delete;
+
+    bool put(const K& k, const V& v)
+    {
+        return put_impl(k, v);
+    }
+
+    bool put(K&& k, V&& v)
+    {
+        return put_impl(std::move(k), std::move(v));
+    }
+
+    handle get(const K& k)
+    {
+        const std::size_t h = hash_of(k);
+        shard& s = shard_for(h);
+        std::lock_guard<std::mutex> lock(s.m);
+
+        const index_type i = s.table.find(k, h);
+        if (i == table_type::nil)
+        {
+            ++s.misses;
+            return {};
+        }
+        ++s.hits;
+        s.order.on_hit(i);
+        s.pins[i].fetch_add(1, std::memory_order_relaxed);
+        return handle(&s.table.value(i), &s.pins[i]);
+    }
+
+    // Copies the value out under the shard lock.
+    bool get(const K& k, V& out)
+    {
+        const std::size_t h = hash_of(k);
+        shard& s = shard_for(h);
+        std::lock_guard<std::mutex> lock(s.m);
+
+        const index_type i = s.table.find(k, h);
+        if (i == table_type::nil)
+        {
+            ++s.misses;
+            return false;
+        }
+        ++s.hits;
+        s.order.on_hit(i);
+        out = s.table.value(i);
+        return true;
+    }
+
+    bool erase(const K& k)
+    {
+        const std::size_t h = hash_of(k);
+        shard& s = shard_for(h);
+        std::lock_guard<std::mutex> lock(s.m);
+
+        const index_type i = s.table.find(k, h);
+        if (i == table_type::nil)
+        {
+            return false;
+        }
+        s.remove(i);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    [[nodiscard]] std::size_t shard_count() const noexcept
+    {
+        return shards_.size();
+    }
+
+    // Sums the per-shard counters; each shard is read under its own lock, so the total
+    // is not a single point-in-time snapshot.
+    [[nodiscard]] mib::cache_stats stats() const
+    {
+        mib::cache_stats out;
+        for (const auto& s : shards_)
+        {
+            std::lock_guard<std::mutex> lock(s->m);
+            out.hits += s->hits;
+            out.misses += s->misses;
+            out.evictions += s->evictions;
+            out.size += s->table.size();
+            out.weight += s->table.size();
+        }
+        return out;
+    }
+
+private:
+    struct alignas(cache_line) shard
+    {
+        shard(const std::size_t slots, const Hash& hash, const KeyEqual& eq)
+            : table(hash, eq)
+            , order(slots)
+            , pins(std::make_unique<std::atomic<std::uint32_t>[]>(slots))
+            , slots(slots)
+        {
+            table.reserve(slots);
+            order.reserve(slots);
+            orphans.reserve(slots);
+        }
+
+        // Callers hold m.
+        bool pinned(const index_type i) const
+        {
+            return pins[i].load(std::memory_order_acquire) != 0;
+        }
+
+        void remove(const index_type i)
+        {
+            order.on_erase(i);
+            table.detach(i);
+            if (pinned(i))
+            {
+                orphans.push_back(i);
+            }
+            else
+            {
+                table.release(i);
+            }
+        }
+
+        // Frees unpinned orphans first, then the least recent unpinned entry.
+        bool make_room()
+        {
+            for (std::size_t j = 0; j < orphans.size();)
+            {
+                if (!pinned(orphans[j]))
+                {
+                    table.release(orphans[j]);
+                    orphans[j] = orphans.back();
+                    orphans.pop_back();
+                }
+                else
+                {
+                    ++j;
+                }
+            }
+            if (table.size() + orphans.size() < slots)
+            {
+                return true;
+            }
+
+            for (index_type i = order.victim(); i != table_type::nil; i = order.prev(i))
+            {
+                if (!pinned(i))
+                {
+                    order.on_erase(i);
+                    table.erase(i);
+                    ++evictions;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        mutable std::mutex m;
+        table_type table;
+        mib::lru_policy order;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> pins;
+        std::vector<index_type> orphans;
+        std::size_t slots;
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+    };
+
+    // Every shard hashes the same way; the top bits pick the shard and the low bits
+    // the bucket inside it.
+    std::size_t hash_of(const K& k) const
+    {
+        return shards_.front()->table.hash_of(k);
+    }
+
+    shard& shard_for(const std::size_t h)
+    {
+        return *shards_[shard_bits_ ? h >> (64 - shard_bits_) : 0];
+    }
+
+    template<typename KArg, typename VArg>
+    bool put_impl(KArg&& k, VArg&& v)
+    {
+        const std::size_t h = hash_of(k);
+        shard& s = shard_for(h);
+        std::lock_guard<std::mutex> lock(s.m);
+
+        const index_type i = s.table.find(k, h);
+        if (i != table_type::nil && !s.pinned(i))
+        {
+            s.table.value(i) = std::forward<VArg>(v);
+            s.order.on_hit(i);
+            return true;
+        }
+
+        if (s.slots == 0 || (s.table.size() + s.orphans.size() == s.slots && !s.make_room()))
+        {
+            return false;
+        }
+        if (i != table_type::nil)
+        {
+            // Readers still hold the old value, so it is replaced rather than assigned.
+            s.remove(i);
+        }
+        s.order.on_insert(s.table.insert(h, std::forward<KArg>(k), std::forward<VArg>(v)), h, 1);
+        return true;
+    }
+
+    std::size_t capacity_;
+    std::size_t shard_bits_ = 0;
+    std::vector<std::unique_ptr<shard>> shards_;
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+// Lock-free insert/find; nodes are never unlinked while the list is alive,
+// so readers need no reclamation scheme. Values are immutable once published.
+template<typename K, typename V, typename Compare = std::less<K>>
+class concurrent_skip_list
+{
+public:
+    static constexpr int max_level = 32;
+
+private:
+    struct Node
+    {
+        const K key;
+        const V value;
+        const int height;
+        std::atomic<Node*>* next;
+
+        Node(const K& k, const V& v, const int h, std::atomic<Node*>* links) : key(k), value(v), height(h), next(links)
+        {
+            for (int i = 0; i < h; ++i)
+            {
+                ::new (static_cast<void*>(next + i)) std::atomic<Node*>(nullptr);
+            }
+        }
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+
+    concurrent_skip_list() = default;
+    explicit concurrent_skip_list(const Compare& comp) : comp_(comp) {}
+
+    concurrent_skip_list(const concurrent_skip_list&) = delete;
+    concurrent_skip_list& operator=(const concurrent_skip_list&) = delete;
+
+    ~concurrent_skip_list()
+    {
+        Node* n = head_[0].load(std::memory_order_relaxed);
+        while (n)
+        {
+            Node* next = n->next[0].load(std::memory_order_relaxed);
+            destroy_node(n);
+            n = next;
+        }
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    bool insert(const K& k, const V& v)
+    {
+        Node* preds[max_level];
+        Node* succs[max_level];
+
+        if (find_window(k, preds, succs))
+        {
+            return false;
+        }
+
+        const int h = random_level();
+        Node* n = create_node(k, v, h);
+
+        while (true)
+        {
+            for (int i = 0; i < h; ++i)
+            {
+                n->next[i].store(succs[i], std::memory_order_relaxed);
+            }
+
+            Node* expected = succs[0];
+            if (link(preds[0], 0).compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed))
+            {
+                break;
+            }
+
+            if (find_window(k, preds, succs))
+            {
+                destroy_node(n);
+                return false;
+            }
+        }
+
+        for (int i = 1; i < h; ++i)
+        {
+            while (true)
+            {
+                Node* expected = succs[i];
+                if (link(preds[i], i).compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed))
+                {
+                    break;
+                }
+
+                find_window(k, preds, succs);
+                n->next[i].store(succs[i], std::memory_order_relaxed);
+            }
+        }
+
+        raise_level(h);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    const V* find(const K& k) const
+    {
+        Node* pred = nullptr;
+        Node* cur = nullptr;
+
+        for (int i = level_.load(std::memory_order_relaxed) - 1; i >= 0; --i)
+        {
+            cur = link(pred, i).load(std::memory_order_acquire);
+            while (cur && comp_(cur->key, k))
+            {
+                pred = cur;
+                cur = cur->next[i].load(std::memory_order_acquire);
+            }
+        }
+        return cur && !comp_(k, cur->key) ? &cur->value : nullptr;
+    }
+
+    bool contains(const K& k) const
+    {
+        return find(k) != nullptr;
+    }
+
+    template<typename F>
+    void for_each_range(const K& lo, const K& hi, F&& f) const
+    {
+        Node* preds[max_level];
+        Node* succs[max_level];
+        find_window(lo, preds, succs);
+
+        for (Node* n = succs[0]; n && comp_(n->key, hi); n = n->next[0].load(std::memory_order_acquire))
+        {
+            f(n->key, n->value);
+        }
+    }
+
+private:
+    std::atomic<Node*>& link(Node* pred, const int level) const noexcept
+    {
+        return pred ? pred->next[level] : head_[level];
+    }
+
+    bool find_window(const K& k, Node** preds, Node** succs) const
+    {
+        Node* pred = nullptr;
+        for (int i = max_level - 1; i >= 0; --i)
+        {
+            Node* cur = link(pred, i).load(std::memory_order_acquire);
+            while (cur && comp_(cur->key, k))
+            {
+                pred = cur;
+                cur = cur->next[i].load(std::memory_order_acquire);
+            }
+            preds[i] = pred;
+            succs[i] = cur;
+        }
+        return succs[0] && !comp_(k, succs[0]->key);
+    }
+
+    void raise_level(const int h) noexcept
+    {
+        int cur = level_.load(std::memory_order_relaxed);
+        while (h > cur && !level_.compare_exchange_weak(cur, h, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static int random_level() noexcept
+    {
+        thread_local std::uint64_t state = seed();
+
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        std::uint64_t r = state;
+        int h = 1;
+        while ((r & 3) == 0 && h < max_level)
+        {
+            ++h;
+            r >>= 2;
+        }
+        return h;
+    }
+
+    static std::uint64_t seed() noexcept
+    {
+        static std::atomic<std::uint64_t> counter{0};
+        std::uint64_t z = counter.fetch_add(0x9E3779B97F4A7C15ull, std::memory_order_relaxed) + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return (z ^ (z >> 31)) | 1;
+    }
+
+    static Node* create_node(const K& k, const V& v, const int h)
+    {
+        void* raw = ::operator new(sizeof(Node) + h * sizeof(std::atomic<Node*>));
+        auto* links = reinterpret_cast<std::atomic<Node*>*>(static_cast<char*>(raw) + sizeof(Node));
+
+        try
+        {
+            return ::new (raw) Node(k, v, h, links);
+        }
+        catch (...)
+        {
+            ::operator delete(raw);
+            throw;
+        }
+    }
+
+    static void destroy_node(Node* n) noexcept
+    {
+        n->~Node();
+        ::operator delete(n);
+    }
+
+    mutable std::atomic<Node*> head_[max_level] = {};
+    std::atomic<int> level_{1};
+    std::atomic<size_type> size_{0};
+    Compare comp_;
+};
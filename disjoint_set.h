@@ -1,25 +1,43 @@
 #pragma once
+#include <limits>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
 
-class disjoint_set
+// Union by size with path halving. Each slot holds either a parent index or, for a
+// root, the negated component size, so a node costs sizeof(Index) bytes; pick
+// disjoint_set32 when n fits in 31 bits.
+template<typename Index>
+class basic_disjoint_set
 {
+    static_assert(std::is_unsigned_v<Index>, "basic_disjoint_set: Index must be unsigned");
+    using slot_type = std::make_signed_t<Index>;
+
 public:
-    explicit disjoint_set(const std::size_t n): parent_(n), rank_(n,0)
-    {
-        for (std::size_t i = 0; i < n; ++i)
-        {
-            parent_[i] = i;
-        }
-    }
+    explicit basic_disjoint_set(const std::size_t n): slots_(check_size(n), -1), components_(n) {}
 
-    std::size_t find(const std::size_t x)
+    std::size_t find(std::size_t x)
     {
-        if (parent_[x] != x)
+        while (true)
         {
-            parent_[x] = find(parent_[x]);
+            const slot_type parent = slots_[x];
+            if (parent < 0)
+            {
+                return x;
+            }
+            const slot_type grandparent = slots_[static_cast<std::size_t>(parent)];
+            if (grandparent < 0)
+            {
+                return static_cast<std::size_t>(parent);
+            }
+            slots_[x] = grandparent;
+            x = static_cast<std::size_t>(grandparent);
         }
-        return parent_[x];
     }
 
     bool unite(std::size_t a, std::size_t b)
@@ -32,27 +50,169 @@ public:
             return false;
         }
 
-        if (rank_[a] < rank_[b])
+        if (slots_[a] > slots_[b])
         {
-            parent_[a] = b;
+            std::swap(a, b);
         }
-        else if (rank_[b] < rank_[a])
+        slots_[a] += slots_[b];
+        slots_[b] = static_cast<slot_type>(a);
+        --components_;
+        return true;
+    }
+
+    bool same(const std::size_t a, const std::size_t b)
+    {
+        return find(a) == find(b);
+    }
+
+    std::size_t component_size(const std::size_t x)
+    {
+        return static_cast<std::size_t>(-slots_[find(x)]);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return slots_.size();
+    }
+
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return components_;
+    }
+
+private:
+    static std::size_t check_size(const std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(std::numeric_limits<slot_type>::max()))
         {
-            parent_[b] = a;
+            throw std::length_error("disjoint_set: too many elements for the index type");
         }
-        else
+        return n;
+    }
+
+    std::vector<slot_type> slots_;
+    std::size_t components_;
+};
+
+using disjoint_set = basic_disjoint_set<std::size_t>;
+using disjoint_set32 = basic_disjoint_set<std::uint32_t>;
+
+// Lock-free union-find for concurrent edge ingestion. Roots are linked with a single
+// CAS on the root's parent slot, ordered by a hashed priority so linking is
+// effectively randomized; find halves paths with best-effort CASes.
+template<typename Index = std::size_t>
+class concurrent_disjoint_set
+{
+    static_assert(std::is_unsigned_v<Index>, "concurrent_disjoint_set: Index must be unsigned");
+
+public:
+    explicit concurrent_disjoint_set(const std::size_t n)
+        : parent_(std::make_unique<std::atomic<Index>[]>(check_size(n)))
+        , n_(n)
+        , components_(n)
+    {
+        for (std::size_t i = 0; i < n; ++i)
         {
-            parent_[b] = a; ++rank_[a];
+            parent_[i].store(static_cast<Index>(i), std::memory_order_relaxed);
         }
-        return true;
     }
 
-    bool same(const std::size_t a, const std::size_t b)
+    std::size_t find(std::size_t x)
     {
-        return find(a) == find(b);
+        while (true)
+        {
+            Index p = parent_[x].load(std::memory_order_acquire);
+            if (p == x)
+            {
+                return x;
+            }
+            const Index gp = parent_[p].load(std::memory_order_acquire);
+            if (gp != p)
+            {
+                parent_[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel, std::memory_order_relaxed);
+            }
+            x = gp;
+        }
+    }
+
+    bool unite(std::size_t a, std::size_t b)
+    {
+        while (true)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+            {
+                return false;
+            }
+
+            if (before(a, b))
+            {
+                std::swap(a, b);
+            }
+            // a has the lower priority and goes under b; fails if a stopped being a root.
+            Index expected = static_cast<Index>(a);
+            if (parent_[a].compare_exchange_strong(expected, static_cast<Index>(b), std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed))
+            {
+                components_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    bool same(std::size_t a, std::size_t b)
+    {
+        while (true)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+            {
+                return true;
+            }
+            if (parent_[a].load(std::memory_order_acquire) == a)
+            {
+                return false;
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return n_;
+    }
+
+    // Exact once all writers have finished.
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return components_.load(std::memory_order_relaxed);
     }
 
 private:
-    std::vector<std::size_t> parent_;
-    std::vector<int> rank_;
+    static std::size_t check_size(const std::size_t n)
+    {
+        if (n > static_cast<std::size_t>(std::numeric_limits<Index>::max()))
+        {
+            throw std::length_error("concurrent_disjoint_set: too many elements for the index type");
+        }
+        return n;
+    }
+
+    static std::uint64_t priority(const std::uint64_t x) noexcept
+    {
+        std::uint64_t h = x * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 32);
+    }
+
+    static bool before(const std::size_t a, const std::size_t b) noexcept
+    {
+        const std::uint64_t pa = priority(a);
+        const std::uint64_t pb = priority(b);
+        return pa != pb ? pa > pb : a > b;
+    }
+
+    std::unique_ptr<std::atomic<Index>[]> parent_;
+    std::size_t n_;
+    std::atomic<std::size_t> components_;
 };
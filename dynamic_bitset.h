@@ -2,29 +2,220 @@
 #include <vector>
 #include <cstdint>
 #include <cstddef>
+#include <stdexcept>
 
+#include "bit_ops.h"
+#include "bitset_io.h"
+
+// Bits past size() in the last word are always kept zero; see bitset.h.
 class dynamic_bitset
 {
 public:
+    static constexpr std::size_t npos = mib::detail::bits_npos;
+
     dynamic_bitset() = default;
-    explicit dynamic_bitset(const std::size_t n): bits_((n + 63) / 64) {}
+    explicit dynamic_bitset(const std::size_t n): bits_((n + 63) / 64), size_(n) {}
 
     void resize(const std::size_t n)
     {
+        rank_.invalidate();
         bits_.resize((n + 63) / 64);
+        size_ = n;
+        clear_tail();
     }
+
     void set(const std::size_t i)
     {
+        rank_.invalidate();
         bits_[i / 64] |= static_cast<uint64_t>(1) << i % 64;
     }
+
     void reset(const std::size_t i)
     {
+        rank_.invalidate();
         bits_[i / 64] &= ~(static_cast<uint64_t>(1) << i % 64);
     }
+
     [[nodiscard]] bool test(const std::size_t i) const
     {
         return bits_[i / 64] & static_cast<uint64_t>(1) << i % 64;
     }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return mib::detail::popcount_words(bits_.data(), bits_.size());
+    }
+
+    [[nodiscard]] bool any() const noexcept
+    {
+        return mib::detail::any_words(bits_.data(), bits_.size());
+    }
+
+    [[nodiscard]] bool none() const noexcept
+    {
+        return !any();
+    }
+
+    [[nodiscard]] bool all() const noexcept
+    {
+        return mib::detail::all_words(bits_.data(), size_);
+    }
+
+    dynamic_bitset& operator&=(const dynamic_bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_and>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    dynamic_bitset& operator|=(const dynamic_bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_or>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    dynamic_bitset& operator^=(const dynamic_bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_xor>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    // this & ~o without materialising ~o.
+    dynamic_bitset& and_not(const dynamic_bitset& o)
+    {
+        check_same_size(o);
+        rank_.invalidate();
+        mib::detail::apply_words<mib::detail::bit_and_not>(bits_.data(), o.bits_.data(), bits_.size());
+        return *this;
+    }
+
+    dynamic_bitset& flip() noexcept
+    {
+        rank_.invalidate();
+        mib::detail::flip_words(bits_.data(), bits_.size());
+        clear_tail();
+        return *this;
+    }
+
+    dynamic_bitset operator~() const
+    {
+        return dynamic_bitset(*this).flip();
+    }
+
+    friend dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset& b)
+    {
+        return a &= b;
+    }
+
+    friend dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset& b)
+    {
+        return a |= b;
+    }
+
+    friend dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset& b)
+    {
+        return a ^= b;
+    }
+
+    bool operator==(const dynamic_bitset& o) const
+    {
+        return size_ == o.size_ && bits_ == o.bits_;
+    }
+
+    bool operator!=(const dynamic_bitset& o) const
+    {
+        return !(*this == o);
+    }
+
+    [[nodiscard]] std::size_t find_first() const noexcept
+    {
+        return mib::detail::find_from(bits_.data(), bits_.size(), 0);
+    }
+
+    // First set bit strictly after i, or npos.
+    [[nodiscard]] std::size_t find_next(const std::size_t i) const noexcept
+    {
+        return i + 1 >= size_ ? npos : mib::detail::find_from(bits_.data(), bits_.size(), i + 1);
+    }
+
+    // rank/select need a fresh build_rank_index() after any change to the bits; until
+    // then they throw std::logic_error.
+    void build_rank_index()
+    {
+        rank_.build(bits_.data(), bits_.size());
+    }
+
+    // Number of set bits in [0, i).
+    [[nodiscard]] std::size_t rank(const std::size_t i) const
+    {
+        check_rank_index();
+        return rank_.rank(bits_.data(), i);
+    }
+
+    // Position of the k-th (0-based) set bit, or npos.
+    [[nodiscard]] std::size_t select(const std::size_t k) const
+    {
+        check_rank_index();
+        return rank_.select(bits_.data(), bits_.size(), k);
+    }
+
+    [[nodiscard]] const uint64_t* data() const noexcept
+    {
+        return bits_.data();
+    }
+
+    // Same file format as bitset; see bitset_io.h.
+    void save(std::ostream& out) const
+    {
+        mib::detail::write_bits(out, bits_.data(), bits_.size(), size_);
+    }
+
+    static dynamic_bitset load(std::istream& in)
+    {
+        dynamic_bitset out;
+        out.size_ = mib::detail::read_bits(in, out.bits_);
+        return out;
+    }
+
 private:
+    friend class roaring_bitmap;
+    friend class dynamic_bitset_view;
+
+    void clear_tail() noexcept
+    {
+        if (!bits_.empty())
+        {
+            bits_.back() &= mib::detail::tail_mask(size_);
+        }
+    }
+
+    void check_same_size(const dynamic_bitset& o) const
+    {
+        if (size_ != o.size_)
+        {
+            throw std::invalid_argument("dynamic_bitset: size mismatch");
+        }
+    }
+
+    void check_rank_index() const
+    {
+        if (!rank_.built())
+        {
+            throw std::logic_error("dynamic_bitset: build_rank_index() not called");
+        }
+    }
+
     std::vector<uint64_t> bits_;
+    std::size_t size_ = 0;
+    mib::detail::rank_index rank_;
 };
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+
+#include "bit_ops.h"
+#include "bitset_io.h"
+#include "dynamic_bitset.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define MIB_BITSET_VIEW_MMAP 1
+#endif
+
+// Read-only dynamic_bitset over words owned elsewhere, typically a file written by
+// dynamic_bitset::save() and mapped with map_file(): opening it costs one mmap and a
+// header check, and pages are faulted in as queries touch them.
+class dynamic_bitset_view
+{
+public:
+    static constexpr std::size_t npos = mib::detail::bits_npos;
+
+    dynamic_bitset_view() = default;
+
+    // Borrows words; the tail past nbits must already be zero.
+    dynamic_bitset_view(const std::uint64_t* words, const std::size_t nbits) noexcept
+        : words_(words)
+        , nwords_((nbits + 63) / 64)
+        , size_(nbits)
+    {}
+
+    explicit dynamic_bitset_view(const dynamic_bitset& bits) noexcept
+        : dynamic_bitset_view(bits.data(), bits.size())
+    {}
+
+    dynamic_bitset_view(const dynamic_bitset_view&) = delete;
+    dynamic_bitset_view& operator=(const dynamic_bitset_view&) = delete;
+
+    dynamic_bitset_view(dynamic_bitset_view&& other) noexcept
+        : words_(std::exchange(other.words_, nullptr))
+        , nwords_(std::exchange(other.nwords_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , mapping_bytes_(std::exchange(other.mapping_bytes_, 0))
+    {}
+
+    dynamic_bitset_view& operator=(dynamic_bitset_view&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            words_ = std::exchange(other.words_, nullptr);
+            nwords_ = std::exchange(other.nwords_, 0);
+            size_ = std::exchange(other.size_, 0);
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            mapping_bytes_ = std::exchange(other.mapping_bytes_, 0);
+        }
+        return *this;
+    }
+
+    ~dynamic_bitset_view()
+    {
+        unmap();
+    }
+
+    // Maps a file in the bitset_io.h format. The checksum pass reads every page, so it
+    // is off by default; the header is always validated.
+    static dynamic_bitset_view map_file(const std::string& path, const bool verify_checksum = false)
+    {
+#if defined(MIB_BITSET_VIEW_MMAP)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("dynamic_bitset_view: cannot open " + path);
+        }
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(mib::detail::bitset_header))
+        {
+            ::close(fd);
+            throw std::runtime_error("dynamic_bitset_view: truncated file " + path);
+        }
+
+        const auto bytes = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+        {
+            throw std::runtime_error("dynamic_bitset_view: mmap failed for " + path);
+        }
+
+        dynamic_bitset_view view;
+        view.mapping_ = p;
+        view.mapping_bytes_ = bytes;
+
+        mib::detail::bitset_header h;
+        std::memcpy(&h, p, sizeof(h));
+        if (mib::detail::check_bitset_header(h))
+        {
+            throw std::runtime_error("dynamic_bitset_view: file has foreign byte order, use dynamic_bitset::load");
+        }
+        if (h.word_count > (bytes - sizeof(h)) / sizeof(std::uint64_t))
+        {
+            throw std::runtime_error("dynamic_bitset_view: truncated file " + path);
+        }
+
+        view.words_ = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(p) + sizeof(h));
+        view.nwords_ = static_cast<std::size_t>(h.word_count);
+        view.size_ = static_cast<std::size_t>(h.bit_length);
+
+        if (verify_checksum && mib::detail::bitset_checksum(view.words_, view.nwords_) != h.checksum)
+        {
+            throw std::runtime_error("dynamic_bitset_view: checksum mismatch in " + path);
+        }
+        if (view.nwords_ && (view.words_[view.nwords_ - 1] & ~mib::detail::tail_mask(view.size_)))
+        {
+            throw std::runtime_error("dynamic_bitset_view: bits set past the end in " + path);
+        }
+        return view;
+#else
+        (void)path;
+        (void)verify_checksum;
+        throw std::runtime_error("dynamic_bitset_view: memory mapping is not supported on this platform");
+#endif
+    }
+
+    [[nodiscard]] bool test(const std::size_t i) const
+    {
+        return words_[i / 64] & static_cast<uint64_t>(1) << i % 64;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] std::size_t count() const noexcept
+    {
+        return mib::detail::popcount_words(words_, nwords_);
+    }
+
+    [[nodiscard]] bool any() const noexcept
+    {
+        return mib::detail::any_words(words_, nwords_);
+    }
+
+    [[nodiscard]] bool none() const noexcept
+    {
+        return !any();
+    }
+
+    [[nodiscard]] bool all() const noexcept
+    {
+        return mib::detail::all_words(words_, size_);
+    }
+
+    [[nodiscard]] std::size_t find_first() const noexcept
+    {
+        return mib::detail::find_from(words_, nwords_, 0);
+    }
+
+    [[nodiscard]] std::size_t find_next(const std::size_t i) const noexcept
+    {
+        return i + 1 >= size_ ? npos : mib::detail::find_from(words_, nwords_, i + 1);
+    }
+
+    [[nodiscard]] const uint64_t* data() const noexcept
+    {
+        return words_;
+    }
+
+    [[nodiscard]] bool is_mapped() const noexcept
+    {
+        return mapping_ != nullptr;
+    }
+
+    [[nodiscard]] dynamic_bitset to_dynamic_bitset() const
+    {
+        dynamic_bitset out(size_);
+        if (nwords_)
+        {
+            std::memcpy(out.bits_.data(), words_, nwords_ * sizeof(std::uint64_t));
+        }
+        return out;
+    }
+
+private:
+    void unmap() noexcept
+    {
+#if defined(MIB_BITSET_VIEW_MMAP)
+        if (mapping_)
+        {
+            ::munmap(mapping_, mapping_bytes_);
+        }
+#endif
+        mapping_ = nullptr;
+        mapping_bytes_ = 0;
+    }
+
+    const std::uint64_t* words_ = nullptr;
+    std::size_t nwords_ = 0;
+    std::size_t size_ = 0;
+    void* mapping_ = nullptr;
+    std::size_t mapping_bytes_ = 0;
+};
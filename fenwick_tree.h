@@ -2,14 +2,30 @@
 #include <vector>
 #include <cstddef>
 
+// Prefix sums are inclusive: sum(i) covers [0, i], range_sum(l, r) covers [l, r].
 template<typename T>
 class fenwick_tree
 {
 public:
     explicit fenwick_tree(const std::size_t n): n_(n), data_(n+1) {}
+
+    // O(n): each node pushes its partial sum to its parent once.
+    explicit fenwick_tree(const std::vector<T>& a): n_(a.size()), data_(a.size() + 1)
+    {
+        for (std::size_t i = 1; i <= n_; ++i)
+        {
+            data_[i] += a[i - 1];
+            const std::size_t parent = i + lowbit(i);
+            if (parent <= n_)
+            {
+                data_[parent] += data_[i];
+            }
+        }
+    }
+
     void add(std::size_t i, T delta)
     {
-        for (++i; i <= n_; i += i & -i)
+        for (++i; i <= n_; i += lowbit(i))
         {
             data_[i] += delta;
         }
@@ -17,13 +33,220 @@ public:
     T sum(std::size_t i) const
     {
         T r{};
-        for (++i; i; i -= i & -i)
+        for (++i; i; i -= lowbit(i))
         {
             r += data_[i];
         }
         return r;
     }
+
+    T range_sum(const std::size_t l, const std::size_t r) const
+    {
+        return l ? sum(r) - sum(l - 1) : sum(r);
+    }
+
+    // Smallest i with sum(i) >= target, or size() if there is none. Needs every
+    // element to be non-negative so prefix sums are monotone.
+    std::size_t lower_bound(T target) const
+    {
+        std::size_t pos = 0;
+        std::size_t step = 1;
+        while (step * 2 <= n_)
+        {
+            step *= 2;
+        }
+
+        for (; step; step >>= 1)
+        {
+            if (pos + step <= n_ && data_[pos + step] < target)
+            {
+                pos += step;
+                target -= data_[pos];
+            }
+        }
+        return pos;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return n_;
+    }
+
+    static std::size_t lowbit(const std::size_t i) noexcept
+    {
+        return i & (~i + 1);
+    }
 private:
     std::size_t n_;
     std::vector<T> data_;
 };
+
+// Range add and range sum with two trees: adding d to [l, r] is stored as slope and
+// offset terms so that prefix(i) = sum(slope, i) * (i + 1) - sum(offset, i).
+template<typename T>
+class range_fenwick_tree
+{
+public:
+    explicit range_fenwick_tree(const std::size_t n): slope_(n), offset_(n) {}
+
+    explicit range_fenwick_tree(const std::vector<T>& a): slope_(a.size()), offset_(prefix_offsets(a)) {}
+
+    void add(const std::size_t l, const std::size_t r, const T& delta)
+    {
+        slope_.add(l, delta);
+        offset_.add(l, delta * static_cast<T>(l));
+        if (r + 1 < size())
+        {
+            slope_.add(r + 1, -delta);
+            offset_.add(r + 1, -delta * static_cast<T>(r + 1));
+        }
+    }
+
+    T sum(const std::size_t i) const
+    {
+        return slope_.sum(i) * static_cast<T>(i + 1) - offset_.sum(i);
+    }
+
+    T range_sum(const std::size_t l, const std::size_t r) const
+    {
+        return l ? sum(r) - sum(l - 1) : sum(r);
+    }
+
+    T get(const std::size_t i) const
+    {
+        return range_sum(i, i);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return slope_.size();
+    }
+
+private:
+    // Initial values enter only the offset tree, as a negative point mass.
+    static fenwick_tree<T> prefix_offsets(const std::vector<T>& a)
+    {
+        std::vector<T> neg(a.size());
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            neg[i] = -a[i];
+        }
+        return fenwick_tree<T>(neg);
+    }
+
+    fenwick_tree<T> slope_;
+    fenwick_tree<T> offset_;
+};
+
+// 2D point update, rectangle sum; sum(r, c) covers rows [0, r] and columns [0, c].
+template<typename T>
+class fenwick_tree_2d
+{
+public:
+    fenwick_tree_2d(const std::size_t rows, const std::size_t cols)
+        : rows_(rows), cols_(cols), data_((rows + 1) * (cols + 1))
+    {}
+
+    // O(rows * cols) build from a row-major grid, one parent push per axis.
+    fenwick_tree_2d(const std::vector<T>& grid, const std::size_t rows, const std::size_t cols)
+        : fenwick_tree_2d(rows, cols)
+    {
+        for (std::size_t r = 1; r <= rows_; ++r)
+        {
+            for (std::size_t c = 1; c <= cols_; ++c)
+            {
+                at(r, c) += grid[(r - 1) * cols_ + (c - 1)];
+            }
+        }
+        for (std::size_t r = 1; r <= rows_; ++r)
+        {
+            for (std::size_t c = 1; c <= cols_; ++c)
+            {
+                const std::size_t pc = c + fenwick_tree<T>::lowbit(c);
+                if (pc <= cols_)
+                {
+                    at(r, pc) += at(r, c);
+                }
+            }
+        }
+        for (std::size_t r = 1; r <= rows_; ++r)
+        {
+            const std::size_t pr = r + fenwick_tree<T>::lowbit(r);
+            if (pr <= rows_)
+            {
+                for (std::size_t c = 1; c <= cols_; ++c)
+                {
+                    at(pr, c) += at(r, c);
+                }
+            }
+        }
+    }
+
+    void add(const std::size_t row, const std::size_t col, const T& delta)
+    {
+        for (std::size_t r = row + 1; r <= rows_; r += fenwick_tree<T>::lowbit(r))
+        {
+            for (std::size_t c = col + 1; c <= cols_; c += fenwick_tree<T>::lowbit(c))
+            {
+                at(r, c) += delta;
+            }
+        }
+    }
+
+    T sum(const std::size_t row, const std::size_t col) const
+    {
+        T s{};
+        for (std::size_t r = row + 1; r; r -= fenwick_tree<T>::lowbit(r))
+        {
+            for (std::size_t c = col + 1; c; c -= fenwick_tree<T>::lowbit(c))
+            {
+                s += at(r, c);
+            }
+        }
+        return s;
+    }
+
+    // Sum over rows [r1, r2] and columns [c1, c2].
+    T range_sum(const std::size_t r1, const std::size_t c1, const std::size_t r2, const std::size_t c2) const
+    {
+        T s = sum(r2, c2);
+        if (r1)
+        {
+            s -= sum(r1 - 1, c2);
+        }
+        if (c1)
+        {
+            s -= sum(r2, c1 - 1);
+        }
+        if (r1 && c1)
+        {
+            s += sum(r1 - 1, c1 - 1);
+        }
+        return s;
+    }
+
+    [[nodiscard]] std::size_t rows() const noexcept
+    {
+        return rows_;
+    }
+
+    [[nodiscard]] std::size_t cols() const noexcept
+    {
+        return cols_;
+    }
+
+private:
+    T& at(const std::size_t r, const std::size_t c)
+    {
+        return data_[r * (cols_ + 1) + c];
+    }
+
+    const T& at(const std::size_t r, const std::size_t c) const
+    {
+        return data_[r * (cols_ + 1) + c];
+    }
+
+    std::size_t rows_;
+    std::size_t cols_;
+    std::vector<T> data_;
+};
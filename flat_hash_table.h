@@ -0,0 +1,812 @@
+#pragma once
+
+#include <new>
+#include <tuple>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "bit_ops.h"
+#include "relocatable.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIB_FLAT_HASH_SSE2 1
+#endif
+
+// Open-addressing table in the Swiss-table layout: one control byte per slot
+// (empty, deleted, or the low 7 bits of the hash) scanned a group at a time.
+// The first group_width control bytes are mirrored past the end so a group load
+// starting at any slot stays in bounds.
+
+namespace mib
+{
+namespace detail
+{
+using ctrl_t = std::int8_t;
+
+constexpr ctrl_t ctrl_empty = -128;
+constexpr ctrl_t ctrl_deleted = -2;
+
+template<int Shift>
+class bitmask
+{
+public:
+    explicit bitmask(const std::uint64_t mask) noexcept : mask_(mask) {}
+
+    explicit operator bool() const noexcept
+    {
+        return mask_ != 0;
+    }
+
+    int lowest() const noexcept
+    {
+        return countr_zero(mask_) >> Shift;
+    }
+
+    void clear_lowest() noexcept
+    {
+        mask_ &= mask_ - 1;
+    }
+
+private:
+    std::uint64_t mask_;
+};
+
+#if defined(__AVX2__)
+struct group
+{
+    static constexpr std::size_t width = 32;
+    __m256i ctrl;
+
+    explicit group(const ctrl_t* p) noexcept : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+
+    bitmask<0> match(const ctrl_t h2) const noexcept
+    {
+        return bitmask<0>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl))));
+    }
+
+    bitmask<0> match_empty() const noexcept
+    {
+        return match(ctrl_empty);
+    }
+
+    bitmask<0> match_empty_or_deleted() const noexcept
+    {
+        return bitmask<0>(static_cast<std::uint32_t>(_mm256_movemask_epi8(ctrl)));
+    }
+};
+#elif defined(MIB_FLAT_HASH_SSE2)
+struct group
+{
+    static constexpr std::size_t width = 16;
+    __m128i ctrl;
+
+    explicit group(const ctrl_t* p) noexcept : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    bitmask<0> match(const ctrl_t h2) const noexcept
+    {
+        return bitmask<0>(static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+    }
+
+    bitmask<0> match_empty() const noexcept
+    {
+        return match(ctrl_empty);
+    }
+
+    bitmask<0> match_empty_or_deleted() const noexcept
+    {
+        return bitmask<0>(static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl)));
+    }
+};
+#else
+struct group
+{
+    static constexpr std::size_t width = 8;
+    static constexpr std::uint64_t lsbs = 0x0101010101010101ull;
+    static constexpr std::uint64_t msbs = 0x8080808080808080ull;
+    std::uint64_t ctrl = 0;
+
+    explicit group(const ctrl_t* p) noexcept
+    {
+        for (std::size_t i = 0; i < width; ++i)
+        {
+            ctrl |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(p[i])) << (8 * i);
+        }
+    }
+
+    bitmask<3> match(const ctrl_t h2) const noexcept
+    {
+        const std::uint64_t x = ctrl ^ (lsbs * static_cast<std::uint8_t>(h2));
+        return bitmask<3>((x - lsbs) & ~x & msbs);
+    }
+
+    bitmask<3> match_empty() const noexcept
+    {
+        return bitmask<3>(ctrl & (~ctrl << 6) & msbs);
+    }
+
+    bitmask<3> match_empty_or_deleted() const noexcept
+    {
+        return bitmask<3>(ctrl & msbs);
+    }
+};
+#endif
+
+inline const ctrl_t* empty_group() noexcept
+{
+    alignas(32) static const ctrl_t empty[32] = {
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty};
+    return empty;
+}
+
+inline std::uint64_t mix_hash(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+template<typename Hash, typename KeyEqual, typename Q, typename = void>
+struct is_transparent_lookup : std::false_type {};
+
+template<typename Hash, typename KeyEqual, typename Q>
+struct is_transparent_lookup<Hash, KeyEqual, Q,
+    std::void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>> : std::true_type {};
+}
+
+template<typename T>
+struct set_slot_policy
+{
+    using key_type = T;
+    using value_type = T;
+    using slot_type = T;
+
+    static const T& key(const slot_type& s) noexcept
+    {
+        return s;
+    }
+
+    template<typename... Args>
+    static void construct(slot_type* s, Args&&... args)
+    {
+        ::new (static_cast<void*>(s)) slot_type(std::forward<Args>(args)...);
+    }
+
+    static void destroy(slot_type* s) noexcept
+    {
+        s->~slot_type();
+    }
+
+    static void transfer(slot_type* dst, slot_type* src) noexcept
+    {
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(slot_type));
+        }
+        else
+        {
+            ::new (static_cast<void*>(dst)) slot_type(std::move(*src));
+            src->~slot_type();
+        }
+    }
+};
+
+template<typename K, typename V>
+struct map_slot_policy
+{
+    using key_type = K;
+    using value_type = std::pair<const K, V>;
+    using slot_type = value_type;
+
+    static const K& key(const slot_type& s) noexcept
+    {
+        return s.first;
+    }
+
+    template<typename... Args>
+    static void construct(slot_type* s, Args&&... args)
+    {
+        ::new (static_cast<void*>(s)) slot_type(std::forward<Args>(args)...);
+    }
+
+    static void destroy(slot_type* s) noexcept
+    {
+        s->~slot_type();
+    }
+
+    static void transfer(slot_type* dst, slot_type* src) noexcept
+    {
+        if constexpr (is_trivially_relocatable_v<K> && is_trivially_relocatable_v<V>)
+        {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(slot_type));
+        }
+        else
+        {
+            ::new (static_cast<void*>(dst)) slot_type(std::move(const_cast<K&>(src->first)), std::move(src->second));
+            src->~slot_type();
+        }
+    }
+};
+
+// probe_histogram[i] counts elements found in the (i + 1)-th group probed.
+struct flat_hash_stats
+{
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+    std::size_t tombstones = 0;
+    std::size_t bytes_allocated = 0;
+    double bytes_per_element = 0.0;
+    double load_factor = 0.0;
+    std::vector<std::size_t> probe_histogram;
+};
+
+template<typename Policy, typename Hash, typename KeyEqual>
+class flat_hash_table
+{
+    using ctrl_t = detail::ctrl_t;
+    using group = detail::group;
+    using slot_type = typename Policy::slot_type;
+
+    static constexpr std::size_t group_width = group::width;
+
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+
+    template<bool Const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename Policy::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        basic_iterator() = default;
+
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& o) noexcept : ctrl_(o.ctrl_), slot_(o.slot_), end_(o.end_) {}
+
+        reference operator*() const noexcept
+        {
+            return *slot_;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return slot_;
+        }
+
+        basic_iterator& operator++() noexcept
+        {
+            ++ctrl_;
+            ++slot_;
+            skip_empty();
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept
+        {
+            basic_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const basic_iterator& o) const noexcept
+        {
+            return ctrl_ == o.ctrl_;
+        }
+
+        bool operator!=(const basic_iterator& o) const noexcept
+        {
+            return ctrl_ != o.ctrl_;
+        }
+
+    private:
+        friend class flat_hash_table;
+        friend class basic_iterator<!Const>;
+
+        basic_iterator(const ctrl_t* ctrl, slot_type* slot, const ctrl_t* end) noexcept : ctrl_(ctrl), slot_(slot), end_(end)
+        {
+            skip_empty();
+        }
+
+        void skip_empty() noexcept
+        {
+            while (ctrl_ != end_ && *ctrl_ < 0)
+            {
+                ++ctrl_;
+                ++slot_;
+            }
+        }
+
+        const ctrl_t* ctrl_ = nullptr;
+        slot_type* slot_ = nullptr;
+        const ctrl_t* end_ = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_hash_table() = default;
+
+    explicit flat_hash_table(const size_type bucket_hint, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual())
+        : hash_(hash), eq_(eq)
+    {
+        reserve(bucket_hint);
+    }
+
+    flat_hash_table(const flat_hash_table& other) : hash_(other.hash_), eq_(other.eq_)
+    {
+        reserve(other.size_);
+        for (const auto& v : other)
+        {
+            const std::size_t h = hash_of(Policy::key(v));
+            const std::size_t idx = find_first_non_full(h);
+            Policy::construct(slots_ + idx, v);
+            commit_insert(idx, h);
+        }
+    }
+
+    flat_hash_table(flat_hash_table&& other) noexcept
+        : ctrl_(other.ctrl_), slots_(other.slots_), capacity_(other.capacity_), size_(other.size_)
+        , growth_left_(other.growth_left_), hash_(std::move(other.hash_)), eq_(std::move(other.eq_))
+    {
+        other.reset_empty();
+    }
+
+    flat_hash_table& operator=(flat_hash_table other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~flat_hash_table()
+    {
+        destroy_all();
+        deallocate();
+    }
+
+    void swap(flat_hash_table& other) noexcept
+    {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(ctrl_, slots_, ctrl_ + capacity_);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(ctrl_, slots_, ctrl_ + capacity_);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(ctrl_ + capacity_, slots_ + capacity_, ctrl_ + capacity_);
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    [[nodiscard]] float load_factor() const noexcept
+    {
+        return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f;
+    }
+
+    void clear() noexcept
+    {
+        destroy_all();
+        if (capacity_)
+        {
+            std::memset(ctrl_, static_cast<unsigned char>(detail::ctrl_empty), capacity_ + group_width);
+        }
+        size_ = 0;
+        growth_left_ = max_load(capacity_);
+    }
+
+    void reserve(const size_type n)
+    {
+        const size_type needed = capacity_for(n);
+        if (needed > capacity_)
+        {
+            resize(needed);
+        }
+    }
+
+    void rehash(const size_type n)
+    {
+        resize(std::max(capacity_for(size_), capacity_for(n)));
+    }
+
+    template<typename Q>
+    iterator find(const Q& key)
+    {
+        const std::size_t idx = find_index(key, hash_of(key));
+        return idx == npos ? end() : iterator_at(idx);
+    }
+
+    template<typename Q>
+    const_iterator find(const Q& key) const
+    {
+        const std::size_t idx = find_index(key, hash_of(key));
+        return idx == npos ? end() : const_iterator(ctrl_ + idx, slots_ + idx, ctrl_ + capacity_);
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const
+    {
+        return find_index(key, hash_of(key)) != npos;
+    }
+
+    // Hashes once; args are only used to construct the slot when key is absent.
+    template<typename Q, typename... Args>
+    std::pair<iterator, bool> emplace_key(const Q& key, Args&&... args)
+    {
+        const std::size_t h = hash_of(key);
+        const std::size_t found = find_index(key, h);
+
+        if (found != npos)
+        {
+            return {iterator_at(found), false};
+        }
+
+        std::size_t idx = capacity_ ? find_first_non_full(h) : 0;
+        if (growth_left_ == 0 && (capacity_ == 0 || ctrl_[idx] != detail::ctrl_deleted))
+        {
+            // The arguments may refer to elements of this table, so the value is built
+            // before grow() frees the old slots and moved in afterwards.
+            alignas(slot_type) unsigned char staged[sizeof(slot_type)];
+            auto* value = reinterpret_cast<slot_type*>(staged);
+            Policy::construct(value, std::forward<Args>(args)...);
+            try
+            {
+                grow();
+            }
+            catch (...)
+            {
+                Policy::destroy(value);
+                throw;
+            }
+            idx = find_first_non_full(h);
+            Policy::transfer(slots_ + idx, value);
+            commit_insert(idx, h);
+            return {iterator_at(idx), true};
+        }
+
+        Policy::construct(slots_ + idx, std::forward<Args>(args)...);
+        commit_insert(idx, h);
+        return {iterator_at(idx), true};
+    }
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        const std::size_t idx = static_cast<std::size_t>(pos.ctrl_ - ctrl_);
+        erase_at(idx);
+        return iterator_at(idx + 1);
+    }
+
+    template<typename Q>
+    size_type erase_key(const Q& key)
+    {
+        const std::size_t idx = find_index(key, hash_of(key));
+        if (idx == npos)
+        {
+            return 0;
+        }
+        erase_at(idx);
+        return 1;
+    }
+
+    flat_hash_stats stats() const
+    {
+        flat_hash_stats st;
+        st.size = size_;
+        st.capacity = capacity_;
+        st.bytes_allocated = capacity_ ? ctrl_offset(capacity_) + capacity_ + group_width : 0;
+        st.bytes_per_element = size_ ? static_cast<double>(st.bytes_allocated) / static_cast<double>(size_) : 0.0;
+        st.load_factor = load_factor();
+
+        const std::size_t mask = capacity_ ? capacity_ - 1 : 0;
+        for (std::size_t i = 0; i < capacity_; ++i)
+        {
+            if (ctrl_[i] == detail::ctrl_deleted)
+            {
+                ++st.tombstones;
+                continue;
+            }
+            if (ctrl_[i] < 0)
+            {
+                continue;
+            }
+
+            std::size_t pos = h1(hash_of(Policy::key(slots_[i]))) & mask;
+            std::size_t step = 0;
+            std::size_t probes = 0;
+            while (((i - pos) & mask) >= group_width)
+            {
+                step += group_width;
+                pos = (pos + step) & mask;
+                ++probes;
+            }
+
+            if (st.probe_histogram.size() <= probes)
+            {
+                st.probe_histogram.resize(probes + 1);
+            }
+            ++st.probe_histogram[probes];
+        }
+        return st;
+    }
+
+    const hasher& hash_function() const noexcept
+    {
+        return hash_;
+    }
+
+    const key_equal& key_eq() const noexcept
+    {
+        return eq_;
+    }
+
+private:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    static size_type max_load(const size_type cap) noexcept
+    {
+        return cap - cap / 8;
+    }
+
+    static size_type capacity_for(const size_type n) noexcept
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+
+        const size_type min_slots = n + n / 7 + 1;
+        size_type cap = group_width;
+        while (cap < min_slots)
+        {
+            cap *= 2;
+        }
+        return cap;
+    }
+
+    template<typename Q>
+    std::size_t hash_of(const Q& key) const
+    {
+        return static_cast<std::size_t>(detail::mix_hash(static_cast<std::uint64_t>(hash_(key))));
+    }
+
+    static ctrl_t h2(const std::size_t h) noexcept
+    {
+        return static_cast<ctrl_t>(h & 0x7F);
+    }
+
+    static std::size_t h1(const std::size_t h) noexcept
+    {
+        return h >> 7;
+    }
+
+    iterator iterator_at(const std::size_t idx) noexcept
+    {
+        return iterator(ctrl_ + idx, slots_ + idx, ctrl_ + capacity_);
+    }
+
+    template<typename Q>
+    std::size_t find_index(const Q& key, const std::size_t h) const
+    {
+        const std::size_t mask = capacity_ ? capacity_ - 1 : 0;
+        std::size_t pos = h1(h) & mask;
+        std::size_t step = 0;
+
+        while (true)
+        {
+            const group g(ctrl_ + pos);
+
+            for (auto m = g.match(h2(h)); m; m.clear_lowest())
+            {
+                const std::size_t idx = (pos + m.lowest()) & mask;
+                if (eq_(Policy::key(slots_[idx]), key))
+                {
+                    return idx;
+                }
+            }
+
+            if (g.match_empty())
+            {
+                return npos;
+            }
+
+            step += group_width;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    std::size_t find_first_non_full(const std::size_t h) const noexcept
+    {
+        const std::size_t mask = capacity_ - 1;
+        std::size_t pos = h1(h) & mask;
+        std::size_t step = 0;
+
+        while (true)
+        {
+            const group g(ctrl_ + pos);
+            if (auto m = g.match_empty_or_deleted())
+            {
+                return (pos + m.lowest()) & mask;
+            }
+
+            step += group_width;
+            pos = (pos + step) & mask;
+        }
+    }
+
+    void set_ctrl(const std::size_t idx, const ctrl_t c) noexcept
+    {
+        ctrl_[idx] = c;
+        if (idx < group_width)
+        {
+            ctrl_[capacity_ + idx] = c;
+        }
+    }
+
+    void commit_insert(const std::size_t idx, const std::size_t h) noexcept
+    {
+        if (ctrl_[idx] == detail::ctrl_empty)
+        {
+            --growth_left_;
+        }
+        set_ctrl(idx, h2(h));
+        ++size_;
+    }
+
+    void erase_at(const std::size_t idx) noexcept
+    {
+        Policy::destroy(slots_ + idx);
+        set_ctrl(idx, detail::ctrl_deleted);
+        --size_;
+    }
+
+    void grow()
+    {
+        if (capacity_ == 0)
+        {
+            resize(group_width);
+        }
+        else if (size_ * 32 <= capacity_ * 25)
+        {
+            resize(capacity_);
+        }
+        else
+        {
+            resize(capacity_ * 2);
+        }
+    }
+
+    static constexpr std::size_t slot_align = alignof(slot_type) > alignof(std::max_align_t) ? alignof(slot_type) : alignof(std::max_align_t);
+
+    static std::size_t ctrl_offset(const std::size_t cap) noexcept
+    {
+        return cap * sizeof(slot_type);
+    }
+
+    void resize(const size_type new_cap)
+    {
+        void* block = ::operator new(ctrl_offset(new_cap) + new_cap + group_width, std::align_val_t(slot_align));
+        auto* new_slots = static_cast<slot_type*>(block);
+        auto* new_ctrl = reinterpret_cast<ctrl_t*>(static_cast<char*>(block) + ctrl_offset(new_cap));
+        std::memset(new_ctrl, static_cast<unsigned char>(detail::ctrl_empty), new_cap + group_width);
+
+        ctrl_t* old_ctrl = ctrl_;
+        slot_type* old_slots = slots_;
+        const size_type old_cap = capacity_;
+
+        ctrl_ = new_ctrl;
+        slots_ = new_slots;
+        capacity_ = new_cap;
+        growth_left_ = max_load(new_cap) - size_;
+
+        for (size_type i = 0; i < old_cap; ++i)
+        {
+            if (old_ctrl[i] >= 0)
+            {
+                const std::size_t h = hash_of(Policy::key(old_slots[i]));
+                const std::size_t idx = find_first_non_full(h);
+                Policy::transfer(slots_ + idx, old_slots + i);
+                set_ctrl(idx, h2(h));
+            }
+        }
+
+        if (old_cap)
+        {
+            ::operator delete(old_slots, std::align_val_t(slot_align));
+        }
+    }
+
+    void destroy_all() noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<slot_type>)
+        {
+            for (size_type i = 0; i < capacity_; ++i)
+            {
+                if (ctrl_[i] >= 0)
+                {
+                    Policy::destroy(slots_ + i);
+                }
+            }
+        }
+    }
+
+    void deallocate() noexcept
+    {
+        if (capacity_)
+        {
+            ::operator delete(slots_, std::align_val_t(slot_align));
+        }
+        reset_empty();
+    }
+
+    void reset_empty() noexcept
+    {
+        ctrl_ = const_cast<ctrl_t*>(detail::empty_group());
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        growth_left_ = 0;
+    }
+
+    ctrl_t* ctrl_ = const_cast<ctrl_t*>(detail::empty_group());
+    slot_type* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growth_left_ = 0;
+    Hash hash_;
+    KeyEqual eq_;
+};
+}
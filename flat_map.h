@@ -1,32 +1,201 @@
 #pragma once
 #include <vector>
+#include <utility>
+#include <iterator>
 #include <algorithm>
+#include <functional>
+#include <initializer_list>
 
-template<typename K, typename V>
+#include "sorted_unique.h"
+
+template<typename K, typename V, typename Compare = std::less<K>>
 class flat_map
 {
 public:
-    void insert(const K& k, const V& v)
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using container_type = std::vector<value_type>;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    flat_map() = default;
+
+    explicit flat_map(const Compare& comp) : comp_(comp) {}
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    flat_map(InputIt first, InputIt last, const Compare& comp = Compare()) : comp_(comp)
+    {
+        insert(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> init, const Compare& comp = Compare()) : comp_(comp)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    flat_map(mib::sorted_unique_t, container_type data, const Compare& comp = Compare()) : data_(std::move(data)), comp_(comp) {}
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    flat_map(mib::sorted_unique_t, InputIt first, InputIt last, const Compare& comp = Compare()) : data_(first, last), comp_(comp) {}
+
+    std::pair<iterator, bool> insert(const K& k, const V& v)
     {
-        data_.emplace_back(k,v);
-        std::sort(data_.begin(), data_.end(), [](auto &a, auto &b)
+        auto it = lower_bound(k);
+        if (it != data_.end() && !comp_(k, it->first))
         {
-            return a.first < b.first;
-        });
+            it->second = v;
+            return {it, false};
+        }
+        return {data_.emplace(it, k, v), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& kv)
+    {
+        return insert(kv.first, kv.second);
+    }
+
+    // Later duplicates win, matching a sequence of single inserts.
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last)
+    {
+        const size_type old_size = data_.size();
+        data_.insert(data_.end(), first, last);
+
+        const auto by_key = [this](const value_type& a, const value_type& b)
+        {
+            return comp_(a.first, b.first);
+        };
+
+        const auto mid = data_.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::stable_sort(mid, data_.end(), by_key);
+        std::inplace_merge(data_.begin(), mid, data_.end(), by_key);
+        dedupe_keep_last();
+    }
+
+    void insert(std::initializer_list<value_type> init)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    V& operator[](const K& k)
+    {
+        auto it = lower_bound(k);
+        if (it == data_.end() || comp_(k, it->first))
+        {
+            it = data_.emplace(it, k, V());
+        }
+        return it->second;
     }
 
     V* find(const K& k)
     {
-        auto it = std::lower_bound(data_.begin(), data_.end(), k, [](auto &a, const K& val)
+        auto it = lower_bound(k);
+        if (it != data_.end() && !comp_(k, it->first))
         {
-            return a.first < val;
-        });
-        if (it != data_.end() && it->first==k)
+            return &it->second;
+        }
+        return nullptr;
+    }
+
+    const V* find(const K& k) const
+    {
+        auto it = lower_bound(k);
+        if (it != data_.end() && !comp_(k, it->first))
         {
             return &it->second;
         }
         return nullptr;
     }
+
+    bool contains(const K& k) const
+    {
+        return find(k) != nullptr;
+    }
+
+    iterator lower_bound(const K& k)
+    {
+        return std::lower_bound(data_.begin(), data_.end(), k, [this](const value_type& a, const K& val)
+        {
+            return comp_(a.first, val);
+        });
+    }
+
+    const_iterator lower_bound(const K& k) const
+    {
+        return std::lower_bound(data_.begin(), data_.end(), k, [this](const value_type& a, const K& val)
+        {
+            return comp_(a.first, val);
+        });
+    }
+
+    size_type erase(const K& k)
+    {
+        auto it = lower_bound(k);
+        if (it == data_.end() || comp_(k, it->first))
+        {
+            return 0;
+        }
+        data_.erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return data_.erase(pos);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        return data_.erase(first, last);
+    }
+
+    iterator begin() noexcept { return data_.begin(); }
+    const_iterator begin() const noexcept { return data_.begin(); }
+    iterator end() noexcept { return data_.end(); }
+    const_iterator end() const noexcept { return data_.end(); }
+
+    [[nodiscard]] size_type size() const noexcept { return data_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+    void reserve(const size_type n) { data_.reserve(n); }
+    void clear() noexcept { data_.clear(); }
+
+    key_compare key_comp() const { return comp_; }
+
+    // Hands the sorted storage back, leaving the map empty.
+    container_type extract() &&
+    {
+        container_type out = std::move(data_);
+        data_.clear();
+        return out;
+    }
+
 private:
-    std::vector<std::pair<K,V>> data_;
+    void dedupe_keep_last()
+    {
+        if (data_.size() < 2)
+        {
+            return;
+        }
+
+        auto out = data_.begin();
+        for (auto it = data_.begin() + 1; it != data_.end(); ++it)
+        {
+            if (comp_(out->first, it->first))
+            {
+                ++out;
+            }
+            if (out != it)
+            {
+                *out = std::move(*it);
+            }
+        }
+        data_.erase(out + 1, data_.end());
+    }
+
+    container_type data_;
+    Compare comp_;
 };
@@ -1,20 +1,130 @@
 #pragma once
 #include <vector>
+#include <utility>
+#include <iterator>
 #include <algorithm>
+#include <functional>
+#include <initializer_list>
 
-template<typename T>
+#include "sorted_unique.h"
+
+template<typename T, typename Compare = std::less<T>>
 class flat_set
 {
 public:
-    void insert(const T& v)
+    using key_type = T;
+    using value_type = T;
+    using container_type = std::vector<T>;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+    using iterator = typename container_type::const_iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    flat_set() = default;
+
+    explicit flat_set(const Compare& comp) : comp_(comp) {}
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    flat_set(InputIt first, InputIt last, const Compare& comp = Compare()) : comp_(comp)
     {
-        data_.push_back(v);
-        std::sort(data_.begin(), data_.end());
+        insert(first, last);
     }
+
+    flat_set(std::initializer_list<T> init, const Compare& comp = Compare()) : comp_(comp)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    flat_set(mib::sorted_unique_t, container_type data, const Compare& comp = Compare()) : data_(std::move(data)), comp_(comp) {}
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    flat_set(mib::sorted_unique_t, InputIt first, InputIt last, const Compare& comp = Compare()) : data_(first, last), comp_(comp) {}
+
+    std::pair<iterator, bool> insert(const T& v)
+    {
+        auto it = lower_bound(v);
+        if (it != data_.end() && !comp_(v, *it))
+        {
+            return {it, false};
+        }
+        return {data_.insert(it, v), true};
+    }
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void insert(InputIt first, InputIt last)
+    {
+        const size_type old_size = data_.size();
+        data_.insert(data_.end(), first, last);
+
+        const auto mid = data_.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::sort(mid, data_.end(), comp_);
+        std::inplace_merge(data_.begin(), mid, data_.end(), comp_);
+        data_.erase(std::unique(data_.begin(), data_.end(), [this](const T& a, const T& b)
+        {
+            return !comp_(a, b);
+        }), data_.end());
+    }
+
+    void insert(std::initializer_list<T> init)
+    {
+        insert(init.begin(), init.end());
+    }
+
     bool contains(const T& v) const
     {
-        return std::binary_search(data_.begin(), data_.end(), v);
+        auto it = lower_bound(v);
+        return it != data_.end() && !comp_(v, *it);
+    }
+
+    const_iterator find(const T& v) const
+    {
+        auto it = lower_bound(v);
+        return it != data_.end() && !comp_(v, *it) ? it : data_.end();
+    }
+
+    const_iterator lower_bound(const T& v) const
+    {
+        return std::lower_bound(data_.begin(), data_.end(), v, comp_);
+    }
+
+    size_type erase(const T& v)
+    {
+        auto it = lower_bound(v);
+        if (it == data_.end() || comp_(v, *it))
+        {
+            return 0;
+        }
+        data_.erase(it);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return data_.erase(pos);
     }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        return data_.erase(first, last);
+    }
+
+    const_iterator begin() const noexcept { return data_.begin(); }
+    const_iterator end() const noexcept { return data_.end(); }
+
+    [[nodiscard]] size_type size() const noexcept { return data_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return data_.empty(); }
+
+    void reserve(const size_type n) { data_.reserve(n); }
+    void clear() noexcept { data_.clear(); }
+
+    container_type extract() &&
+    {
+        container_type out = std::move(data_);
+        data_.clear();
+        return out;
+    }
+
 private:
-    std::vector<T> data_;
+    container_type data_;
+    Compare comp_;
 };
@@ -0,0 +1,144 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+
+#include "flat_map.h"
+
+// Read-only flat_map: keys are stored in Eytzinger (BFS) order, 1-based, so the
+// first levels of every search share cache lines and the next lines can be
+// prefetched. Values live in a parallel array and are only touched on a hit.
+template<typename K, typename V, typename Compare = std::less<K>>
+class frozen_flat_map
+{
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+    using key_compare = Compare;
+
+    frozen_flat_map() = default;
+
+    explicit frozen_flat_map(flat_map<K, V, Compare>&& source) : comp_(source.key_comp())
+    {
+        auto sorted = std::move(source).extract();
+        const size_type n = sorted.size();
+
+        keys_.resize(n + 1);
+        values_.resize(n + 1);
+
+        size_type next = 0;
+        fill(sorted, next, 1);
+    }
+
+    explicit frozen_flat_map(const flat_map<K, V, Compare>& source)
+        : frozen_flat_map(flat_map<K, V, Compare>(source))
+    {}
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return keys_.empty() ? 0 : keys_.size() - 1;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    const V* find(const K& k) const
+    {
+        const size_type i = lower_bound_index(k);
+        return i != 0 && !comp_(k, keys_[i]) ? &values_[i] : nullptr;
+    }
+
+    bool contains(const K& k) const
+    {
+        return find(k) != nullptr;
+    }
+
+    // Smallest key not less than k, or nullptr.
+    const K* lower_bound_key(const K& k) const
+    {
+        const size_type i = lower_bound_index(k);
+        return i != 0 ? &keys_[i] : nullptr;
+    }
+
+    template<typename F>
+    void for_each(F&& f) const
+    {
+        visit(1, f);
+    }
+
+private:
+    static constexpr size_type keys_per_line = sizeof(K) < 64 ? 64 / sizeof(K) : 1;
+
+    size_type lower_bound_index(const K& k) const
+    {
+        const size_type n = size();
+        size_type i = 1;
+
+        while (i <= n)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(keys_.data() + i * keys_per_line);
+#endif
+            i = 2 * i + static_cast<size_type>(comp_(keys_[i], k));
+        }
+
+        // Undo the trailing right turns plus the final left turn.
+        return i >> (countr_one(i) + 1);
+    }
+
+    static int countr_one(const size_type x) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(~static_cast<unsigned long long>(x));
+#else
+        int n = 0;
+        for (size_type v = x; v & 1; v >>= 1)
+        {
+            ++n;
+        }
+        return n;
+#endif
+    }
+
+    void fill(std::vector<std::pair<K, V>>& sorted, size_type& next, const size_type i)
+    {
+        if (i >= keys_.size())
+        {
+            return;
+        }
+
+        fill(sorted, next, 2 * i);
+        keys_[i] = std::move(sorted[next].first);
+        values_[i] = std::move(sorted[next].second);
+        ++next;
+        fill(sorted, next, 2 * i + 1);
+    }
+
+    template<typename F>
+    void visit(const size_type i, F& f) const
+    {
+        if (i >= keys_.size())
+        {
+            return;
+        }
+
+        visit(2 * i, f);
+        f(keys_[i], values_[i]);
+        visit(2 * i + 1, f);
+    }
+
+    std::vector<K> keys_;
+    std::vector<V> values_;
+    Compare comp_;
+};
+
+template<typename K, typename V, typename Compare>
+frozen_flat_map<K, V, Compare> freeze(flat_map<K, V, Compare>&& m)
+{
+    return frozen_flat_map<K, V, Compare>(std::move(m));
+}
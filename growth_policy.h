@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+
+namespace mib
+{
+struct growth_factor_2
+{
+    static std::size_t next_capacity(const std::size_t current, const std::size_t required, std::size_t /*elem_size*/) noexcept
+    {
+        const std::size_t doubled = current > std::numeric_limits<std::size_t>::max() / 2
+            ? std::numeric_limits<std::size_t>::max()
+            : current * 2;
+
+        return std::max<std::size_t>({doubled, required, 1});
+    }
+};
+
+struct growth_factor_1_5
+{
+    static std::size_t next_capacity(const std::size_t current, const std::size_t required, std::size_t /*elem_size*/) noexcept
+    {
+        const std::size_t grown = current > std::numeric_limits<std::size_t>::max() - current / 2
+            ? std::numeric_limits<std::size_t>::max()
+            : current + current / 2;
+
+        return std::max<std::size_t>({grown, required, 4});
+    }
+};
+
+// Rounds buffers larger than a page up to whole pages so the tail is not wasted.
+template<typename Base = growth_factor_2, std::size_t PageSize = 4096>
+struct page_rounded_growth
+{
+    static_assert((PageSize & (PageSize - 1)) == 0, "page size must be a power of two");
+
+    static std::size_t next_capacity(const std::size_t current, const std::size_t required, const std::size_t elem_size) noexcept
+    {
+        const std::size_t cap = Base::next_capacity(current, required, elem_size);
+
+        if (elem_size == 0 || cap > std::numeric_limits<std::size_t>::max() / elem_size)
+        {
+            return cap;
+        }
+
+        const std::size_t bytes = cap * elem_size;
+        if (bytes < PageSize || bytes > std::numeric_limits<std::size_t>::max() - (PageSize - 1))
+        {
+            return cap;
+        }
+
+        const std::size_t rounded = (bytes + PageSize - 1) & ~(PageSize - 1);
+        return rounded / elem_size;
+    }
+};
+
+using default_growth = growth_factor_2;
+}
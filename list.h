@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <iterator>
@@ -8,7 +9,7 @@
 #include <limits>
 #include <initializer_list>
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>>
 class list
 {
     struct Node
@@ -18,13 +19,24 @@ class list
         Node* next;
         explicit Node(const T& v, Node* p=nullptr, Node* n=nullptr)
             : value(v), prev(p), next(n) {}
+        explicit Node(T&& v, Node* p=nullptr, Node* n=nullptr)
+            : value(std::move(v)), prev(p), next(n) {}
     };
+
+    using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_alloc_traits = std::allocator_traits<node_allocator_type>;
+
     Node* head;
     Node* tail;
     size_t size_of_list;
+    node_allocator_type node_alloc_;
+
+    template<class... Args>
+    Node* create_node(Args&&... args);
+    void destroy_node(Node* n) noexcept;
 public:
     using value_type = T;
-    using allocator_type = std::allocator<T>;
+    using allocator_type = Allocator;
     using size_type = std::size_t;
     using reference = T&;
     using const_reference = const T&;
@@ -139,6 +151,7 @@ public:
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
     list();
+    explicit list(const Allocator& alloc);
     explicit list(size_t size);
     list(const list& other);
     list(list&& other) noexcept;
@@ -215,23 +228,33 @@ public:
     const_reverse_iterator rend() const noexcept;
 
     void swap (list& x) noexcept;
+    allocator_type get_allocator() const noexcept;
     ~list() noexcept;
 };
 
-template<typename T>
-list<T>::const_iterator::const_iterator(const iterator& it) noexcept : current(it.current) {}
+template<typename T, typename Allocator>
+list<T, Allocator>::const_iterator::const_iterator(const iterator& it) noexcept : current(it.current) {}
 
 
-template<typename T>
-list<T>::list()
+template<typename T, typename Allocator>
+list<T, Allocator>::list()
 {
     this->head = nullptr;
     this->tail = nullptr;
     this->size_of_list = 0;
 }
 
-template<typename T>
-list<T>::list(const size_t size)
+template<typename T, typename Allocator>
+list<T, Allocator>::list(const Allocator& alloc)
+    : node_alloc_(alloc)
+{
+    this->head = nullptr;
+    this->tail = nullptr;
+    this->size_of_list = 0;
+}
+
+template<typename T, typename Allocator>
+list<T, Allocator>::list(const size_t size)
 {
     this->head = nullptr;
     this->tail = nullptr;
@@ -240,8 +263,9 @@ list<T>::list(const size_t size)
     this->assign(size, T());
 }
 
-template<typename T>
-list<T>::list(const list &other)
+template<typename T, typename Allocator>
+list<T, Allocator>::list(const list &other)
+    : node_alloc_(node_alloc_traits::select_on_container_copy_construction(other.node_alloc_))
 {
     this->head = nullptr;
     this->tail = nullptr;
@@ -250,8 +274,9 @@ list<T>::list(const list &other)
     assign(other);
 }
 
-template<typename T>
-list<T>::list(list &&other) noexcept
+template<typename T, typename Allocator>
+list<T, Allocator>::list(list &&other) noexcept
+    : node_alloc_(std::move(other.node_alloc_))
 {
     this->head = nullptr;
     this->tail = nullptr;
@@ -268,8 +293,8 @@ list<T>::list(list &&other) noexcept
     other.size_of_list = 0;
 }
 
-template<typename T>
-list<T>::list(std::initializer_list<T> init)
+template<typename T, typename Allocator>
+list<T, Allocator>::list(std::initializer_list<T> init)
 {
     this->head = nullptr;
     this->tail = nullptr;
@@ -278,8 +303,8 @@ list<T>::list(std::initializer_list<T> init)
     assign(init);
 }
 
-template<typename T>
-list<T> & list<T>::operator=(const list &other)
+template<typename T, typename Allocator>
+list<T, Allocator> & list<T, Allocator>::operator=(const list &other)
 {
     if (this == &other) 
     {
@@ -288,6 +313,11 @@ list<T> & list<T>::operator=(const list &other)
 
     clear();
 
+    if constexpr (node_alloc_traits::propagate_on_container_copy_assignment::value)
+    {
+        node_alloc_ = other.node_alloc_;
+    }
+
     for (Node* cur = other.head; cur; cur = cur->next)
     {
         push_back(cur->value);
@@ -295,13 +325,18 @@ list<T> & list<T>::operator=(const list &other)
     return *this;
 }
 
-template<typename T>
-list<T> & list<T>::operator=(list &&other) noexcept
+template<typename T, typename Allocator>
+list<T, Allocator> & list<T, Allocator>::operator=(list &&other) noexcept
 {
     if (this == &other) return *this;
 
     clear();
 
+    if constexpr (node_alloc_traits::propagate_on_container_move_assignment::value)
+    {
+        node_alloc_ = std::move(other.node_alloc_);
+    }
+
     head = other.head;
     tail = other.tail;
 
@@ -312,8 +347,8 @@ list<T> & list<T>::operator=(list &&other) noexcept
     return *this;
 }
 
-template<typename T>
-void list<T>::assign(const list& other)
+template<typename T, typename Allocator>
+void list<T, Allocator>::assign(const list& other)
 {
     if (this == &other)
     {
@@ -327,8 +362,8 @@ void list<T>::assign(const list& other)
     }
 }
 
-template<typename T>
-void list<T>::assign(list &&other) noexcept
+template<typename T, typename Allocator>
+void list<T, Allocator>::assign(list &&other) noexcept
 {
     if (this != &other)
     {
@@ -344,8 +379,8 @@ void list<T>::assign(list &&other) noexcept
     }
 }
 
-template<typename T>
-void list<T>::assign(std::initializer_list<T> init)
+template<typename T, typename Allocator>
+void list<T, Allocator>::assign(std::initializer_list<T> init)
 {
     clear();
     for (const T& v : init) 
@@ -354,8 +389,8 @@ void list<T>::assign(std::initializer_list<T> init)
     }
 }
 
-template<typename T>
-void list<T>::assign(const size_t size, const T &value)
+template<typename T, typename Allocator>
+void list<T, Allocator>::assign(const size_t size, const T &value)
 {
     clear();
     for (size_t i = 0; i < size; ++i) 
@@ -364,8 +399,8 @@ void list<T>::assign(const size_t size, const T &value)
     }
 }
 
-template<typename T>
-void list<T>::assign(T *first, T *last)
+template<typename T, typename Allocator>
+void list<T, Allocator>::assign(T *first, T *last)
 {
     clear();
     for (T* p = first; p != last; ++p) 
@@ -374,8 +409,8 @@ void list<T>::assign(T *first, T *last)
     }
 }
 
-template<typename T>
-T & list<T>::back()
+template<typename T, typename Allocator>
+T & list<T, Allocator>::back()
 {
     if (size_of_list == 0)
     {
@@ -384,8 +419,8 @@ T & list<T>::back()
     return tail->value;
 }
 
-template<typename T>
-const T &list<T>::back() const
+template<typename T, typename Allocator>
+const T &list<T, Allocator>::back() const
 {
     if (size_of_list == 0)
     {
@@ -394,44 +429,44 @@ const T &list<T>::back() const
     return tail->value;
 }
 
-template<typename T>
-typename list<T>::iterator list<T>::begin() noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::iterator list<T, Allocator>::begin() noexcept
 {
     return iterator(head);
 }
 
-template<typename T>
-typename list<T>::const_iterator list<T>::begin() const noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_iterator list<T, Allocator>::begin() const noexcept
 {
     return const_iterator(head);
 }
 
-template<typename T>
-typename list<T>::const_iterator list<T>::cbegin() const noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_iterator list<T, Allocator>::cbegin() const noexcept
 {
     return const_iterator(head);
 }
 
-template<typename T>
-typename list<T>::const_iterator list<T>::cend() const noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_iterator list<T, Allocator>::cend() const noexcept
 {
     return const_iterator(nullptr);
 }
 
-template<typename T>
-typename list<T>::size_type list<T>::size() const noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::size_type list<T, Allocator>::size() const noexcept
 {
     return size_of_list;
 }
 
-template<typename T>
-typename list<T>::size_type list<T>::max_size() noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::size_type list<T, Allocator>::max_size() noexcept
 {
     return std::numeric_limits<size_t>::max();
 }
 
-template<typename T>
-void list<T>::resize(const size_t n, const T& val)
+template<typename T, typename Allocator>
+void list<T, Allocator>::resize(const size_t n, const T& val)
 {
     while (size_of_list > n)
     {
@@ -443,44 +478,44 @@ void list<T>::resize(const size_t n, const T& val)
     }
 }
 
-template<typename T>
-list<T>::~list() noexcept
+template<typename T, typename Allocator>
+list<T, Allocator>::~list() noexcept
 {
     Node* cur = head;
     while (cur)
     {
         Node* next = cur->next;
-        delete cur;
+        destroy_node(cur);
         cur = next;
     }
     head = tail = nullptr;
     size_of_list = 0;
 }
 
-template<typename T>
-void list<T>::clear() noexcept
+template<typename T, typename Allocator>
+void list<T, Allocator>::clear() noexcept
 {
     Node* cur = head;
     while (cur)
     {
         Node* next = cur->next;
-        delete cur;
+        destroy_node(cur);
         cur = next;
     }
     head = tail = nullptr;
     size_of_list = 0;
 }
 
-template<typename T>
-bool list<T>::empty() const noexcept 
+template<typename T, typename Allocator>
+bool list<T, Allocator>::empty() const noexcept 
 { 
     return size_of_list == 0; 
 }
 
-template<typename T>
-void list<T>::push_back(const T& val)
+template<typename T, typename Allocator>
+void list<T, Allocator>::push_back(const T& val)
 {
-    Node* n = new Node(val, tail, nullptr);
+    Node* n = create_node(val, tail, nullptr);
 
     if (!head) 
     {
@@ -495,16 +530,16 @@ void list<T>::push_back(const T& val)
     ++size_of_list;
 }
 
-template<typename T>
-void list<T>::push_back(T&& val)
+template<typename T, typename Allocator>
+void list<T, Allocator>::push_back(T&& val)
 {
-    push_back(std::move(val));
+    emplace_back(std::move(val));
 }
 
-template<typename T>
-void list<T>::push_front(const T& val)
+template<typename T, typename Allocator>
+void list<T, Allocator>::push_front(const T& val)
 {
-    Node* n = new Node(val, nullptr, head);
+    Node* n = create_node(val, nullptr, head);
 
     if (!tail) 
     {
@@ -519,21 +554,21 @@ void list<T>::push_front(const T& val)
     ++size_of_list;
 }
 
-template<typename T>
-void list<T>::push_front(T&& val)
+template<typename T, typename Allocator>
+void list<T, Allocator>::push_front(T&& val)
 {
-    push_front(std::move(val));
+    emplace_front(std::move(val));
 }
 
-template<typename T>
-void list<T>::pop_back()
+template<typename T, typename Allocator>
+void list<T, Allocator>::pop_back()
 {
     if (!tail) 
     {
         return;
     }
 
-    const Node* p = tail;
+    Node* p = tail;
     tail = tail->prev;
 
     if (tail) 
@@ -545,19 +580,19 @@ void list<T>::pop_back()
         head = nullptr;
     }
 
-    delete p;
+    destroy_node(p);
     --size_of_list;
 }
 
-template<typename T>
-void list<T>::pop_front()
+template<typename T, typename Allocator>
+void list<T, Allocator>::pop_front()
 {
     if (!head)
     {
         return;
     }
 
-    const Node* p = head;
+    Node* p = head;
     head = head->next;
     if (head)
     {
@@ -568,24 +603,24 @@ void list<T>::pop_front()
         tail = nullptr;
     }
 
-    delete p;
+    destroy_node(p);
     --size_of_list;
 }
 
-template<typename T>
-typename list<T>::iterator list<T>::end() noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::iterator list<T, Allocator>::end() noexcept
 {
     return iterator(nullptr);
 }
 
-template<typename T>
-typename list<T>::const_iterator list<T>::end() const noexcept
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_iterator list<T, Allocator>::end() const noexcept
 {
     return const_iterator(nullptr);
 }
 
-template<typename T>
-T& list<T>::front()
+template<typename T, typename Allocator>
+T& list<T, Allocator>::front()
 {
     if (!head)
     {
@@ -594,8 +629,8 @@ T& list<T>::front()
     return head->value;
 }
 
-template<typename T>
-const T& list<T>::front() const 
+template<typename T, typename Allocator>
+const T& list<T, Allocator>::front() const 
 { 
     if (!head) 
     {
@@ -604,8 +639,8 @@ const T& list<T>::front() const
     return head->value; 
 }
 
-template<typename T>
-typename list<T>::iterator list<T>::erase(const_iterator pos)
+template<typename T, typename Allocator>
+typename list<T, Allocator>::iterator list<T, Allocator>::erase(const_iterator pos)
 {
     if (!pos.current) 
     {
@@ -631,13 +666,13 @@ typename list<T>::iterator list<T>::erase(const_iterator pos)
         tail = n->prev;
     }
 
-    delete n;
+    destroy_node(n);
     --size_of_list;
     return iterator(next);
 }
 
-template<typename T>
-typename list<T>::iterator list<T>::erase(const_iterator first, const_iterator last)
+template<typename T, typename Allocator>
+typename list<T, Allocator>::iterator list<T, Allocator>::erase(const_iterator first, const_iterator last)
 {
     auto it = first;
     while (it != last)
@@ -647,8 +682,8 @@ typename list<T>::iterator list<T>::erase(const_iterator first, const_iterator l
     return iterator(last.current);
 }
 
-template<typename T>
-typename list<T>::iterator list<T>::insert(const_iterator position, const T& val)
+template<typename T, typename Allocator>
+typename list<T, Allocator>::iterator list<T, Allocator>::insert(const_iterator position, const T& val)
 {
     if (!position.current)
     {
@@ -657,7 +692,7 @@ typename list<T>::iterator list<T>::insert(const_iterator position, const T& val
     }
 
     Node* cur = const_cast<Node*>(position.current);
-    Node* n = new Node(val, cur->prev, cur);
+    Node* n = create_node(val, cur->prev, cur);
 
     if (cur->prev)
     {
@@ -673,8 +708,8 @@ typename list<T>::iterator list<T>::insert(const_iterator position, const T& val
     return iterator(n);
 }
 
-template<typename T>
-typename list<T>::iterator list<T>::insert(const_iterator position, T&& val)
+template<typename T, typename Allocator>
+typename list<T, Allocator>::iterator list<T, Allocator>::insert(const_iterator position, T&& val)
 {
     if (!position.current)
     {
@@ -683,7 +718,7 @@ typename list<T>::iterator list<T>::insert(const_iterator position, T&& val)
     }
 
     Node* cur = const_cast<Node*>(position.current);
-    Node* n = new Node(std::move(val), cur->prev, cur);
+    Node* n = create_node(std::move(val), cur->prev, cur);
 
     if (cur->prev)
     {
@@ -699,9 +734,9 @@ typename list<T>::iterator list<T>::insert(const_iterator position, T&& val)
     return iterator(n);
 }
 
-template<typename T>
+template<typename T, typename Allocator>
 template<class... Args>
-typename list<T>::iterator list<T>::emplace(const_iterator position, Args&&... args)
+typename list<T, Allocator>::iterator list<T, Allocator>::emplace(const_iterator position, Args&&... args)
 {
     T tmp(std::forward<Args>(args)...);
     if (!position.current)
@@ -711,7 +746,7 @@ typename list<T>::iterator list<T>::emplace(const_iterator position, Args&&... a
     }
 
     Node* cur = const_cast<Node*>(position.current);
-    Node* n = new Node(std::move(tmp), cur->prev, cur);
+    Node* n = create_node(std::move(tmp), cur->prev, cur);
 
     if (cur->prev)
     {
@@ -727,18 +762,18 @@ typename list<T>::iterator list<T>::emplace(const_iterator position, Args&&... a
     return iterator(n);
 }
 
-template<typename T>
-void list<T>::emplace_back(const T& value) 
+template<typename T, typename Allocator>
+void list<T, Allocator>::emplace_back(const T& value) 
 { 
     push_back(value); 
 }
 
-template<typename T>
+template<typename T, typename Allocator>
 template<class... Args>
-void list<T>::emplace_back(Args&&... args)
+void list<T, Allocator>::emplace_back(Args&&... args)
 {
     T tmp(std::forward<Args>(args)...);
-    Node* n = new Node(std::move(tmp), tail, nullptr);
+    Node* n = create_node(std::move(tmp), tail, nullptr);
 
     if (!head)
     {
@@ -753,18 +788,18 @@ void list<T>::emplace_back(Args&&... args)
     ++size_of_list;
 }
 
-template<typename T>
-void list<T>::emplace_front(const T& value) 
+template<typename T, typename Allocator>
+void list<T, Allocator>::emplace_front(const T& value) 
 { 
     push_front(value); 
 }
 
-template<typename T>
+template<typename T, typename Allocator>
 template<class... Args>
-void list<T>::emplace_front(Args&&... args)
+void list<T, Allocator>::emplace_front(Args&&... args)
 {
     T tmp(std::forward<Args>(args)...);
-    Node* n = new Node(std::move(tmp), nullptr, head);
+    Node* n = create_node(std::move(tmp), nullptr, head);
 
     if (!tail)
     {
@@ -778,52 +813,87 @@ void list<T>::emplace_front(Args&&... args)
     ++size_of_list;
 }
 
-template<typename T>
-typename list<T>::const_reverse_iterator list<T>::crbegin() const noexcept 
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_reverse_iterator list<T, Allocator>::crbegin() const noexcept 
 { 
     return const_reverse_iterator(end()); 
 }
 
-template<typename T>
-typename list<T>::const_reverse_iterator list<T>::crend() const noexcept 
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_reverse_iterator list<T, Allocator>::crend() const noexcept 
 { 
     return const_reverse_iterator(begin()); 
 }
 
-template<typename T>
-typename list<T>::reverse_iterator list<T>::rbegin() noexcept 
+template<typename T, typename Allocator>
+typename list<T, Allocator>::reverse_iterator list<T, Allocator>::rbegin() noexcept 
 { 
     return reverse_iterator(end()); 
 }
 
-template<typename T>
-typename list<T>::const_reverse_iterator list<T>::rbegin() const noexcept 
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_reverse_iterator list<T, Allocator>::rbegin() const noexcept 
 { 
     return const_reverse_iterator(end()); 
 }
 
-template<typename T>
-typename list<T>::reverse_iterator list<T>::rend() noexcept 
+template<typename T, typename Allocator>
+typename list<T, Allocator>::reverse_iterator list<T, Allocator>::rend() noexcept 
 { 
     return reverse_iterator(begin()); 
 }
 
-template<typename T>
-typename list<T>::const_reverse_iterator list<T>::rend() const noexcept 
+template<typename T, typename Allocator>
+typename list<T, Allocator>::const_reverse_iterator list<T, Allocator>::rend() const noexcept 
 { 
     return const_reverse_iterator(begin()); 
 }
 
-template<typename T>
-void list<T>::swap(list& x) noexcept
+template<typename T, typename Allocator>
+void list<T, Allocator>::swap(list& x) noexcept
 {
     std::swap(head, x.head);
     std::swap(tail, x.tail);
     std::swap(size_of_list, x.size_of_list);
+
+    if constexpr (node_alloc_traits::propagate_on_container_swap::value)
+    {
+        std::swap(node_alloc_, x.node_alloc_);
+    }
+}
+
+template<typename T, typename Allocator>
+typename list<T, Allocator>::allocator_type list<T, Allocator>::get_allocator() const noexcept
+{
+    return allocator_type(node_alloc_);
+}
+
+template<typename T, typename Allocator>
+template<class... Args>
+typename list<T, Allocator>::Node* list<T, Allocator>::create_node(Args&&... args)
+{
+    Node* n = node_alloc_traits::allocate(node_alloc_, 1);
+    try
+    {
+        node_alloc_traits::construct(node_alloc_, n, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        node_alloc_traits::deallocate(node_alloc_, n, 1);
+        throw;
+    }
+    return n;
+}
+
+template<typename T, typename Allocator>
+void list<T, Allocator>::destroy_node(Node* n) noexcept
+{
+    node_alloc_traits::destroy(node_alloc_, n);
+    node_alloc_traits::deallocate(node_alloc_, n, 1);
 }
 
-template<typename T>
-void list<T>::unique()
+template<typename T, typename Allocator>
+void list<T, Allocator>::unique()
 {
     if (!head)
     {
@@ -847,7 +917,7 @@ void list<T>::unique()
                 tail = cur;
             }
 
-            delete dup;
+            destroy_node(dup);
             --size_of_list;
         }
         else
@@ -857,8 +927,8 @@ void list<T>::unique()
     }
 }
 
-template<typename T>
-void list<T>::merge(list& x)
+template<typename T, typename Allocator>
+void list<T, Allocator>::merge(list& x)
 {
     if (this == &x) 
     {
@@ -926,15 +996,15 @@ void list<T>::merge(list& x)
     x.size_of_list = 0;
 }
 
-template<typename T>
-void list<T>::merge(list&& x)
+template<typename T, typename Allocator>
+void list<T, Allocator>::merge(list&& x)
 {
     merge(x);
 }
 
-template<typename T>
+template<typename T, typename Allocator>
 template<class Compare>
-void list<T>::merge(list& x, Compare comp)
+void list<T, Allocator>::merge(list& x, Compare comp)
 {
     if (this == &x) 
     {
@@ -999,16 +1069,16 @@ void list<T>::merge(list& x, Compare comp)
     x.size_of_list = 0;
 }
 
-template<typename T>
+template<typename T, typename Allocator>
 template<class Compare>
-void list<T>::merge(list&& x, Compare comp)
+void list<T, Allocator>::merge(list&& x, Compare comp)
 {
     merge(x, comp);
 }
 
 
-template<typename T>
-void list<T>::splice(const_iterator position, list& x)
+template<typename T, typename Allocator>
+void list<T, Allocator>::splice(const_iterator position, list& x)
 {
     if (x.empty()) 
     {
@@ -1062,14 +1132,14 @@ void list<T>::splice(const_iterator position, list& x)
     size_of_list += moved;
 }
 
-template<typename T>
-void list<T>::splice(const const_iterator position, list&& x)
+template<typename T, typename Allocator>
+void list<T, Allocator>::splice(const const_iterator position, list&& x)
 {
     splice(position, x);
 }
 
-template<typename T>
-void list<T>::splice(const_iterator position, list& x, const_iterator i)
+template<typename T, typename Allocator>
+void list<T, Allocator>::splice(const_iterator position, list& x, const_iterator i)
 {
     if (!i.current) 
     {
@@ -1164,14 +1234,14 @@ void list<T>::splice(const_iterator position, list& x, const_iterator i)
     }
 }
 
-template<typename T>
-void list<T>::splice(const_iterator position, list&& x, const_iterator i)
+template<typename T, typename Allocator>
+void list<T, Allocator>::splice(const_iterator position, list&& x, const_iterator i)
 {
     splice(position, x, i);
 }
 
-template<typename T>
-void list<T>::splice(const_iterator position, list& x, const_iterator first, const_iterator last)
+template<typename T, typename Allocator>
+void list<T, Allocator>::splice(const_iterator position, list& x, const_iterator first, const_iterator last)
 {
     if (this == &x) 
     {
@@ -1273,14 +1343,14 @@ void list<T>::splice(const_iterator position, list& x, const_iterator first, con
     size_of_list += cnt;
 }
 
-template<typename T>
-void list<T>::splice(const_iterator position, list&& x, const_iterator first, const_iterator last)
+template<typename T, typename Allocator>
+void list<T, Allocator>::splice(const_iterator position, list&& x, const_iterator first, const_iterator last)
 {
     splice(position, x, first, last);
 }
 
-template<typename T>
-void list<T>::sort()
+template<typename T, typename Allocator>
+void list<T, Allocator>::sort()
 {
     if (!head || !head->next)
     {
@@ -1376,8 +1446,8 @@ void list<T>::sort()
     tail = p;
 }
 
-template<typename T>
-bool operator==(const list<T>& a, const list<T>& b)
+template<typename T, typename Allocator>
+bool operator==(const list<T, Allocator>& a, const list<T, Allocator>& b)
 {
     if (a.size() != b.size())
     {
@@ -1386,8 +1456,8 @@ bool operator==(const list<T>& a, const list<T>& b)
     return std::equal(a.begin(), a.end(), b.begin());
 }
 
-template<typename T>
-bool operator!=(const list<T>& a, const list<T>& b)
+template<typename T, typename Allocator>
+bool operator!=(const list<T, Allocator>& a, const list<T, Allocator>& b)
 {
     return !(a == b);
 }
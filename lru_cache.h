@@ -1,55 +1,1132 @@
 #pragma once
-#include <list>
-#include <unordered_map>
+#include <vector>
+#include <tuple>
+#include <chrono>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
+#include <optional>
+#include <algorithm>
+#include <functional>
 
-template<typename K, typename V>
-class lru_cache
+#include "flat_hash_table.h"
+
+namespace mib
+{
+// weight is the sum the capacity bounds: the entry count unless a weigher is set.
+struct cache_stats
+{
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t expirations = 0;
+    std::size_t size = 0;
+    std::size_t weight = 0;
+};
+
+enum class removal_cause
+{
+    size,
+    expired
+};
+
+struct unit_weigher
+{
+    template<typename K, typename V>
+    std::size_t operator()(const K&, const V&) const noexcept
+    {
+        return 1;
+    }
+};
+
+namespace detail
+{
+using cache_index = std::uint32_t;
+constexpr cache_index cache_nil = std::numeric_limits<cache_index>::max();
+
+// Entries live in one slot array and are chained into hash buckets by 32-bit indices,
+// so a cache costs no allocation per entry and the key is stored once. Freed slots
+// go on a free list; once the array has reached its high-water mark, or was reserved
+// up front, insert/erase never allocate and slot addresses stay put. Eviction order
+// is kept by a policy, over the same slot indices.
+template<typename K, typename V, typename Hash, typename KeyEqual>
+class cache_table
 {
 public:
-    explicit lru_cache(const size_t capacity): capacity_(capacity) {}
+    using index_type = cache_index;
+    static constexpr index_type nil = cache_nil;
 
-    void put(const K& k, const V& v)
+    cache_table(const Hash& hash, const KeyEqual& eq): hash_(hash), eq_(eq), buckets_(8, nil) {}
+
+    void reserve(const std::size_t n)
+    {
+        slots_.reserve(n);
+        if (n > buckets_.size())
+        {
+            rehash(n);
+        }
+    }
+
+    std::size_t hash_of(const K& k) const
+    {
+        return static_cast<std::size_t>(mix_hash(static_cast<std::uint64_t>(hash_(k))));
+    }
+
+    index_type find(const K& k, const std::size_t h) const
+    {
+        for (index_type i = buckets_[h & (buckets_.size() - 1)]; i != nil; i = slots_[i].chain)
+        {
+            if (slots_[i].hash == h && eq_(slots_[i].kv->first, k))
+            {
+                return i;
+            }
+        }
+        return nil;
+    }
+
+    // The key must not be present.
+    template<typename KArg, typename... Args>
+    index_type insert(const std::size_t h, KArg&& k, Args&&... args)
+    {
+        const index_type i = acquire();
+        slot& s = slots_[i];
+        s.kv.emplace(std::piecewise_construct, std::forward_as_tuple(std::forward<KArg>(k)),
+                     std::forward_as_tuple(std::forward<Args>(args)...));
+        s.hash = h;
+
+        index_type& head = buckets_[h & (buckets_.size() - 1)];
+        s.chain = head;
+        head = i;
+        ++size_;
+
+        if (size_ > buckets_.size())
+        {
+            rehash(buckets_.size() * 2);
+        }
+        return i;
+    }
+
+    // Unhooks the entry from lookups but keeps its key and value alive until release().
+    void detach(const index_type i)
+    {
+        index_type* p = &buckets_[slots_[i].hash & (buckets_.size() - 1)];
+        while (*p != i)
+        {
+            p = &slots_[*p].chain;
+        }
+        *p = slots_[i].chain;
+        --size_;
+    }
+
+    void release(const index_type i)
+    {
+        slots_[i].kv.reset();
+        slots_[i].chain = free_;
+        free_ = i;
+    }
+
+    void erase(const index_type i)
+    {
+        detach(i);
+        release(i);
+    }
+
+    [[nodiscard]] const K& key(const index_type i) const
+    {
+        return slots_[i].kv->first;
+    }
+
+    [[nodiscard]] V& value(const index_type i)
+    {
+        return slots_[i].kv->second;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    struct slot
+    {
+        std::optional<std::pair<K, V>> kv;
+        std::size_t hash = 0;
+        index_type chain = nil;
+    };
+
+    index_type acquire()
+    {
+        if (free_ != nil)
+        {
+            const index_type i = free_;
+            free_ = slots_[i].chain;
+            return i;
+        }
+        slots_.emplace_back();
+        return static_cast<index_type>(slots_.size() - 1);
+    }
+
+    void rehash(const std::size_t n)
+    {
+        std::size_t count = buckets_.size();
+        while (count < n)
+        {
+            count *= 2;
+        }
+        std::vector<index_type> old(count, nil);
+        old.swap(buckets_);
+        for (index_type head : old)
+        {
+            while (head != nil)
+            {
+                const index_type next = slots_[head].chain;
+                index_type& bucket = buckets_[slots_[head].hash & (count - 1)];
+                slots_[head].chain = bucket;
+                bucket = head;
+                head = next;
+            }
+        }
+    }
+
+    Hash hash_;
+    KeyEqual eq_;
+    std::vector<slot> slots_;
+    std::vector<index_type> buckets_;
+    index_type free_ = nil;
+    std::size_t size_ = 0;
+};
+
+// Doubly linked lists over slot indices. One link array serves every list a policy
+// keeps, since a slot is on at most one of them. Each list also sums the weights
+// of its entries.
+class slot_lists
+{
+public:
+    struct list
+    {
+        cache_index head = cache_nil;
+        cache_index tail = cache_nil;
+        std::size_t size = 0;
+        std::size_t weight = 0;
+    };
+
+    void reserve(const std::size_t n)
+    {
+        links_.reserve(n);
+    }
+
+    void push_front(list& l, const cache_index i, const std::size_t weight)
+    {
+        if (i >= links_.size())
+        {
+            links_.resize(static_cast<std::size_t>(i) + 1);
+        }
+        links_[i].weight = weight;
+        push_front(l, i);
+    }
+
+    // Relinks i, keeping the weight it was last pushed with.
+    void push_front(list& l, const cache_index i)
+    {
+        links_[i].prev = cache_nil;
+        links_[i].next = l.head;
+        (l.head != cache_nil ? links_[l.head].prev : l.tail) = i;
+        l.head = i;
+        ++l.size;
+        l.weight += links_[i].weight;
+    }
+
+    void remove(list& l, const cache_index i)
+    {
+        const link& k = links_[i];
+        (k.prev != cache_nil ? links_[k.prev].next : l.head) = k.next;
+        (k.next != cache_nil ? links_[k.next].prev : l.tail) = k.prev;
+        --l.size;
+        l.weight -= k.weight;
+    }
+
+    void reweigh(list& l, const cache_index i, const std::size_t weight)
+    {
+        l.weight = l.weight - links_[i].weight + weight;
+        links_[i].weight = weight;
+    }
+
+    [[nodiscard]] std::size_t weight(const cache_index i) const
+    {
+        return links_[i].weight;
+    }
+
+    void move_to_front(list& l, const cache_index i)
+    {
+        if (l.head != i)
+        {
+            remove(l, i);
+            push_front(l, i);
+        }
+    }
+
+    [[nodiscard]] cache_index prev(const cache_index i) const
+    {
+        return links_[i].prev;
+    }
+
+private:
+    struct link
+    {
+        cache_index prev;
+        cache_index next;
+        std::size_t weight;
+    };
+
+    std::vector<link> links_;
+};
+
+// Count-min sketch with 4 rows of saturating 4-bit counters. As in Caffeine, a key's
+// four counters all sit in one 64-byte block, so an update touches one cache line:
+// the low hash bits pick the block, the high bits a counter in each row's quarter of
+// it. Every counter is halved after 10 * capacity increments so old popularity fades.
+class count_min_sketch
+{
+public:
+    explicit count_min_sketch(const std::size_t capacity)
+    {
+        const std::size_t counters = std::min(std::max<std::size_t>(capacity, 1), max_counters);
+        std::size_t blocks = 1;
+        while (blocks * counters_per_row < counters)
+        {
+            blocks *= 2;
+        }
+        block_mask_ = blocks - 1;
+        table_.assign(blocks * words_per_block, 0);
+        sample_size_ = 10 * counters;
+    }
+
+    void increment(const std::size_t h)
+    {
+        std::uint64_t* block = table_.data() + (h & block_mask_) * words_per_block;
+        bool added = false;
+        for (std::size_t r = 0; r < rows; ++r)
+        {
+            const std::size_t c = counter(h, r);
+            std::uint64_t& word = block[c / 16];
+            const unsigned shift = static_cast<unsigned>(c % 16) * 4;
+            if (((word >> shift) & 0xF) != 0xF)
+            {
+                word += std::uint64_t{1} << shift;
+                added = true;
+            }
+        }
+        if (added && ++samples_ == sample_size_)
+        {
+            age();
+        }
+    }
+
+    [[nodiscard]] unsigned frequency(const std::size_t h) const
+    {
+        const std::uint64_t* block = table_.data() + (h & block_mask_) * words_per_block;
+        unsigned f = 0xF;
+        for (std::size_t r = 0; r < rows; ++r)
+        {
+            const std::size_t c = counter(h, r);
+            f = std::min(f, static_cast<unsigned>((block[c / 16] >> (c % 16 * 4)) & 0xF));
+        }
+        return f;
+    }
+
+private:
+    static constexpr std::size_t rows = 4;
+    static constexpr std::size_t words_per_block = 8;
+    static constexpr std::size_t counters_per_row = words_per_block * 16 / rows;
+    static constexpr std::size_t max_counters = std::size_t{1} << 24;
+
+    static std::size_t counter(const std::size_t h, const std::size_t r)
+    {
+        return r * counters_per_row + ((h >> (32 + 8 * r)) & (counters_per_row - 1));
+    }
+
+    void age()
+    {
+        for (auto& word : table_)
+        {
+            word = (word >> 1) & 0x7777777777777777ull;
+        }
+        samples_ /= 2;
+    }
+
+    std::vector<std::uint64_t> table_;
+    std::size_t block_mask_ = 0;
+    std::size_t sample_size_ = 0;
+    std::size_t samples_ = 0;
+};
+
+// Hierarchical timing wheel over slot indices: 5 levels of 64 buckets, level L
+// holding deadlines 64^L to 64^(L+1) ticks away. An entry is touched once per level
+// it cascades through, and advance() jumps straight to the next occupied bucket
+// using a per-level occupancy mask, so expiry never scans live entries and an idle
+// period costs nothing. Deadlines past the last level wait in it and re-cascade.
+class timer_wheel
+{
+public:
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return count_ == 0;
+    }
+
+    [[nodiscard]] bool scheduled(const cache_index i) const noexcept
+    {
+        return i < meta_.size() && meta_[i].bucket != unscheduled;
+    }
+
+    [[nodiscard]] std::uint64_t deadline(const cache_index i) const
+    {
+        return meta_[i].deadline;
+    }
+
+    // Call advance() to the current tick first.
+    void schedule(const cache_index i, const std::uint64_t deadline)
+    {
+        if (i >= meta_.size())
+        {
+            meta_.resize(static_cast<std::size_t>(i) + 1);
+        }
+        meta_[i].deadline = deadline;
+        place(i, current_ + 1);
+        ++count_;
+    }
+
+    void cancel(const cache_index i)
+    {
+        unlink(i);
+        --count_;
+    }
+
+    // Moves time forward to now, calling expire(i) for each entry whose deadline has
+    // passed; the entry is already unscheduled when expire runs.
+    template<typename Expire>
+    void advance(const std::uint64_t now, Expire&& expire)
+    {
+        while (current_ < now)
+        {
+            const std::uint64_t next = count_ ? next_event() : now;
+            if (next > now)
+            {
+                current_ = now;
+                return;
+            }
+            current_ = next;
+
+            for (std::size_t level = levels - 1; level > 0; --level)
+            {
+                if ((current_ & (span(level) - 1)) == 0)
+                {
+                    auto& b = buckets_[level * width + ((current_ >> (bits * level)) & (width - 1))];
+                    while (b.head != cache_nil)
+                    {
+                        const cache_index i = b.head;
+                        unlink(i);
+                        place(i, current_);
+                    }
+                }
+            }
+
+            auto& due = buckets_[current_ & (width - 1)];
+            while (due.head != cache_nil)
+            {
+                const cache_index i = due.head;
+                unlink(i);
+                --count_;
+                expire(i);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t levels = 5;
+    static constexpr std::size_t bits = 6;
+    static constexpr std::size_t width = std::size_t{1} << bits;
+    static constexpr std::uint16_t unscheduled = 0xFFFF;
+
+    struct entry_meta
+    {
+        std::uint64_t deadline = 0;
+        std::uint16_t bucket = unscheduled;
+    };
+
+    static constexpr std::uint64_t span(const std::size_t level)
+    {
+        return std::uint64_t{1} << (bits * level);
+    }
+
+    // Cascading entries may land in the level-0 bucket about to be processed; newly
+    // scheduled ones go no earlier than the next tick.
+    void place(const cache_index i, const std::uint64_t earliest)
+    {
+        std::uint64_t when = std::max(meta_[i].deadline, earliest);
+        std::size_t level = 0;
+        if (when - current_ >= span(levels))
+        {
+            when = current_ + span(levels) - 1;
+            level = levels - 1;
+        }
+        else if (when > current_)
+        {
+            level = static_cast<std::size_t>(63 - countl_zero(when - current_)) / bits;
+        }
+
+        const std::size_t b = static_cast<std::size_t>((when >> (bits * level)) & (width - 1));
+        const auto bucket = static_cast<std::uint16_t>(level * width + b);
+        meta_[i].bucket = bucket;
+        lists_.push_front(buckets_[bucket], i, 0);
+        occupied_[level] |= std::uint64_t{1} << b;
+    }
+
+    void unlink(const cache_index i)
+    {
+        const std::uint16_t bucket = meta_[i].bucket;
+        lists_.remove(buckets_[bucket], i);
+        meta_[i].bucket = unscheduled;
+        if (buckets_[bucket].head == cache_nil)
+        {
+            occupied_[bucket / width] &= ~(std::uint64_t{1} << (bucket % width));
+        }
+    }
+
+    // Earliest tick after current_ at which some occupied bucket is due.
+    std::uint64_t next_event() const
+    {
+        std::uint64_t best = std::numeric_limits<std::uint64_t>::max();
+        for (std::size_t level = 0; level < levels; ++level)
+        {
+            const std::uint64_t mask = occupied_[level];
+            if (!mask)
+            {
+                continue;
+            }
+            const std::uint64_t slot = current_ >> (bits * level);
+            const unsigned shift = static_cast<unsigned>((slot + 1) & (width - 1));
+            const std::uint64_t rotated = shift ? (mask >> shift) | (mask << (width - shift)) : mask;
+            const std::uint64_t ahead = static_cast<std::uint64_t>(countr_zero(rotated)) + 1;
+            best = std::min(best, (slot + ahead) << (bits * level));
+        }
+        return best;
+    }
+
+    std::vector<entry_meta> meta_;
+    slot_lists lists_;
+    slot_lists::list buckets_[levels * width];
+    std::uint64_t occupied_[levels] = {};
+    std::uint64_t current_ = 0;
+    std::size_t count_ = 0;
+};
+}
+
+// Eviction policies order entries by slot index. Capacity and weights are in the
+// cache's weigher units (entries by default). The cache calls
+//   record(hash)        on every lookup and insert, hit or miss;
+//   on_insert(i, h, w)  once a new entry of weight w holds slot i;
+//   on_hit(i)           when an entry is read or overwritten;
+//   reweigh(i, w)       after an overwrite changed the entry's weight;
+//   victim()            while full, for the next entry to drop;
+//   on_erase(i)         before slot i is freed, evicted, expired or erased.
+// victim() may reorganise internal state, but the cache always erases what it returns.
+
+// Plain recency order.
+class lru_policy
+{
+public:
+    explicit lru_policy(std::size_t) {}
+
+    void reserve(const std::size_t n)
+    {
+        lists_.reserve(n);
+    }
+
+    void record(std::size_t) noexcept {}
+
+    void on_insert(const detail::cache_index i, std::size_t, std::size_t)
+    {
+        lists_.push_front(order_, i, 1);
+    }
+
+    void on_hit(const detail::cache_index i)
+    {
+        lists_.move_to_front(order_, i);
+    }
+
+    void reweigh(detail::cache_index, std::size_t) noexcept {}
+
+    void on_erase(const detail::cache_index i)
+    {
+        lists_.remove(order_, i);
+    }
+
+    [[nodiscard]] detail::cache_index victim() const noexcept
     {
-        auto it = map_.find(k);
-        if (it != map_.end())
+        return order_.tail;
+    }
+
+    // Walks from least to most recent, for callers that have to skip some entries.
+    [[nodiscard]] detail::cache_index prev(const detail::cache_index i) const
+    {
+        return lists_.prev(i);
+    }
+
+private:
+    detail::slot_lists lists_;
+    detail::slot_lists::list order_;
+};
+
+// Segmented LRU: new entries start on probation and a second hit promotes them to
+// the protected segment (80% of capacity). A scan only churns the probation segment.
+class slru_policy
+{
+public:
+    explicit slru_policy(const std::size_t capacity): protected_cap_(capacity * 4 / 5) {}
+
+    void record(std::size_t) noexcept {}
+
+    void on_insert(const detail::cache_index i, std::size_t, const std::size_t w)
+    {
+        if (i >= segment_.size())
         {
-            it->second->second = v;
-            touch(it);
+            segment_.resize(static_cast<std::size_t>(i) + 1);
+        }
+        segment_[i] = probation;
+        lists_.push_front(probation_, i, w);
+    }
 
+    void on_hit(const detail::cache_index i)
+    {
+        if (segment_[i] == protect)
+        {
+            lists_.move_to_front(protected_, i);
             return;
         }
 
-        items_.emplace_front(k,v);
-        map_[k] = items_.begin();
+        lists_.remove(probation_, i);
+        segment_[i] = protect;
+        lists_.push_front(protected_, i);
+        trim_protected();
+    }
+
+    void reweigh(const detail::cache_index i, const std::size_t w)
+    {
+        lists_.reweigh(segment_[i] == protect ? protected_ : probation_, i, w);
+        trim_protected();
+    }
+
+    void on_erase(const detail::cache_index i)
+    {
+        lists_.remove(segment_[i] == protect ? protected_ : probation_, i);
+    }
+
+    [[nodiscard]] detail::cache_index victim() const noexcept
+    {
+        return probation_.tail != detail::cache_nil ? probation_.tail : protected_.tail;
+    }
+
+private:
+    static constexpr std::uint8_t probation = 0;
+    static constexpr std::uint8_t protect = 1;
+
+    // Demotes the least recent protected entries back to probation, keeping one.
+    void trim_protected()
+    {
+        while (protected_.weight > protected_cap_ && protected_.size > 1)
+        {
+            const detail::cache_index demoted = protected_.tail;
+            lists_.remove(protected_, demoted);
+            segment_[demoted] = probation;
+            lists_.push_front(probation_, demoted);
+        }
+    }
+
+    std::size_t protected_cap_;
+    std::vector<std::uint8_t> segment_;
+    detail::slot_lists lists_;
+    detail::slot_lists::list probation_;
+    detail::slot_lists::list protected_;
+};
 
-        if (map_.size() > capacity_)
+// CLOCK: a hit only sets a reference byte, so reads never relink anything. The hand
+// sweeps the slot array, clearing reference bytes and stopping at the first entry
+// not referenced since the last pass. New entries start unreferenced, so one-off
+// keys from a scan are the first to go.
+class clock_policy
+{
+public:
+    explicit clock_policy(std::size_t) {}
+
+    void record(std::size_t) noexcept {}
+
+    void on_insert(const detail::cache_index i, std::size_t, std::size_t)
+    {
+        if (i >= state_.size())
         {
-            map_.erase(items_.back().first);
-            items_.pop_back();
+            state_.resize(static_cast<std::size_t>(i) + 1, empty);
         }
+        state_[i] = resident;
     }
-    bool get(const K& k, V& out)
+
+    void on_hit(const detail::cache_index i)
+    {
+        state_[i] = referenced;
+    }
+
+    void reweigh(detail::cache_index, std::size_t) noexcept {}
+
+    void on_erase(const detail::cache_index i)
+    {
+        state_[i] = empty;
+    }
+
+    // Needs at least one entry.
+    [[nodiscard]] detail::cache_index victim()
+    {
+        while (true)
+        {
+            if (hand_ >= state_.size())
+            {
+                hand_ = 0;
+            }
+            const std::size_t i = hand_++;
+            if (state_[i] == resident)
+            {
+                return static_cast<detail::cache_index>(i);
+            }
+            if (state_[i] == referenced)
+            {
+                state_[i] = resident;
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint8_t empty = 0;
+    static constexpr std::uint8_t resident = 1;
+    static constexpr std::uint8_t referenced = 2;
+
+    std::vector<std::uint8_t> state_;
+    std::size_t hand_ = 0;
+};
+
+// W-TinyLFU: a small LRU window (1% of capacity) in front of an SLRU main region.
+// An entry pushed out of the full window only enters the main region if the
+// count-min sketch has seen its key more often than the main region's victim, so a
+// scan of one-off keys passes through the window without displacing frequent keys.
+class w_tinylfu_policy
+{
+public:
+    explicit w_tinylfu_policy(const std::size_t capacity)
+        : window_cap_(std::max<std::size_t>(1, capacity / 100))
+        , main_cap_(capacity > window_cap_ ? capacity - window_cap_ : 0)
+        , protected_cap_(main_cap_ * 4 / 5)
+        , sketch_(capacity)
+    {}
+
+    void record(const std::size_t h)
+    {
+        sketch_.increment(h);
+    }
+
+    void on_insert(const detail::cache_index i, const std::size_t h, const std::size_t w)
+    {
+        if (i >= meta_.size())
+        {
+            meta_.resize(static_cast<std::size_t>(i) + 1);
+        }
+        meta_[i] = {h, window};
+        lists_.push_front(window_, i, w);
+
+        // Until the main region fills up, the window overflows into it freely.
+        while (window_.weight > window_cap_ && window_.tail != i &&
+               probation_.weight + protected_.weight + lists_.weight(window_.tail) <= main_cap_)
+        {
+            move(window_.tail, window_, probation, probation_);
+        }
+    }
+
+    void on_hit(const detail::cache_index i)
+    {
+        switch (meta_[i].segment)
+        {
+        case window:
+            lists_.move_to_front(window_, i);
+            break;
+        case protect:
+            lists_.move_to_front(protected_, i);
+            break;
+        default:
+            move(i, probation_, protect, protected_);
+            trim_protected();
+            break;
+        }
+    }
+
+    void reweigh(const detail::cache_index i, const std::size_t w)
+    {
+        lists_.reweigh(list_of(meta_[i].segment), i, w);
+        trim_protected();
+    }
+
+    void on_erase(const detail::cache_index i)
+    {
+        lists_.remove(list_of(meta_[i].segment), i);
+    }
+
+    [[nodiscard]] detail::cache_index victim()
+    {
+        const detail::cache_index candidate = window_.tail;
+        const detail::cache_index main = probation_.tail != detail::cache_nil ? probation_.tail : protected_.tail;
+        if (candidate == detail::cache_nil)
+        {
+            return main;
+        }
+        if (main == detail::cache_nil || sketch_.frequency(meta_[candidate].hash) <= sketch_.frequency(meta_[main].hash))
+        {
+            return candidate;
+        }
+        move(candidate, window_, probation, probation_);
+        return main;
+    }
+
+private:
+    static constexpr std::uint8_t window = 0;
+    static constexpr std::uint8_t probation = 1;
+    static constexpr std::uint8_t protect = 2;
+
+    struct entry_meta
+    {
+        std::size_t hash = 0;
+        std::uint8_t segment = window;
+    };
+
+    detail::slot_lists::list& list_of(const std::uint8_t segment)
+    {
+        return segment == window ? window_ : segment == probation ? probation_ : protected_;
+    }
+
+    void move(const detail::cache_index i, detail::slot_lists::list& from, const std::uint8_t segment,
+              detail::slot_lists::list& to)
+    {
+        lists_.remove(from, i);
+        meta_[i].segment = segment;
+        lists_.push_front(to, i);
+    }
+
+    void trim_protected()
+    {
+        while (protected_.weight > protected_cap_ && protected_.size > 1)
+        {
+            move(protected_.tail, protected_, probation, probation_);
+        }
+    }
+
+    std::size_t window_cap_;
+    std::size_t main_cap_;
+    std::size_t protected_cap_;
+    detail::count_min_sketch sketch_;
+    std::vector<entry_meta> meta_;
+    detail::slot_lists lists_;
+    detail::slot_lists::list window_;
+    detail::slot_lists::list probation_;
+    detail::slot_lists::list protected_;
+};
+}
+
+// Bounded cache whose eviction order comes from Policy: mib::lru_policy (the default),
+// mib::slru_policy, mib::clock_policy or mib::w_tinylfu_policy.
+//
+// capacity bounds the total Weigher(key, value) of the entries; the default weigher
+// counts every entry as 1, so capacity is an entry count. An entry heavier than the
+// whole capacity is never stored. Entries may carry a time to live at millisecond
+// resolution; expired entries are reclaimed by a timing wheel as operations advance
+// the clock, and never returned. The eviction listener sees every entry the cache
+// drops on its own (for size or expiry) just before it is destroyed; it must not
+// call back into the cache.
+template<typename K, typename V, typename Policy = mib::lru_policy, typename Weigher = mib::unit_weigher,
+         typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class lru_cache
+{
+    using table_type = mib::detail::cache_table<K, V, Hash, KeyEqual>;
+    using index_type = typename table_type::index_type;
+
+public:
+    using clock_type = std::chrono::steady_clock;
+    using duration = clock_type::duration;
+    using listener_type = std::function<void(const K&, const V&, mib::removal_cause)>;
+
+    explicit lru_cache(const size_t capacity, const Weigher& weigher = Weigher(), const Hash& hash = Hash(),
+                       const KeyEqual& eq = KeyEqual())
+        : capacity_(capacity)
+        , weigher_(weigher)
+        , table_(hash, eq)
+        , policy_(capacity)
+    {}
+
+    // Uses the default time to live.
+    void put(const K& k, const V& v)
     {
-        auto it = map_.find(k);
+        put_impl(k, v, default_ttl_);
+    }
 
-        if (it == map_.end())
+    void put(K&& k, V&& v)
+    {
+        put_impl(std::move(k), std::move(v), default_ttl_);
+    }
+
+    // ttl == duration::zero() means the entry never expires.
+    void put(const K& k, const V& v, const duration ttl)
+    {
+        put_impl(k, v, ttl);
+    }
+
+    void put(K&& k, V&& v, const duration ttl)
+    {
+        put_impl(std::move(k), std::move(v), ttl);
+    }
+
+    bool get(const K& k, V& out)
+    {
+        const V* v = get(k);
+        if (!v)
         {
             return false;
         }
+        out = *v;
+        return true;
+    }
+
+    // Counts as a use and returns the entry in place. The pointer is valid until the
+    // next non-const call: a later get() or expire() can reclaim the entry once its
+    // time to live runs out.
+    V* get(const K& k)
+    {
+        expire_due();
+        const std::size_t h = table_.hash_of(k);
+        policy_.record(h);
+        const index_type i = table_.find(k, h);
+        if (i == table_type::nil)
+        {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        policy_.on_hit(i);
+        return &table_.value(i);
+    }
 
-        out = it->second->second;
-        touch(it);
+    // Does not count as a use and does not advance expiry; an entry whose time to live
+    // has run out reads as absent even before the wheel reclaims it.
+    [[nodiscard]] bool contains(const K& k) const
+    {
+        const index_type i = table_.find(k, table_.hash_of(k));
+        return i != table_type::nil && !(wheel_.scheduled(i) && wheel_.deadline(i) <= now_ticks());
+    }
+
+    bool erase(const K& k)
+    {
+        const index_type i = table_.find(k, table_.hash_of(k));
+        if (i == table_type::nil)
+        {
+            return false;
+        }
+        remove(i);
         return true;
     }
+
+    // Reclaims every entry whose time to live has run out.
+    void expire()
+    {
+        expire_due();
+    }
+
+    void set_default_ttl(const duration ttl) noexcept
+    {
+        default_ttl_ = ttl;
+    }
+
+    void set_eviction_listener(listener_type listener)
+    {
+        listener_ = std::move(listener);
+    }
+
+    // Replaces the time source, e.g. with a fake clock in tests.
+    void set_clock(clock_type::time_point (*now)()) noexcept
+    {
+        now_ = now;
+    }
+
+    [[nodiscard]] mib::cache_stats stats() const noexcept
+    {
+        mib::cache_stats out;
+        out.hits = hits_;
+        out.misses = misses_;
+        out.evictions = evictions_;
+        out.expirations = expirations_;
+        out.size = table_.size();
+        out.weight = weight_;
+        return out;
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return table_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return table_.size() == 0;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    // Total weight of the entries; equals size() with the default weigher.
+    [[nodiscard]] size_t weight() const noexcept
+    {
+        return weight_;
+    }
+
 private:
-    void touch(typename std::unordered_map<K, typename std::list<std::pair<K,V>>::iterator>::iterator it)
+    template<typename KArg, typename VArg>
+    void put_impl(KArg&& k, VArg&& v, const duration ttl)
+    {
+        const bool timed = ttl > duration::zero();
+        std::uint64_t now = 0;
+        if (timed || !wheel_.empty())
+        {
+            now = now_ticks();
+            advance_wheel(now);
+        }
+
+        const std::size_t h = table_.hash_of(k);
+        policy_.record(h);
+        const std::size_t w = weigher_(static_cast<const K&>(k), static_cast<const V&>(v));
+        index_type i = table_.find(k, h);
+
+        if (w > capacity_)
+        {
+            if (i != table_type::nil)
+            {
+                remove(i);
+            }
+            ++evictions_;
+            if (listener_)
+            {
+                listener_(k, v, mib::removal_cause::size);
+            }
+            return;
+        }
+
+        if (i != table_type::nil)
+        {
+            table_.value(i) = std::forward<VArg>(v);
+            weight_ = weight_ - weights_[i] + w;
+            weights_[i] = w;
+            policy_.on_hit(i);
+            policy_.reweigh(i, w);
+            if (wheel_.scheduled(i))
+            {
+                wheel_.cancel(i);
+            }
+        }
+        else
+        {
+            make_room(w);
+            i = table_.insert(h, std::forward<KArg>(k), std::forward<VArg>(v));
+            if (i >= weights_.size())
+            {
+                weights_.resize(static_cast<std::size_t>(i) + 1);
+            }
+            weights_[i] = w;
+            weight_ += w;
+            policy_.on_insert(i, h, w);
+        }
+
+        if (timed)
+        {
+            wheel_.schedule(i, now + ttl_ticks(ttl));
+        }
+        make_room(0);
+    }
+
+    // Evicts until `incoming` more weight fits.
+    void make_room(const std::size_t incoming)
+    {
+        while (table_.size() && weight_ + incoming > capacity_)
+        {
+            const index_type victim = policy_.victim();
+            ++evictions_;
+            drop(victim, mib::removal_cause::size);
+        }
+    }
+
+    void expire_due()
+    {
+        if (!wheel_.empty())
+        {
+            advance_wheel(now_ticks());
+        }
+    }
+
+    void advance_wheel(const std::uint64_t now)
+    {
+        wheel_.advance(now, [this](const index_type i)
+        {
+            ++expirations_;
+            drop(i, mib::removal_cause::expired);
+        });
+    }
+
+    void drop(const index_type i, const mib::removal_cause cause)
+    {
+        if (listener_)
+        {
+            listener_(table_.key(i), table_.value(i), cause);
+        }
+        remove(i);
+    }
+
+    void remove(const index_type i)
+    {
+        policy_.on_erase(i);
+        if (wheel_.scheduled(i))
+        {
+            wheel_.cancel(i);
+        }
+        weight_ -= weights_[i];
+        table_.erase(i);
+    }
+
+    std::uint64_t now_ticks() const
+    {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(now_().time_since_epoch()).count());
+    }
+
+    // Rounded up, so an entry never expires early.
+    static std::uint64_t ttl_ticks(const duration ttl)
     {
-        items_.splice(items_.begin(), items_, it->second);
-        it->second = items_.begin();
+        return static_cast<std::uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(ttl).count());
     }
 
     size_t capacity_;
-    std::list<std::pair<K,V>> items_;
-    std::unordered_map<K, typename std::list<std::pair<K,V>>::iterator> map_;
+    size_t weight_ = 0;
+    Weigher weigher_;
+    table_type table_;
+    Policy policy_;
+    std::vector<size_t> weights_;
+    mib::detail::timer_wheel wheel_;
+    duration default_ttl_ = duration::zero();
+    clock_type::time_point (*now_)() = &clock_type::now;
+    listener_type listener_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t evictions_ = 0;
+    size_t expirations_ = 0;
 };
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <limits>
+
+namespace mib
+{
+template<typename T>
+class malloc_allocator
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    malloc_allocator() noexcept = default;
+
+    template<typename U>
+    malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+    T* allocate(const size_type n)
+    {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+
+        void* p = std::malloc(n * sizeof(T));
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_type /*n*/) noexcept
+    {
+        std::free(p);
+    }
+
+    T* reallocate(T* p, size_type /*old_n*/, const size_type new_n)
+    {
+        if (new_n > std::numeric_limits<size_type>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+
+        void* q = std::realloc(p, new_n * sizeof(T));
+        if (!q)
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(q);
+    }
+
+    template<typename U>
+    friend bool operator==(const malloc_allocator&, const malloc_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template<typename U>
+    friend bool operator!=(const malloc_allocator&, const malloc_allocator<U>&) noexcept
+    {
+        return false;
+    }
+};
+}
@@ -10,6 +10,7 @@
 #include <vector>
 #include <limits>
 #include <optional>
+#include <algorithm>
 
 template<
 	typename Key,
@@ -49,6 +50,8 @@ private:
 	};
 
 	Node* root_ = nullptr;
+	Node* leftmost_ = nullptr;
+	Node* rightmost_ = nullptr;
 	size_type size_ = 0;
 	key_compare comp_;
 	allocator_type alloc_;
@@ -57,9 +60,44 @@ private:
 	using node_alloc_traits = std::allocator_traits<node_allocator_type>;
 	node_allocator_type node_alloc_;
 
+	template<typename... Args>
+	Node* create_node(Args&&... args);
+	void destroy_node(Node* p) noexcept;
+	void destroy_subtree(Node* n) noexcept;
+	Node* clone_subtree(const Node* src, Node* parent);
+
+	static Node* minimum(Node* n);
+	static Node* maximum(Node* n);
+	static Node* successor(Node* n);
+	static Node* predecessor(Node* n);
+
+	void left_rotate(Node* x);
+	void right_rotate(Node* x);
+	void insert_fixup(Node* z);
+	void delete_fixup(Node* x, Node* x_parent);
+	void transplant(Node* u, Node* v);
+
+	Node* find_slot(const key_type& key, Node*& parent) const;
+	void attach(Node* parent, Node* n);
+	Node* unlink_node(Node* z);
+
+	static Node* build_balanced(Node* const* nodes, size_type n) noexcept;
+	static Node* build_subtree(Node* const* nodes, size_type n, size_type depth, size_type red_depth) noexcept;
+	void merge_linear(map& other);
+	void reset_ends() noexcept;
+	template<typename InputIt>
+	void build_from(InputIt first, InputIt last);
+	template<typename InputIt>
+	Node* build_streaming(InputIt& first, size_type n, size_type depth, size_type red_depth,
+		std::vector<Node*>& made, bool& ascending);
+	void build_from_nodes(std::vector<Node*>& nodes);
+	static size_type deepest_level(size_type n) noexcept;
+
 public:
 	struct iterator;
 	struct const_iterator;
+	class node_type;
+	struct insert_return_type;
 
 	using reverse_iterator = std::reverse_iterator<iterator>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
@@ -69,7 +107,9 @@ public:
 	map(const map& other);
 	map(map&& other) noexcept;
 	map(std::initializer_list<value_type> init, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type());
-	~map() = default;
+	template<typename InputIt>
+	map(InputIt first, InputIt last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type());
+	~map();
 
 	map& operator=(const map& other);
 	map& operator=(map&& other) noexcept;
@@ -89,8 +129,10 @@ public:
 	};
 
 	bool contains(const key_type& key) const;
-	std::optional<value_type> extract(const key_type& key);
+	node_type extract(const_iterator pos);
+	node_type extract(const key_type& key);
 	void merge(map& other);
+	void merge(map&& other);
 
 	iterator begin() noexcept;
 	const_iterator begin() const noexcept;
@@ -122,8 +164,17 @@ public:
 	std::pair<iterator, bool> insert(const value_type& v);
 	std::pair<iterator, bool> insert(value_type&& v);
 	iterator insert(const_iterator hint, const value_type& v);
+	insert_return_type insert(node_type&& nh);
+	iterator insert(const_iterator hint, node_type&& nh);
+	template<typename InputIt>
+	void insert(InputIt first, InputIt last);
+	void insert(std::initializer_list<value_type> init);
+	template<typename Range>
+	void insert_range(Range&& range);
 	template<class... Args>
 	std::pair<iterator, bool> emplace(Args&&... args);
+	template<class... Args>
+	iterator emplace_hint(const_iterator hint, Args&&... args);
 	iterator erase(const_iterator pos);
 	size_type erase(const key_type& key);
 
@@ -148,15 +199,18 @@ public:
 	{ 
 		return !(a == b); 
 	}
+
+private:
+	Node* find_slot(const_iterator hint, const key_type& key, Node*& parent) const;
 };
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 struct map<Key,T,Compare,Allocator>::iterator 
 {
 	using iterator_category = std::bidirectional_iterator_tag;
-	using value_type = value_type;
+	using value_type = std::pair<const Key, T>;
 	using difference_type = std::ptrdiff_t;
-	using pointer = pointer;
+	using pointer = value_type*;
 	using reference = value_type&;
 
 	Node* node = nullptr;
@@ -213,7 +267,7 @@ struct map<Key,T,Compare,Allocator>::iterator
 		{
 			if (owner)
 			{
-				node = maximum(owner->root_);
+				node = owner->rightmost_;
 			}
 			return *this;
 		}
@@ -256,9 +310,9 @@ template<typename Key, typename T, typename Compare, typename Allocator>
 struct map<Key,T,Compare,Allocator>::const_iterator 
 {
 	using iterator_category = std::bidirectional_iterator_tag;
-	using value_type = value_type;
+	using value_type = std::pair<const Key, T>;
 	using difference_type = std::ptrdiff_t;
-	using pointer = const_pointer;
+	using pointer = const value_type*;
 	using reference = const value_type&;
 
 	const Node* node = nullptr;
@@ -266,7 +320,7 @@ struct map<Key,T,Compare,Allocator>::const_iterator
 	const_iterator() = default;
 
 	explicit const_iterator(const Node* n, const map* o = nullptr) : node(n), owner(o) {}
-	explicit const_iterator(const iterator& it) : node(it.node), owner(it.owner) {}
+	const_iterator(const iterator& it) : node(it.node), owner(it.owner) {}
 
 	reference operator*() const 
 	{ 
@@ -316,7 +370,7 @@ struct map<Key,T,Compare,Allocator>::const_iterator
 		{
 			if (owner)
 			{
-				node = maximum(owner->root_);
+				node = owner->rightmost_;
 			}
 			return *this;
 		}
@@ -357,9 +411,113 @@ struct map<Key,T,Compare,Allocator>::const_iterator
 	}
 };
 
+// Owns a node taken out of a map by extract(); insert() links it back into a map with
+// an equal allocator without copying or allocating. An empty handle owns nothing.
+template<typename Key, typename T, typename Compare, typename Allocator>
+class map<Key,T,Compare,Allocator>::node_type
+{
+public:
+	using key_type = Key;
+	using mapped_type = T;
+	using allocator_type = Allocator;
+
+	node_type() = default;
+
+	node_type(node_type&& other) noexcept
+		: node_(std::exchange(other.node_, nullptr)), alloc_(std::move(other.alloc_))
+	{
+	}
+
+	node_type& operator=(node_type&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			node_ = std::exchange(other.node_, nullptr);
+			alloc_ = std::move(other.alloc_);
+		}
+		return *this;
+	}
+
+	node_type(const node_type&) = delete;
+	node_type& operator=(const node_type&) = delete;
+
+	~node_type()
+	{
+		reset();
+	}
+
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return node_ == nullptr;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return node_ != nullptr;
+	}
+
+	// The handle is the node's only owner, so the key may be changed before the node
+	// is inserted again, as with the standard library's node handles.
+	key_type& key() const
+	{
+		return const_cast<key_type&>(node_->kv.first);
+	}
+
+	mapped_type& mapped() const
+	{
+		return node_->kv.second;
+	}
+
+	allocator_type get_allocator() const
+	{
+		return allocator_type(*alloc_);
+	}
+
+	void swap(node_type& other) noexcept
+	{
+		using std::swap;
+
+		swap(node_, other.node_);
+		swap(alloc_, other.alloc_);
+	}
+
+private:
+	friend class map;
+
+	node_type(Node* n, const node_allocator_type& alloc) : node_(n), alloc_(alloc) {}
+
+	Node* release() noexcept
+	{
+		return std::exchange(node_, nullptr);
+	}
+
+	void reset() noexcept
+	{
+		if (node_)
+		{
+			node_alloc_traits::destroy(*alloc_, node_);
+			node_alloc_traits::deallocate(*alloc_, node_, 1);
+			node_ = nullptr;
+		}
+	}
+
+	Node* node_ = nullptr;
+	std::optional<node_allocator_type> alloc_;
+};
+
+// On failure node still owns the handle that could not be inserted.
+template<typename Key, typename T, typename Compare, typename Allocator>
+struct map<Key,T,Compare,Allocator>::insert_return_type
+{
+	iterator position;
+	bool inserted;
+	node_type node;
+};
+
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::Node*
-minimum(typename map<Key,T,Compare,Allocator>::Node* n) 
+map<Key,T,Compare,Allocator>::minimum(Node* n) 
 {
 	if (!n) 
 	{
@@ -373,21 +531,19 @@ minimum(typename map<Key,T,Compare,Allocator>::Node* n)
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename... Args>
 typename map<Key,T,Compare,Allocator>::Node*
-map_create_node(map<Key,T,Compare,Allocator>& m, const typename map<Key,T,Compare,Allocator>::value_type& v)
+map<Key,T,Compare,Allocator>::create_node(Args&&... args)
 {
-	using Map = map<Key,T,Compare,Allocator>;
-	typename Map::node_allocator_type &alloc = m.node_alloc_;
-
-	auto* p = Map::node_alloc_traits::allocate(alloc, 1);
+	Node* p = node_alloc_traits::allocate(node_alloc_, 1);
 
 	try
 	{
-		Map::node_alloc_traits::construct(alloc, p, v);
+		node_alloc_traits::construct(node_alloc_, p, std::forward<Args>(args)...);
 	}
 	catch(...)
 	{
-		Map::node_alloc_traits::deallocate(alloc, p, 1);
+		node_alloc_traits::deallocate(node_alloc_, p, 1);
 		throw;
 	}
 	return p;
@@ -395,25 +551,20 @@ map_create_node(map<Key,T,Compare,Allocator>& m, const typename map<Key,T,Compar
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 void
-map_destroy_node(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allocator>::Node* p)
+map<Key,T,Compare,Allocator>::destroy_node(Node* p) noexcept
 {
 	if (!p) 
 	{
 		return;
 	}
 
-	using Map = map<Key,T,Compare,Allocator>;
-
-	typename Map::node_allocator_type &alloc = m.node_alloc_;
-	Map::node_alloc_traits::destroy(alloc, p);
-	Map::node_alloc_traits::deallocate(alloc, p, 1);
+	node_alloc_traits::destroy(node_alloc_, p);
+	node_alloc_traits::deallocate(node_alloc_, p, 1);
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
-void left_rotate(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allocator>::Node* x)
+void map<Key,T,Compare,Allocator>::left_rotate(Node* x)
 {
-	using Node = typename map<Key,T,Compare,Allocator>::Node;
-
 	Node* y = x->right;
 	x->right = y->left;
 
@@ -425,7 +576,7 @@ void left_rotate(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,All
 	y->parent = x->parent;
 	if (!x->parent) 
 	{
-		m.root_ = y;
+		root_ = y;
 	}
 	else if (x == x->parent->left) 
 	{
@@ -441,10 +592,8 @@ void left_rotate(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,All
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
-void right_rotate(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allocator>::Node* x)
+void map<Key,T,Compare,Allocator>::right_rotate(Node* x)
 {
-	using Node = typename map<Key,T,Compare,Allocator>::Node;
-
 	Node* y = x->left;
 	x->left = y->right;
 
@@ -457,7 +606,7 @@ void right_rotate(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Al
 
 	if (!x->parent) 
 	{
-		m.root_ = y;
+		root_ = y;
 	}
 	else if (x == x->parent->right) 
 	{
@@ -473,10 +622,9 @@ void right_rotate(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Al
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
-void rb_insert_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allocator>::Node* z)
+void map<Key,T,Compare,Allocator>::insert_fixup(Node* z)
 {
-	using Node = typename map<Key,T,Compare,Allocator>::Node;
-	while (z->parent && z->parent->color == map<Key,T,Compare,Allocator>::RED) 
+	while (z->parent && z->parent->color == RED) 
 	{
 		Node* gp = z->parent->parent;
 
@@ -484,11 +632,11 @@ void rb_insert_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare
 		{
 			Node* y = gp->right;
 
-			if (y && y->color == map<Key,T,Compare,Allocator>::RED) 
+			if (y && y->color == RED) 
 			{
-				z->parent->color = map<Key,T,Compare,Allocator>::BLACK;
-				y->color = map<Key,T,Compare,Allocator>::BLACK;
-				gp->color = map<Key,T,Compare,Allocator>::RED;
+				z->parent->color = BLACK;
+				y->color = BLACK;
+				gp->color = RED;
 				z = gp;
 			} 
 			else 
@@ -496,24 +644,24 @@ void rb_insert_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare
 				if (z == z->parent->right) 
 				{ 
 					z = z->parent; 
-					left_rotate(m, z); 
+					left_rotate(z); 
 				}
 
-				z->parent->color = map<Key,T,Compare,Allocator>::BLACK;
-				gp->color = map<Key,T,Compare,Allocator>::RED;
+				z->parent->color = BLACK;
+				gp->color = RED;
 
-				right_rotate(m, gp);
+				right_rotate(gp);
 			}
 		} 
 		else 
 		{
 			Node* y = gp->left;
 
-			if (y && y->color == map<Key,T,Compare,Allocator>::RED) 
+			if (y && y->color == RED) 
 			{
-				z->parent->color = map<Key,T,Compare,Allocator>::BLACK;
-				y->color = map<Key,T,Compare,Allocator>::BLACK;
-				gp->color = map<Key,T,Compare,Allocator>::RED;
+				z->parent->color = BLACK;
+				y->color = BLACK;
+				gp->color = RED;
 
 				z = gp;
 			} 
@@ -522,28 +670,28 @@ void rb_insert_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare
 				if (z == z->parent->left) 
 				{ 
 					z = z->parent; 
-					right_rotate(m, z); 
+					right_rotate(z); 
 				}
 
-				z->parent->color = map<Key,T,Compare,Allocator>::BLACK;
-				gp->color = map<Key,T,Compare,Allocator>::RED;
+				z->parent->color = BLACK;
+				gp->color = RED;
 
-				left_rotate(m, gp);
+				left_rotate(gp);
 			}
 		}
 	}
-	if (m.root_) 
+	if (root_) 
 	{
-		m.root_->color = map<Key,T,Compare,Allocator>::BLACK;
+		root_->color = BLACK;
 	}
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
-void transplant(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allocator>::Node* u, typename map<Key,T,Compare,Allocator>::Node* v)
+void map<Key,T,Compare,Allocator>::transplant(Node* u, Node* v)
 {
 	if (!u->parent) 
 	{
-		m.root_ = v;
+		root_ = v;
 	}
 	else if (u == u->parent->left) 
 	{
@@ -561,46 +709,45 @@ void transplant(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allo
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
-void rb_delete_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare,Allocator>::Node* x, typename map<Key,T,Compare,Allocator>::Node* x_parent)
+void map<Key,T,Compare,Allocator>::delete_fixup(Node* x, Node* x_parent)
 {
-	using Node = typename map<Key,T,Compare,Allocator>::Node;
-	while (x != m.root_ && (!x || x->color == map<Key,T,Compare,Allocator>::BLACK))
+	while (x != root_ && (!x || x->color == BLACK))
 	{
 		if (x_parent && x == x_parent->left) 
 		{
 			Node* w = x_parent->right;
-			if (w && w->color == map<Key,T,Compare,Allocator>::RED) 
+			if (w && w->color == RED) 
 			{
-				w->color = map<Key,T,Compare,Allocator>::BLACK;
-				x_parent->color = map<Key,T,Compare,Allocator>::RED;
-				left_rotate(m, x_parent);
+				w->color = BLACK;
+				x_parent->color = RED;
+				left_rotate(x_parent);
 
 				w = x_parent->right;
 			}
-			if ((!w->left || w->left->color == map<Key,T,Compare,Allocator>::BLACK) && 
-			(!w->right || w->right->color == map<Key,T,Compare,Allocator>::BLACK)) 
+			if ((!w->left || w->left->color == BLACK) && 
+			(!w->right || w->right->color == BLACK)) 
 			{
 				if (w) 
 				{
-					w->color = map<Key,T,Compare,Allocator>::RED;
+					w->color = RED;
 				}
 				x = x_parent;
 				x_parent = x->parent;
 			} 
 			else 
 			{
-				if (!w->right || w->right->color == map<Key,T,Compare,Allocator>::BLACK) 
+				if (!w->right || w->right->color == BLACK) 
 				{
 					if (w->left) 
 					{
-						w->left->color = map<Key,T,Compare,Allocator>::BLACK;
+						w->left->color = BLACK;
 					}
 					if (w) 
 					{
-						w->color = map<Key,T,Compare,Allocator>::RED;
+						w->color = RED;
 					}
 
-					right_rotate(m, w);
+					right_rotate(w);
 					w = x_parent->right;
 				}
 
@@ -609,13 +756,13 @@ void rb_delete_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare
 					w->color = x_parent->color;
 				}
 
-				x_parent->color = map<Key,T,Compare,Allocator>::BLACK;
+				x_parent->color = BLACK;
 				if (w && w->right) 
 				{
-					w->right->color = map<Key,T,Compare,Allocator>::BLACK;
+					w->right->color = BLACK;
 				}
-				left_rotate(m, x_parent);
-				x = m.root_;
+				left_rotate(x_parent);
+				x = root_;
 				break;
 			}
 		} 
@@ -623,25 +770,25 @@ void rb_delete_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare
 		{
 			Node* w = x_parent ? x_parent->left : nullptr;
 
-			if (w && w->color == map<Key,T,Compare,Allocator>::RED) 
+			if (w && w->color == RED) 
 			{
-				w->color = map<Key,T,Compare,Allocator>::BLACK;
+				w->color = BLACK;
 				if (x_parent) 
 				{
-					x_parent->color = map<Key,T,Compare,Allocator>::RED;
+					x_parent->color = RED;
 				}
 				if (x_parent) 
 				{
-					right_rotate(m, x_parent);
+					right_rotate(x_parent);
 				}
 				w = x_parent ? x_parent->left : nullptr;
 			}
-			if ((!w->left || w->left->color == map<Key,T,Compare,Allocator>::BLACK) 
-			&& (!w->right || w->right->color == map<Key,T,Compare,Allocator>::BLACK)) 
+			if ((!w->left || w->left->color == BLACK) 
+			&& (!w->right || w->right->color == BLACK)) 
 			{
 				if (w) 
 				{
-					w->color = map<Key,T,Compare,Allocator>::RED;
+					w->color = RED;
 				}
 
 				x = x_parent;
@@ -649,72 +796,108 @@ void rb_delete_fixup(map<Key,T,Compare,Allocator>& m, typename map<Key,T,Compare
 			} 
 			else 
 			{
-				if (!w->left || w->left->color == map<Key,T,Compare,Allocator>::BLACK) 
+				if (!w->left || w->left->color == BLACK) 
 				{
 					if (w->right) 
 					{
-						w->right->color = map<Key,T,Compare,Allocator>::BLACK;
+						w->right->color = BLACK;
 					}
 					if (w) 
 					{
-						w->color = map<Key,T,Compare,Allocator>::RED;
+						w->color = RED;
 					}
 
-					left_rotate(m, w);
+					left_rotate(w);
 					w = x_parent ? x_parent->left : nullptr;
 				}
 
 				if (w) 
 				{
-					w->color = x_parent ? x_parent->color : map<Key,T,Compare,Allocator>::BLACK;
+					w->color = x_parent ? x_parent->color : BLACK;
 				}
 
 				if (x_parent) 
 				{
-					x_parent->color = map<Key,T,Compare,Allocator>::BLACK;
+					x_parent->color = BLACK;
 				}
 				if (w && w->left) 
 				{
-					w->left->color = map<Key,T,Compare,Allocator>::BLACK;
+					w->left->color = BLACK;
 				}
 				if (x_parent) 
 				{
-					right_rotate(m, x_parent);
+					right_rotate(x_parent);
 				}
-				x = m.root_;
+				x = root_;
 				break;
 			}
 		}
 	}
 	if (x) 
 	{
-		x->color = map<Key,T,Compare,Allocator>::BLACK;
+		x->color = BLACK;
 	}
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::Node*
-clone_subtree(const typename map<Key,T,Compare,Allocator>::Node* src, typename map<Key,T,Compare,Allocator>::Node* parent)
+map<Key,T,Compare,Allocator>::clone_subtree(const Node* src, Node* parent)
 {
 	if (!src) 
 	{
 		return nullptr;
 	}
 
-	using Map = map<Key,T,Compare,Allocator>;
-	auto* n = new typename Map::Node(src->kv);
+	Node* n = create_node(src->kv);
 
 	n->parent = parent;
+	n->color = src->color;
 
-	n->left = clone_subtree<Key,T,Compare,Allocator>(src->left, n);
-	n->right = clone_subtree<Key,T,Compare,Allocator>(src->right, n);
+	try
+	{
+		n->left = clone_subtree(src->left, n);
+		n->right = clone_subtree(src->right, n);
+	}
+	catch (...)
+	{
+		destroy_subtree(n);
+		throw;
+	}
 
 	return n;
 }
 
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::destroy_subtree(Node* n) noexcept
+{
+	if (!n) 
+	{
+		return;
+	}
+
+	std::vector<Node*> stack;
+	stack.push_back(n);
+
+	while (!stack.empty()) 
+	{
+		Node* cur = stack.back(); stack.pop_back();
+
+		if (cur->left) 
+		{
+			stack.push_back(cur->left);
+		}
+		if (cur->right) 
+		{
+			stack.push_back(cur->right);
+		}
+
+		destroy_node(cur);
+	}
+}
+
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::Node*
-maximum(typename map<Key,T,Compare,Allocator>::Node* n) 
+map<Key,T,Compare,Allocator>::maximum(Node* n) 
 {
 	if (!n) 
 	{
@@ -727,18 +910,54 @@ maximum(typename map<Key,T,Compare,Allocator>::Node* n)
 	return n;
 }
 
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::successor(Node* n)
+{
+	if (n->right)
+	{
+		return minimum(n->right);
+	}
+
+	Node* p = n->parent;
+	while (p && n == p->right)
+	{
+		n = p;
+		p = p->parent;
+	}
+	return p;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::predecessor(Node* n)
+{
+	if (n->left)
+	{
+		return maximum(n->left);
+	}
+
+	Node* p = n->parent;
+	while (p && n == p->left)
+	{
+		n = p;
+		p = p->parent;
+	}
+	return p;
+}
+
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::iterator
 map<Key,T,Compare,Allocator>::begin() noexcept 
 { 
-	return iterator(minimum(root_), this); 
+	return iterator(leftmost_, this); 
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::const_iterator
 map<Key,T,Compare,Allocator>::begin() const noexcept 
 { 
-	return const_iterator(minimum(root_), this); 
+	return const_iterator(leftmost_, this); 
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
@@ -786,30 +1005,8 @@ map<Key,T,Compare,Allocator>::rend() const noexcept
 template<typename Key, typename T, typename Compare, typename Allocator>
 void map<Key,T,Compare,Allocator>::clear() noexcept 
 {
-	if (!root_) 
-	{
-		return;
-	}
-
-	std::vector<Node*> stack;
-	stack.push_back(root_);
-
-	while (!stack.empty()) 
-	{
-		Node* n = stack.back(); stack.pop_back();
-
-		if (n->left) 
-		{
-			stack.push_back(n->left);
-		}
-		if (n->right) 
-		{
-			stack.push_back(n->right);
-		}
-
-		delete n;
-	}
-	root_ = nullptr;
+	destroy_subtree(root_);
+	root_ = leftmost_ = rightmost_ = nullptr;
 	size_ = 0;
 }
 
@@ -838,42 +1035,49 @@ map<Key,T,Compare,Allocator>::find(const key_type& key)
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 map<Key, T, Compare, Allocator>::map(const key_compare &comp, const allocator_type &alloc)
+	: comp_(comp), alloc_(alloc), node_alloc_(alloc)
 {
-	root_ = nullptr;
-	size_ = 0;
-	comp_ = comp;
-	alloc_ = alloc;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+map<Key,T,Compare,Allocator>::~map()
+{
+	clear();
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 map<Key,T,Compare,Allocator>::map(const map& other)
 	: root_(nullptr), comp_(other.comp_), alloc_(other.alloc_)
+	, node_alloc_(node_alloc_traits::select_on_container_copy_construction(other.node_alloc_))
 {
-	root_ = clone_subtree<Key,T,Compare,Allocator>(other.root_, nullptr);
+	root_ = clone_subtree(other.root_, nullptr);
 	size_ = other.size_;
+	reset_ends();
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 map<Key,T,Compare,Allocator>::map(map&& other) noexcept
-	: root_(other.root_), size_(other.size_), comp_(std::move(other.comp_)), alloc_(std::move(other.alloc_))
+	: root_(other.root_), leftmost_(other.leftmost_), rightmost_(other.rightmost_), size_(other.size_)
+	, comp_(std::move(other.comp_)), alloc_(std::move(other.alloc_)), node_alloc_(std::move(other.node_alloc_))
 {
-	other.root_ = nullptr;
+	other.root_ = other.leftmost_ = other.rightmost_ = nullptr;
 	other.size_ = 0;
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 map<Key, T, Compare, Allocator>::map(std::initializer_list<value_type> init, const key_compare &comp,
 	const allocator_type &alloc)
+	: comp_(comp), alloc_(alloc), node_alloc_(alloc)
 {
-	root_ = nullptr;
-	size_ = 0;
-	comp_ = comp;
-	alloc_ = alloc;
+	build_from(init.begin(), init.end());
+}
 
-	for (const auto &v : init) 
-	{
-		insert(v);
-	}
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename InputIt>
+map<Key, T, Compare, Allocator>::map(InputIt first, InputIt last, const key_compare &comp, const allocator_type &alloc)
+	: comp_(comp), alloc_(alloc), node_alloc_(alloc)
+{
+	build_from(first, last);
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
@@ -888,10 +1092,16 @@ map<Key,T,Compare,Allocator>::operator=(const map& other)
 	clear();
 
 	comp_ = other.comp_;
-	alloc_ = other.alloc_;
 
-	root_ = clone_subtree<Key,T,Compare,Allocator>(other.root_, nullptr);
+	if constexpr (node_alloc_traits::propagate_on_container_copy_assignment::value)
+	{
+		alloc_ = other.alloc_;
+		node_alloc_ = other.node_alloc_;
+	}
+
+	root_ = clone_subtree(other.root_, nullptr);
 	size_ = other.size_;
+	reset_ends();
 
 	return *this;
 }
@@ -908,12 +1118,19 @@ map<Key,T,Compare,Allocator>::operator=(map&& other) noexcept
 	clear();
 
 	root_ = other.root_;
+	leftmost_ = other.leftmost_;
+	rightmost_ = other.rightmost_;
 	size_ = other.size_;
 
 	comp_ = std::move(other.comp_);
-	alloc_ = std::move(other.alloc_);
 
-	other.root_ = nullptr;
+	if constexpr (node_alloc_traits::propagate_on_container_move_assignment::value)
+	{
+		alloc_ = std::move(other.alloc_);
+		node_alloc_ = std::move(other.node_alloc_);
+	}
+
+	other.root_ = other.leftmost_ = other.rightmost_ = nullptr;
 	other.size_ = 0;
 
 	return *this;
@@ -925,9 +1142,12 @@ void map<Key,T,Compare,Allocator>::swap(map& other) noexcept
 	using std::swap;
 	
 	swap(root_, other.root_);
+	swap(leftmost_, other.leftmost_);
+	swap(rightmost_, other.rightmost_);
 	swap(size_, other.size_);
 	swap(comp_, other.comp_);
 	swap(alloc_, other.alloc_);
+	swap(node_alloc_, other.node_alloc_);
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
@@ -1046,55 +1266,169 @@ std::pair<typename map<Key,T,Compare,Allocator>::iterator, bool>
 map<Key,T,Compare,Allocator>::insert(const value_type& v) 
 {
 	Node* parent = nullptr;
+	if (Node* existing = find_slot(v.first, parent))
+	{
+		return
+		{
+			iterator(existing, this),
+			false
+		};
+	}
+
+	Node* n = create_node(v);
+	attach(parent, n);
+	return
+	{
+		iterator(n, this),
+		true
+	};
+}
+
+// Returns the node holding key, or nullptr with parent set to where it would go.
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::find_slot(const key_type& key, Node*& parent) const
+{
+	parent = nullptr;
 	Node* cur = root_;
 	while (cur)
 	{
 		parent = cur;
 
-		if (!comp_(cur->kv.first, v.first) && !comp_(v.first, cur->kv.first))
+		if (comp_(key, cur->kv.first))
 		{
-			return
-			{
-				iterator(cur, this),
-				false
-			};
+			cur = cur->left;
 		}
-		if (comp_(v.first, cur->kv.first))
+		else if (comp_(cur->kv.first, key))
 		{
-			cur = cur->left;
+			cur = cur->right;
 		}
 		else
 		{
-			cur = cur->right;
+			return cur;
 		}
 	}
+	return nullptr;
+}
 
-	Node* n = map_create_node<Key,T,Compare,Allocator>(*this, v);
+// hint is an element next to where key belongs, on either side (the standard one is
+// the element after). When it is right this costs two comparisons and, away from the
+// ends, a short walk to the neighbouring node; when it is wrong it falls back to a
+// search from the root.
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::find_slot(const_iterator hint, const key_type& key, Node*& parent) const
+{
+	Node* h = const_cast<Node*>(hint.node);
+	if (!h)
+	{
+		if (!root_)
+		{
+			parent = nullptr;
+			return nullptr;
+		}
+		if (comp_(rightmost_->kv.first, key))
+		{
+			parent = rightmost_;
+			return nullptr;
+		}
+	}
+	else if (comp_(key, h->kv.first))
+	{
+		Node* before = h == leftmost_ ? nullptr : predecessor(h);
+		if (!before || comp_(before->kv.first, key))
+		{
+			// The new node hangs off whichever of the two has a free inner link.
+			parent = h->left ? before : h;
+			return nullptr;
+		}
+	}
+	else if (comp_(h->kv.first, key))
+	{
+		Node* after = h == rightmost_ ? nullptr : successor(h);
+		if (!after || comp_(key, after->kv.first))
+		{
+			parent = h->right ? after : h;
+			return nullptr;
+		}
+	}
+	else
+	{
+		return h;
+	}
+	return find_slot(key, parent);
+}
 
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::attach(Node* parent, Node* n)
+{
 	n->parent = parent;
 	n->left = n->right = nullptr;
 	n->color = RED;
 
 	if (!parent)
 	{
-		root_ = n;
+		root_ = leftmost_ = rightmost_ = n;
 	}
 	else if (comp_(n->kv.first, parent->kv.first))
 	{
 		parent->left = n;
+		if (parent == leftmost_)
+		{
+			leftmost_ = n;
+		}
 	}
 	else
 	{
 		parent->right = n;
+		if (parent == rightmost_)
+		{
+			rightmost_ = n;
+		}
 	}
 
 	++size_;
-	rb_insert_fixup<Key,T,Compare,Allocator>(*this, n);
-	return
+	insert_fixup(n);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::insert_return_type
+map<Key,T,Compare,Allocator>::insert(node_type&& nh)
+{
+	if (nh.empty())
 	{
-		iterator(n, this),
-		true
-	};
+		return {end(), false, node_type()};
+	}
+
+	Node* parent = nullptr;
+	if (Node* existing = find_slot(nh.key(), parent))
+	{
+		return {iterator(existing, this), false, std::move(nh)};
+	}
+
+	Node* n = nh.release();
+	attach(parent, n);
+	return {iterator(n, this), true, node_type()};
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::iterator
+map<Key,T,Compare,Allocator>::insert(const_iterator hint, node_type&& nh)
+{
+	if (nh.empty())
+	{
+		return end();
+	}
+
+	Node* parent = nullptr;
+	if (Node* existing = find_slot(hint, nh.key(), parent))
+	{
+		return iterator(existing, this);
+	}
+
+	Node* n = nh.release();
+	attach(parent, n);
+	return iterator(n, this);
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
@@ -1106,9 +1440,252 @@ map<Key,T,Compare,Allocator>::insert(value_type&& v)
 
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::iterator
-map<Key,T,Compare,Allocator>::insert(const_iterator /*hint*/, const value_type& v) 
+map<Key,T,Compare,Allocator>::insert(const_iterator hint, const value_type& v) 
+{
+	Node* parent = nullptr;
+	if (Node* existing = find_slot(hint, v.first, parent))
+	{
+		return iterator(existing, this);
+	}
+
+	Node* n = create_node(v);
+	attach(parent, n);
+	return iterator(n, this);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename InputIt>
+void map<Key,T,Compare,Allocator>::insert(InputIt first, InputIt last)
+{
+	if (!root_)
+	{
+		build_from(first, last);
+		return;
+	}
+
+	// Sorted input lands next to the previous element, so each hint is usually right.
+	const_iterator hint = end();
+	for (; first != last; ++first)
+	{
+		hint = insert(hint, *first);
+	}
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::insert(std::initializer_list<value_type> init)
 {
-	return insert(v).first;
+	insert(init.begin(), init.end());
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename Range>
+void map<Key,T,Compare,Allocator>::insert_range(Range&& range)
+{
+	using std::begin;
+	using std::end;
+
+	insert(begin(range), end(range));
+}
+
+// Fills an empty map from [first, last). Sorted input from a forward iterator takes a
+// single O(n) pass: the size is known, so each node is created and linked straight
+// into its place in a balanced tree as an in-order walk of that tree reaches it.
+// Anything else is gathered and handed to build_from_nodes.
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename InputIt>
+void map<Key,T,Compare,Allocator>::build_from(InputIt first, InputIt last)
+{
+	std::vector<Node*> nodes;
+	try
+	{
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+		{
+			const auto count = static_cast<size_type>(std::distance(first, last));
+			if (!count)
+			{
+				return;
+			}
+
+			nodes.reserve(count);
+			bool ascending = true;
+			Node* root = build_streaming(first, count, 0, deepest_level(count), nodes, ascending);
+			if (ascending)
+			{
+				root_ = root;
+				root_->parent = nullptr;
+				size_ = count;
+				leftmost_ = nodes.front();
+				rightmost_ = nodes.back();
+				return;
+			}
+			for (; first != last; ++first)
+			{
+				nodes.push_back(create_node(*first));
+			}
+		}
+		else
+		{
+			for (; first != last; ++first)
+			{
+				nodes.push_back(nullptr);
+				nodes.back() = create_node(*first);
+			}
+		}
+	}
+	catch (...)
+	{
+		for (Node* node : nodes)
+		{
+			destroy_node(node);
+		}
+		throw;
+	}
+
+	build_from_nodes(nodes);
+}
+
+// Builds the subtree of n nodes at depth in the shape build_balanced gives, taking the
+// keys from first in order. Every node created goes into made, which has room
+// reserved; at the first key not above its predecessor it clears ascending and
+// stops, leaving the links unfinished.
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<typename InputIt>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::build_streaming(InputIt& first, const size_type n, const size_type depth,
+	const size_type red_depth, std::vector<Node*>& made, bool& ascending)
+{
+	if (!n)
+	{
+		return nullptr;
+	}
+
+	const size_type left_count = (n - 1) / 2;
+	Node* left = build_streaming(first, left_count, depth + 1, red_depth, made, ascending);
+	if (!ascending)
+	{
+		return nullptr;
+	}
+
+	Node* root = create_node(*first);
+	++first;
+	made.push_back(root);
+	if (made.size() > 1 && !comp_(made[made.size() - 2]->kv.first, root->kv.first))
+	{
+		ascending = false;
+		return nullptr;
+	}
+
+	root->left = left;
+	if (left)
+	{
+		left->parent = root;
+	}
+	root->right = build_streaming(first, n - left_count - 1, depth + 1, red_depth, made, ascending);
+	if (root->right)
+	{
+		root->right->parent = root;
+	}
+	root->color = depth && depth == red_depth ? RED : BLACK;
+	return root;
+}
+
+// Links nodes created from unsorted input, given in input order, into the map. Nodes
+// breaking the ascending run are sorted on their own and merged back, so nearly sorted
+// input stays close to linear. Input positions travel with the nodes so that equal
+// keys meet in input order and, as with inserting one at a time, the first is kept.
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::build_from_nodes(std::vector<Node*>& nodes)
+{
+	const auto by_key = [this](const Node* a, const Node* b)
+	{
+		return comp_(a->kv.first, b->kv.first);
+	};
+
+	// Keep the ascending run in place and set aside what breaks it: a node smaller than
+	// the last kept one displaces that one if it still fits after the one before, so a
+	// single out-of-place node costs one set-aside rather than everything after it.
+	std::vector<size_type> run_pos(nodes.size());
+	std::vector<std::pair<Node*, size_type>> rest;
+	size_type n = 0;
+	for (size_type i = 0; i < nodes.size(); ++i)
+	{
+		Node* node = nodes[i];
+		if (!n || by_key(nodes[n - 1], node))
+		{
+			run_pos[n] = i;
+			nodes[n++] = node;
+		}
+		else if (!by_key(node, nodes[n - 1]))
+		{
+			destroy_node(node);
+		}
+		else if (n == 1 || by_key(nodes[n - 2], node))
+		{
+			rest.emplace_back(nodes[n - 1], run_pos[n - 1]);
+			run_pos[n - 1] = i;
+			nodes[n - 1] = node;
+		}
+		else
+		{
+			rest.emplace_back(node, i);
+		}
+	}
+
+	if (!rest.empty())
+	{
+		std::sort(rest.begin(), rest.end(), [&](const std::pair<Node*, size_type>& a, const std::pair<Node*, size_type>& b)
+		{
+			return by_key(a.first, b.first) || (!by_key(b.first, a.first) && a.second < b.second);
+		});
+
+		// Merge from the back: the run only moves towards the end, so nothing is
+		// overwritten before it is read.
+		size_type i = n;
+		size_type j = rest.size();
+		size_type out = n + rest.size();
+		while (j)
+		{
+			const std::pair<Node*, size_type>& r = rest[j - 1];
+			if (i && (by_key(r.first, nodes[i - 1]) || (!by_key(nodes[i - 1], r.first) && r.second < run_pos[i - 1])))
+			{
+				--i;
+				nodes[--out] = nodes[i];
+			}
+			else
+			{
+				nodes[--out] = r.first;
+				--j;
+			}
+		}
+
+		const size_type total = n + rest.size();
+		n = 0;
+		for (size_type k = 0; k < total; ++k)
+		{
+			if (n && !by_key(nodes[n - 1], nodes[k]))
+			{
+				destroy_node(nodes[k]);
+				continue;
+			}
+			nodes[n++] = nodes[k];
+		}
+	}
+
+	root_ = build_balanced(nodes.data(), n);
+	size_ = n;
+	reset_ends();
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::size_type
+map<Key,T,Compare,Allocator>::deepest_level(const size_type n) noexcept
+{
+	size_type deepest = 0;
+	while ((n >> (deepest + 1)) != 0)
+	{
+		++deepest;
+	}
+	return deepest;
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
@@ -1120,6 +1697,15 @@ map<Key,T,Compare,Allocator>::emplace(Args&&... args)
 	return insert(val);
 }
 
+template<typename Key, typename T, typename Compare, typename Allocator>
+template<class... Args>
+typename map<Key,T,Compare,Allocator>::iterator
+map<Key,T,Compare,Allocator>::emplace_hint(const_iterator hint, Args&&... args)
+{
+	value_type val(std::forward<Args>(args)...);
+	return insert(hint, val);
+}
+
 template<typename Key, typename T, typename Compare, typename Allocator>
 typename map<Key,T,Compare,Allocator>::mapped_type&
 map<Key,T,Compare,Allocator>::operator[](const key_type& key) 
@@ -1169,29 +1755,26 @@ map<Key,T,Compare,Allocator>::erase(const_iterator pos)
 
 	Node* z = const_cast<Node*>(pos.node);
 
-	iterator succ(pos.node, this);
+	iterator succ(z, this);
 	++succ;
 
-	auto transplant_local = [&](Node* u, Node* v)
-	{
-		if (!u->parent)
-		{
-			root_ = v;
-		}
-		else if (u == u->parent->left)
-		{
-			u->parent->left = v;
-		}
-		else
-		{
-			u->parent->right = v;
-		}
+	destroy_node(unlink_node(z));
+	return succ;
+}
 
-		if (v)
-		{
-			v->parent = u->parent;
-		}
-	};
+// Takes z out of the tree and rebalances; z itself is left untouched for the caller.
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::unlink_node(Node* z)
+{
+	if (z == leftmost_)
+	{
+		leftmost_ = successor(z);
+	}
+	if (z == rightmost_)
+	{
+		rightmost_ = predecessor(z);
+	}
 
 	Node* y = z;
 	auto y_original_color = y->color;
@@ -1203,13 +1786,13 @@ map<Key,T,Compare,Allocator>::erase(const_iterator pos)
 	{
 		x = z->right;
 		x_parent = z->parent;
-		transplant_local(z, z->right);
+		transplant(z, z->right);
 	}
 	else if (!z->right)
 	{
 		x = z->left;
 		x_parent = z->parent;
-		transplant_local(z, z->left);
+		transplant(z, z->left);
 	}
 	else
 	{
@@ -1227,7 +1810,7 @@ map<Key,T,Compare,Allocator>::erase(const_iterator pos)
 		}
 		else
 		{
-			transplant_local(y, y->right);
+			transplant(y, y->right);
 			y->right = z->right;
 
 			if (y->right)
@@ -1237,7 +1820,7 @@ map<Key,T,Compare,Allocator>::erase(const_iterator pos)
 			x_parent = y->parent;
 		}
 
-		transplant_local(z, y);
+		transplant(z, y);
 		y->left = z->left;
 
 		if (y->left)
@@ -1247,14 +1830,13 @@ map<Key,T,Compare,Allocator>::erase(const_iterator pos)
 		y->color = z->color;
 	}
 
-	map_destroy_node<Key,T,Compare,Allocator>(*this, z);
 	--size_;
 
 	if (y_original_color == BLACK)
 	{
-		rb_delete_fixup<Key,T,Compare,Allocator>(*this, x, x_parent);
+		delete_fixup(x, x_parent);
 	}
-	return succ;
+	return z;
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
@@ -1278,39 +1860,189 @@ bool map<Key,T,Compare,Allocator>::contains(const key_type& key) const
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
-std::optional<typename map<Key,T,Compare,Allocator>::value_type>
+typename map<Key,T,Compare,Allocator>::node_type
+map<Key,T,Compare,Allocator>::extract(const_iterator pos)
+{
+	return node_type(unlink_node(const_cast<Node*>(pos.node)), node_alloc_);
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::node_type
 map<Key,T,Compare,Allocator>::extract(const key_type& key)
 {
 	auto it = find(key);
 
 	if (it == end())
 	{
-		return std::nullopt;
+		return node_type();
 	}
-
-	value_type val = std::move(it.node->kv);
-	erase(it);
-	return val;
+	return extract(it);
 }
 
+// Moves every node whose key is not already here out of other; the rest stay behind.
+// Nodes are relinked, never copied or reallocated, unless the two allocators differ.
 template<typename Key, typename T, typename Compare, typename Allocator>
 void map<Key,T,Compare,Allocator>::merge(map& other)
 {
-	while (other.root_)
+	if (this == &other || !other.root_)
+	{
+		return;
+	}
+
+	if constexpr (!node_alloc_traits::is_always_equal::value)
+	{
+		if (!(node_alloc_ == other.node_alloc_))
+		{
+			for (Node* n = minimum(other.root_); n;)
+			{
+				Node* next = successor(n);
+				Node* parent = nullptr;
+				if (!find_slot(n->kv.first, parent))
+				{
+					attach(parent, create_node(std::move(n->kv)));
+					other.destroy_node(other.unlink_node(n));
+				}
+				n = next;
+			}
+			return;
+		}
+	}
+
+	if (!root_)
+	{
+		std::swap(root_, other.root_);
+		std::swap(leftmost_, other.leftmost_);
+		std::swap(rightmost_, other.rightmost_);
+		std::swap(size_, other.size_);
+		return;
+	}
+
+	// Relinking costs a search and a rebalance per node moved, the linear merge a walk
+	// over both trees plus a rebuild; with nodes scattered in memory each of those is a
+	// cache miss per node, so relinking wins until other holds roughly 8 / log2(n) of
+	// the total (about 40% at a million nodes).
+	const size_type total = size_ + other.size_;
+	size_type depth = 0;
+	while ((size_type{1} << depth) < total)
+	{
+		++depth;
+	}
+	if (other.size_ * depth > 8 * total)
+	{
+		merge_linear(other);
+		return;
+	}
+
+	for (Node* n = minimum(other.root_); n;)
+	{
+		Node* next = successor(n);
+		Node* parent = nullptr;
+		if (!find_slot(n->kv.first, parent))
+		{
+			attach(parent, other.unlink_node(n));
+		}
+		n = next;
+	}
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::merge(map&& other)
+{
+	merge(other);
+}
+
+// Walks both trees in step, then rebuilds both maps balanced from the merged node
+// order. Only an array of node pointers is allocated; the nodes themselves move.
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::merge_linear(map& other)
+{
+	std::vector<Node*> merged;
+	std::vector<Node*> kept;
+	merged.reserve(size_ + other.size_);
+
+	Node* a = minimum(root_);
+	Node* b = minimum(other.root_);
+	while (a && b)
 	{
-		Node* n = minimum(other.root_);
-		if (!n)
+		if (comp_(b->kv.first, a->kv.first))
 		{
-			break;
+			merged.push_back(b);
+			b = successor(b);
+			continue;
 		}
 
-		auto kv = other.extract(n->kv.first);
-		if (!kv)
+		if (!comp_(a->kv.first, b->kv.first))
 		{
-			break;
+			kept.push_back(b);
+			b = successor(b);
 		}
-		insert(std::move(*kv));
+		merged.push_back(a);
+		a = successor(a);
+	}
+	for (; a; a = successor(a))
+	{
+		merged.push_back(a);
+	}
+	for (; b; b = successor(b))
+	{
+		merged.push_back(b);
+	}
+
+	size_ = merged.size();
+	other.size_ = kept.size();
+	root_ = build_balanced(merged.data(), merged.size());
+	other.root_ = build_balanced(kept.data(), kept.size());
+	reset_ends();
+	other.reset_ends();
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+void map<Key,T,Compare,Allocator>::reset_ends() noexcept
+{
+	leftmost_ = minimum(root_);
+	rightmost_ = maximum(root_);
+}
+
+// Builds a tree of minimal height from n nodes in key order. Every null link then
+// sits on one of the two lowest levels, so colouring the deepest level red and the
+// rest black satisfies the red-black rules.
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::build_balanced(Node* const* nodes, const size_type n) noexcept
+{
+	Node* root = build_subtree(nodes, n, 0, deepest_level(n));
+	if (root)
+	{
+		root->parent = nullptr;
+	}
+	return root;
+}
+
+template<typename Key, typename T, typename Compare, typename Allocator>
+typename map<Key,T,Compare,Allocator>::Node*
+map<Key,T,Compare,Allocator>::build_subtree(Node* const* nodes, const size_type n, const size_type depth,
+	const size_type red_depth) noexcept
+{
+	if (!n)
+	{
+		return nullptr;
+	}
+
+	const size_type left_count = (n - 1) / 2;
+	Node* root = nodes[left_count];
+
+	root->left = build_subtree(nodes, left_count, depth + 1, red_depth);
+	if (root->left)
+	{
+		root->left->parent = root;
+	}
+	root->right = build_subtree(nodes + left_count + 1, n - left_count - 1, depth + 1, red_depth);
+	if (root->right)
+	{
+		root->right->parent = root;
 	}
+	root->color = depth && depth == red_depth ? RED : BLACK;
+	return root;
 }
 
 template<typename Key, typename T, typename Compare, typename Allocator>
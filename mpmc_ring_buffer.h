@@ -0,0 +1,264 @@
+#pragma once
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Bounded multi-producer/multi-consumer queue. Every cell carries a sequence number
+// that tells a producer (seq == pos) or consumer (seq == pos + 1) whether the cell is
+// ready for this lap, so producers and consumers only contend on their own index.
+template<typename T>
+class mpmc_ring_buffer
+{
+public:
+    static constexpr std::size_t cache_line = 64;
+
+    explicit mpmc_ring_buffer(const std::size_t capacity)
+        : mask_(round_up_pow2(capacity < 2 ? 2 : capacity) - 1)
+        , cells_(static_cast<cell*>(::operator new((mask_ + 1) * sizeof(cell), std::align_val_t(cell_align))))
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+        {
+            ::new (static_cast<void*>(cells_ + i)) cell(i);
+        }
+    }
+
+    mpmc_ring_buffer(const mpmc_ring_buffer&) = delete;
+    mpmc_ring_buffer& operator=(const mpmc_ring_buffer&) = delete;
+
+    ~mpmc_ring_buffer()
+    {
+        const std::size_t end = enqueue_.load(std::memory_order_relaxed);
+        for (std::size_t pos = dequeue_.load(std::memory_order_relaxed); pos != end; ++pos)
+        {
+            cells_[pos & mask_].value()->~T();
+        }
+        for (std::size_t i = 0; i <= mask_; ++i)
+        {
+            cells_[i].~cell();
+        }
+        ::operator delete(cells_, std::align_val_t(cell_align));
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        cell* c;
+
+        while (true)
+        {
+            c = cells_ + (pos & mask_);
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(c->storage)) T(std::forward<Args>(args)...);
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& v)
+    {
+        return try_emplace(v);
+    }
+
+    bool try_push(T&& v)
+    {
+        return try_emplace(std::move(v));
+    }
+
+    bool try_pop(T& out)
+    {
+        std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        cell* c;
+
+        while (true)
+        {
+            c = cells_ + (pos & mask_);
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* v = c->value();
+        out = std::move(*v);
+        v->~T();
+        c->seq.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Claims a run of consecutive free cells with one CAS. A cell whose sequence matches
+    // its position can only be taken by whoever moves enqueue_ past it, so checking the
+    // run before the CAS is enough.
+    template<typename InputIt>
+    std::size_t push_n(InputIt first, const std::size_t n)
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        std::size_t count;
+
+        while (true)
+        {
+            count = ready_run(pos, n, 0);
+            if (count == 0)
+            {
+                if (cells_[pos & mask_].seq.load(std::memory_order_acquire) < pos)
+                {
+                    return 0;
+                }
+                pos = enqueue_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            cell& c = cells_[(pos + i) & mask_];
+            ::new (static_cast<void*>(c.storage)) T(*first);
+            c.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    template<typename OutputIt>
+    std::size_t pop_n(OutputIt out, const std::size_t n)
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+
+        std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        std::size_t count;
+
+        while (true)
+        {
+            count = ready_run(pos, n, 1);
+            if (count == 0)
+            {
+                if (cells_[pos & mask_].seq.load(std::memory_order_acquire) < pos + 1)
+                {
+                    return 0;
+                }
+                pos = dequeue_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (std::size_t i = 0; i < count; ++i, ++out)
+        {
+            cell& c = cells_[(pos + i) & mask_];
+            T* v = c.value();
+            *out = std::move(*v);
+            v->~T();
+            c.seq.store(pos + i + mask_ + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    [[nodiscard]] std::size_t size_approx() const noexcept
+    {
+        const std::size_t d = dequeue_.load(std::memory_order_acquire);
+        const std::size_t e = enqueue_.load(std::memory_order_acquire);
+        return e > d ? e - d : 0;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_approx() == 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+private:
+    struct cell
+    {
+        explicit cell(const std::size_t s) noexcept : seq(s) {}
+
+        T* value() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        std::atomic<std::size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr std::size_t cell_align = alignof(cell) > cache_line ? alignof(cell) : cache_line;
+
+    static std::size_t round_up_pow2(const std::size_t n) noexcept
+    {
+        std::size_t cap = 1;
+        while (cap < n)
+        {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    // Number of consecutive cells from pos (at most n) whose sequence is pos + i + lap.
+    std::size_t ready_run(const std::size_t pos, const std::size_t n, const std::size_t lap) const noexcept
+    {
+        const std::size_t limit = n < capacity() ? n : capacity();
+        std::size_t count = 0;
+        while (count < limit && cells_[(pos + count) & mask_].seq.load(std::memory_order_acquire) == pos + count + lap)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    const std::size_t mask_;
+    cell* const cells_;
+
+    alignas(cache_line) std::atomic<std::size_t> enqueue_{0};
+    alignas(cache_line) std::atomic<std::size_t> dequeue_{0};
+};
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+namespace mib
+{
+// Not thread-safe: one arena per request/owner. Blocks up to max_pooled_size are
+// recycled through per-size-class free lists; everything is returned at once by release().
+class arena_resource
+{
+public:
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+    static constexpr std::size_t size_class_count = 32;
+    static constexpr std::size_t max_pooled_size = alignment * size_class_count;
+    static constexpr std::size_t default_chunk_size = 64 * 1024;
+    static constexpr std::size_t max_chunk_size = 16 * 1024 * 1024;
+
+    explicit arena_resource(const std::size_t initial_chunk_size = default_chunk_size) noexcept
+        : next_chunk_size_(std::max<std::size_t>(initial_chunk_size, max_pooled_size + sizeof(chunk_header)))
+    {}
+
+    arena_resource(const arena_resource&) = delete;
+    arena_resource& operator=(const arena_resource&) = delete;
+
+    ~arena_resource()
+    {
+        release();
+    }
+
+    void* allocate(const std::size_t bytes, const std::size_t align = alignment)
+    {
+        if (bytes <= max_pooled_size && align <= alignment)
+        {
+            const std::size_t cls = size_class(bytes);
+
+            if (free_block* b = free_lists_[cls])
+            {
+                free_lists_[cls] = b->next;
+                return b;
+            }
+            return bump(class_size(cls), alignment);
+        }
+        return bump(bytes, std::max(align, alignment));
+    }
+
+    void deallocate(void* p, const std::size_t bytes, const std::size_t align = alignment) noexcept
+    {
+        if (!p || bytes > max_pooled_size || align > alignment)
+        {
+            return;
+        }
+
+        const std::size_t cls = size_class(bytes);
+        auto* b = static_cast<free_block*>(p);
+
+        b->next = free_lists_[cls];
+        free_lists_[cls] = b;
+    }
+
+    void release() noexcept
+    {
+        while (chunks_)
+        {
+            chunk_header* next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+
+        std::fill_n(free_lists_, size_class_count, nullptr);
+        cur_ = end_ = nullptr;
+        bytes_reserved_ = 0;
+    }
+
+    [[nodiscard]] std::size_t bytes_reserved() const noexcept
+    {
+        return bytes_reserved_;
+    }
+
+private:
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct alignas(alignment) chunk_header
+    {
+        chunk_header* next;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t size_class(const std::size_t bytes) noexcept
+    {
+        return bytes == 0 ? 0 : (bytes - 1) / alignment;
+    }
+
+    static constexpr std::size_t class_size(const std::size_t cls) noexcept
+    {
+        return (cls + 1) * alignment;
+    }
+
+    static char* align_up(char* p, const std::size_t align) noexcept
+    {
+        const auto v = reinterpret_cast<std::uintptr_t>(p);
+        return reinterpret_cast<char*>((v + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+    }
+
+    void* bump(const std::size_t bytes, const std::size_t align)
+    {
+        char* p = align_up(cur_, align);
+
+        if (!cur_ || p + bytes > end_)
+        {
+            add_chunk(bytes + align);
+            p = align_up(cur_, align);
+        }
+
+        cur_ = align_up(p + bytes, alignment);
+        return p;
+    }
+
+    void add_chunk(const std::size_t min_payload)
+    {
+        const std::size_t size = std::max(next_chunk_size_, min_payload + sizeof(chunk_header));
+        auto* c = static_cast<chunk_header*>(::operator new(size));
+
+        c->next = chunks_;
+        c->size = size;
+        chunks_ = c;
+
+        cur_ = reinterpret_cast<char*>(c) + sizeof(chunk_header);
+        end_ = reinterpret_cast<char*>(c) + size;
+        bytes_reserved_ += size;
+
+        next_chunk_size_ = std::min(next_chunk_size_ * 2, max_chunk_size);
+    }
+
+    free_block* free_lists_[size_class_count] = {};
+    chunk_header* chunks_ = nullptr;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    std::size_t next_chunk_size_;
+    std::size_t bytes_reserved_ = 0;
+};
+
+// Default-constructed instances fall back to global new/delete,
+// so pool_allocator<T> can replace std::allocator<T> without an arena in scope.
+template<typename T>
+class pool_allocator
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    pool_allocator() noexcept = default;
+    pool_allocator(arena_resource* resource) noexcept : resource_(resource) {}
+
+    template<typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept : resource_(other.resource()) {}
+
+    T* allocate(const size_type n)
+    {
+        if (resource_)
+        {
+            return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+        else
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* p, const size_type n) noexcept
+    {
+        if (resource_)
+        {
+            resource_->deallocate(p, n * sizeof(T), alignof(T));
+            return;
+        }
+
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    [[nodiscard]] arena_resource* resource() const noexcept
+    {
+        return resource_;
+    }
+
+    template<typename U>
+    friend bool operator==(const pool_allocator& a, const pool_allocator<U>& b) noexcept
+    {
+        return a.resource() == b.resource();
+    }
+
+    template<typename U>
+    friend bool operator!=(const pool_allocator& a, const pool_allocator<U>& b) noexcept
+    {
+        return a.resource() != b.resource();
+    }
+
+private:
+    arena_resource* resource_ = nullptr;
+};
+}
@@ -1,20 +1,89 @@
 #pragma once
 #include <vector>
+#include <limits>
+#include <cstddef>
+#include <utility>
 #include <algorithm>
+#include <stdexcept>
+#include <functional>
 
-template<typename T>
+// Implicit d-ary heap, ordered like std::priority_queue: top() is the element that
+// no other compares greater than under Compare. The default arity of 4 keeps a
+// node's children on one cache line for small T and halves the tree depth, at the
+// cost of a few more comparisons per level on the way down.
+template<typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
 class priority_queue
 {
+    static_assert(Arity >= 2, "priority_queue: Arity must be at least 2");
+
 public:
+    priority_queue() = default;
+
+    explicit priority_queue(const Compare& comp): comp_(comp) {}
+
+    // O(n) bottom-up construction.
+    explicit priority_queue(std::vector<T> values, const Compare& comp = Compare())
+        : data_(std::move(values))
+        , comp_(comp)
+    {
+        make_heap();
+    }
+
+    template<typename InputIt>
+    priority_queue(InputIt first, InputIt last, const Compare& comp = Compare())
+        : data_(first, last)
+        , comp_(comp)
+    {
+        make_heap();
+    }
+
     void push(const T& v)
     {
         data_.push_back(v);
-        std::push_heap(data_.begin(), data_.end());
+        sift_up(data_.size() - 1);
+    }
+
+    void push(T&& v)
+    {
+        data_.push_back(std::move(v));
+        sift_up(data_.size() - 1);
     }
 
+    template<typename... Args>
+    void emplace(Args&&... args)
+    {
+        data_.emplace_back(std::forward<Args>(args)...);
+        sift_up(data_.size() - 1);
+    }
+
+    // The hole left by the top is walked down to a leaf without comparing against the
+    // refill element, which then sifts up from there; it rarely climbs far, so this
+    // saves one unpredictable comparison per level over a plain sift_down.
     void pop()
     {
-        std::pop_heap(data_.begin(), data_.end()); data_.pop_back();
+        const std::size_t n = data_.size() - 1;
+        std::size_t i = 0;
+        while (true)
+        {
+            const std::size_t first = i * Arity + 1;
+            if (first >= n)
+            {
+                break;
+            }
+            const std::size_t best = best_child(first, std::min(first + Arity, n));
+            data_[i] = std::move(data_[best]);
+            i = best;
+        }
+        if (i != n)
+        {
+            data_[i] = std::move(data_.back());
+            data_.pop_back();
+            sift_up(i);
+        }
+        else
+        {
+            data_.pop_back();
+        }
     }
 
     const T& top() const
@@ -26,6 +95,360 @@ public:
     {
         return data_.empty();
     }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return data_.size();
+    }
+
+    void reserve(const std::size_t n)
+    {
+        data_.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+        data_.clear();
+    }
+
 private:
+    void make_heap()
+    {
+        if (data_.size() < 2)
+        {
+            return;
+        }
+        for (std::size_t i = (data_.size() - 2) / Arity + 1; i-- > 0;)
+        {
+            sift_down(i);
+        }
+    }
+
+    // Both sifts carry the moving element in a hole instead of swapping at each level.
+    void sift_up(std::size_t i)
+    {
+        T v = std::move(data_[i]);
+        while (i)
+        {
+            const std::size_t parent = (i - 1) / Arity;
+            if (!comp_(data_[parent], v))
+            {
+                break;
+            }
+            data_[i] = std::move(data_[parent]);
+            i = parent;
+        }
+        data_[i] = std::move(v);
+    }
+
+    void sift_down(std::size_t i)
+    {
+        const std::size_t n = data_.size();
+        T v = std::move(data_[i]);
+        while (true)
+        {
+            const std::size_t first = i * Arity + 1;
+            if (first >= n)
+            {
+                break;
+            }
+            const std::size_t best = best_child(first, std::min(first + Arity, n));
+            if (!comp_(v, data_[best]))
+            {
+                break;
+            }
+            data_[i] = std::move(data_[best]);
+            i = best;
+        }
+        data_[i] = std::move(v);
+    }
+
+    // Tracks a pointer rather than an index: compilers then keep the comparison as a
+    // branch, so the next level's loads can be issued speculatively instead of waiting
+    // on a conditional move.
+    std::size_t best_child(const std::size_t first, const std::size_t last) const
+    {
+        const T* base = data_.data();
+        const T* best = base + first;
+        if (last - first == Arity)
+        {
+            // Fixed trip count for the common full-node case, so the loop unrolls.
+            for (std::size_t c = first + 1; c < first + Arity; ++c)
+            {
+                if (comp_(*best, base[c]))
+                {
+                    best = base + c;
+                }
+            }
+        }
+        else
+        {
+            for (std::size_t c = first + 1; c < last; ++c)
+            {
+                if (comp_(*best, base[c]))
+                {
+                    best = base + c;
+                }
+            }
+        }
+        return static_cast<std::size_t>(best - base);
+    }
+
     std::vector<T> data_;
+    Compare comp_;
+};
+
+// d-ary heap whose elements can be changed or removed after insertion. push() hands
+// out a handle that stays valid until the element is popped or erased; handles are
+// then reused. promote() moves an element towards the top and demote() away from it,
+// whatever Compare is: in a std::greater min-heap, as in Dijkstra, a shorter distance
+// is a promote. Both check their direction and fall back to update(), which works it
+// out itself, so a value moving the other way still leaves a valid heap.
+template<typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class indexed_priority_queue
+{
+    static_assert(Arity >= 2, "indexed_priority_queue: Arity must be at least 2");
+
+public:
+    using handle = std::size_t;
+
+    indexed_priority_queue() = default;
+
+    explicit indexed_priority_queue(const Compare& comp): comp_(comp) {}
+
+    handle push(const T& v)
+    {
+        return emplace(v);
+    }
+
+    handle push(T&& v)
+    {
+        return emplace(std::move(v));
+    }
+
+    template<typename... Args>
+    handle emplace(Args&&... args)
+    {
+        const handle h = acquire_handle();
+        heap_.push_back(entry{T(std::forward<Args>(args)...), h});
+        pos_[h] = heap_.size() - 1;
+        sift_up(heap_.size() - 1);
+        return h;
+    }
+
+    const T& top() const
+    {
+        return heap_.front().value;
+    }
+
+    [[nodiscard]] handle top_handle() const
+    {
+        return heap_.front().id;
+    }
+
+    void pop()
+    {
+        remove_at(0);
+    }
+
+    [[nodiscard]] bool contains(const handle h) const noexcept
+    {
+        return h < pos_.size() && pos_[h] != npos_pos;
+    }
+
+    const T& value(const handle h) const
+    {
+        check_handle(h);
+        return heap_[pos_[h]].value;
+    }
+
+    // For a new value that ranks at least as close to the top as the current one.
+    void promote(const handle h, T v)
+    {
+        check_handle(h);
+        const std::size_t i = pos_[h];
+        if (comp_(v, heap_[i].value))
+        {
+            update(h, std::move(v));
+            return;
+        }
+        heap_[i].value = std::move(v);
+        sift_up(i);
+    }
+
+    // For a new value that ranks no closer to the top than the current one.
+    void demote(const handle h, T v)
+    {
+        check_handle(h);
+        const std::size_t i = pos_[h];
+        if (comp_(heap_[i].value, v))
+        {
+            update(h, std::move(v));
+            return;
+        }
+        heap_[i].value = std::move(v);
+        sift_down(i);
+    }
+
+    void update(const handle h, T v)
+    {
+        check_handle(h);
+        const std::size_t i = pos_[h];
+        const bool up = comp_(heap_[i].value, v);
+        heap_[i].value = std::move(v);
+        if (up)
+        {
+            sift_up(i);
+        }
+        else
+        {
+            sift_down(i);
+        }
+    }
+
+    void erase(const handle h)
+    {
+        check_handle(h);
+        remove_at(pos_[h]);
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return heap_.empty();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return heap_.size();
+    }
+
+    void reserve(const std::size_t n)
+    {
+        heap_.reserve(n);
+        pos_.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+        heap_.clear();
+        pos_.clear();
+        free_.clear();
+    }
+
+private:
+    static constexpr std::size_t npos_pos = std::numeric_limits<std::size_t>::max();
+
+    struct entry
+    {
+        T value;
+        handle id;
+    };
+
+    handle acquire_handle()
+    {
+        if (!free_.empty())
+        {
+            const handle h = free_.back();
+            free_.pop_back();
+            return h;
+        }
+        pos_.push_back(npos_pos);
+        return pos_.size() - 1;
+    }
+
+    void check_handle(const handle h) const
+    {
+        if (!contains(h))
+        {
+            throw std::invalid_argument("indexed_priority_queue: stale or unknown handle");
+        }
+    }
+
+    void remove_at(const std::size_t i)
+    {
+        const handle h = heap_[i].id;
+        pos_[h] = npos_pos;
+        free_.push_back(h);
+
+        if (i + 1 == heap_.size())
+        {
+            heap_.pop_back();
+            return;
+        }
+
+        place(i, std::move(heap_.back()));
+        heap_.pop_back();
+        if (i && comp_(heap_[(i - 1) / Arity].value, heap_[i].value))
+        {
+            sift_up(i);
+        }
+        else
+        {
+            sift_down(i);
+        }
+    }
+
+    void place(const std::size_t i, entry&& e)
+    {
+        heap_[i] = std::move(e);
+        pos_[heap_[i].id] = i;
+    }
+
+    void sift_up(std::size_t i)
+    {
+        entry e = std::move(heap_[i]);
+        while (i)
+        {
+            const std::size_t parent = (i - 1) / Arity;
+            if (!comp_(heap_[parent].value, e.value))
+            {
+                break;
+            }
+            place(i, std::move(heap_[parent]));
+            i = parent;
+        }
+        place(i, std::move(e));
+    }
+
+    void sift_down(std::size_t i)
+    {
+        const std::size_t n = heap_.size();
+        entry e = std::move(heap_[i]);
+        while (true)
+        {
+            const std::size_t first = i * Arity + 1;
+            if (first >= n)
+            {
+                break;
+            }
+            const std::size_t best = best_child(first, std::min(first + Arity, n));
+            if (!comp_(e.value, heap_[best].value))
+            {
+                break;
+            }
+            place(i, std::move(heap_[best]));
+            i = best;
+        }
+        place(i, std::move(e));
+    }
+
+    // Pointer-tracking for the same reason as in priority_queue.
+    std::size_t best_child(const std::size_t first, const std::size_t last) const
+    {
+        const entry* base = heap_.data();
+        const entry* best = base + first;
+        for (std::size_t c = first + 1; c < last; ++c)
+        {
+            if (comp_(best->value, base[c].value))
+            {
+                best = base + c;
+            }
+        }
+        return static_cast<std::size_t>(best - base);
+    }
+
+    std::vector<entry> heap_;
+    std::vector<std::size_t> pos_;
+    std::vector<handle> free_;
+    Compare comp_;
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+
+namespace mib
+{
+template<typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template<typename Alloc, typename = void>
+struct has_reallocate : std::false_type {};
+
+template<typename Alloc>
+struct has_reallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), std::size_t{}, std::size_t{}))>> : std::true_type {};
+
+template<typename Alloc>
+inline constexpr bool has_reallocate_v = has_reallocate<Alloc>::value;
+}
@@ -0,0 +1,980 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <variant>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <initializer_list>
+
+#include "bit_ops.h"
+#include "dynamic_bitset.h"
+
+// Compressed bitmap over uint32 values (Roaring layout): the high 16 bits pick a
+// chunk, and each non-empty chunk stores its low 16 bits as a sorted array (up to
+// 4096 values), a 65536-bit bitmap, or a list of runs, whichever is smallest.
+
+namespace mib
+{
+namespace detail
+{
+constexpr std::uint32_t roaring_array_max = 4096;
+constexpr std::size_t roaring_words = 1024;
+
+struct roaring_array
+{
+    std::vector<std::uint16_t> values;
+};
+
+struct roaring_bits
+{
+    std::vector<std::uint64_t> words = std::vector<std::uint64_t>(roaring_words);
+    std::uint32_t card = 0;
+};
+
+// Inclusive range [start, last].
+struct roaring_run
+{
+    std::uint16_t start;
+    std::uint16_t last;
+};
+
+struct roaring_runs
+{
+    std::vector<roaring_run> runs;
+};
+
+using roaring_container = std::variant<roaring_array, roaring_bits, roaring_runs>;
+
+inline void set_range(std::uint64_t* w, const std::uint32_t start, const std::uint32_t last) noexcept
+{
+    const std::uint32_t first_word = start / 64;
+    const std::uint32_t last_word = last / 64;
+    const std::uint64_t first_mask = ~std::uint64_t{0} << (start % 64);
+    const std::uint64_t last_mask = ~std::uint64_t{0} >> (63 - last % 64);
+
+    if (first_word == last_word)
+    {
+        w[first_word] |= first_mask & last_mask;
+        return;
+    }
+    w[first_word] |= first_mask;
+    for (std::uint32_t i = first_word + 1; i < last_word; ++i)
+    {
+        w[i] = ~std::uint64_t{0};
+    }
+    w[last_word] |= last_mask;
+}
+
+inline void clear_range(std::uint64_t* w, const std::uint32_t start, const std::uint32_t last) noexcept
+{
+    const std::uint32_t first_word = start / 64;
+    const std::uint32_t last_word = last / 64;
+    const std::uint64_t first_mask = ~std::uint64_t{0} << (start % 64);
+    const std::uint64_t last_mask = ~std::uint64_t{0} >> (63 - last % 64);
+
+    if (first_word == last_word)
+    {
+        w[first_word] &= ~(first_mask & last_mask);
+        return;
+    }
+    w[first_word] &= ~first_mask;
+    for (std::uint32_t i = first_word + 1; i < last_word; ++i)
+    {
+        w[i] = 0;
+    }
+    w[last_word] &= ~last_mask;
+}
+
+inline std::uint32_t cardinality(const roaring_container& c) noexcept
+{
+    switch (c.index())
+    {
+    case 0:
+        return static_cast<std::uint32_t>(std::get<0>(c).values.size());
+    case 1:
+        return std::get<1>(c).card;
+    default:
+    {
+        std::uint32_t n = 0;
+        for (const roaring_run& r : std::get<2>(c).runs)
+        {
+            n += static_cast<std::uint32_t>(r.last - r.start) + 1;
+        }
+        return n;
+    }
+    }
+}
+
+inline bool contains(const roaring_container& c, const std::uint16_t x) noexcept
+{
+    switch (c.index())
+    {
+    case 0:
+    {
+        const auto& v = std::get<0>(c).values;
+        return std::binary_search(v.begin(), v.end(), x);
+    }
+    case 1:
+        return std::get<1>(c).words[x / 64] >> (x % 64) & 1;
+    default:
+    {
+        const auto& runs = std::get<2>(c).runs;
+        auto it = std::upper_bound(runs.begin(), runs.end(), x, [](const std::uint16_t v, const roaring_run& r)
+        {
+            return v < r.start;
+        });
+        return it != runs.begin() && x <= std::prev(it)->last;
+    }
+    }
+}
+
+template<typename F>
+void for_each(const roaring_container& c, F& f)
+{
+    switch (c.index())
+    {
+    case 0:
+        for (const std::uint16_t v : std::get<0>(c).values)
+        {
+            f(v);
+        }
+        break;
+    case 1:
+    {
+        const auto& w = std::get<1>(c).words;
+        for (std::size_t i = 0; i < roaring_words; ++i)
+        {
+            for (std::uint64_t word = w[i]; word; word &= word - 1)
+            {
+                f(static_cast<std::uint16_t>(i * 64 + static_cast<std::size_t>(countr_zero(word))));
+            }
+        }
+        break;
+    }
+    default:
+        for (const roaring_run& r : std::get<2>(c).runs)
+        {
+            for (std::uint32_t v = r.start; v <= r.last; ++v)
+            {
+                f(static_cast<std::uint16_t>(v));
+            }
+        }
+        break;
+    }
+}
+
+// Largest value in a non-empty container.
+inline std::uint16_t last_value(const roaring_container& c) noexcept
+{
+    switch (c.index())
+    {
+    case 0:
+        return std::get<0>(c).values.back();
+    case 1:
+    {
+        const auto& w = std::get<1>(c).words;
+        std::size_t i = roaring_words - 1;
+        while (!w[i])
+        {
+            --i;
+        }
+        return static_cast<std::uint16_t>(i * 64 + 63 - static_cast<std::size_t>(countl_zero(w[i])));
+    }
+    default:
+        return std::get<2>(c).runs.back().last;
+    }
+}
+
+// ORs the container into a 1024-word bitmap.
+inline void or_into(const roaring_container& c, std::uint64_t* w) noexcept
+{
+    switch (c.index())
+    {
+    case 0:
+        for (const std::uint16_t v : std::get<0>(c).values)
+        {
+            w[v / 64] |= std::uint64_t{1} << (v % 64);
+        }
+        break;
+    case 1:
+        apply_words<bit_or>(w, std::get<1>(c).words.data(), roaring_words);
+        break;
+    default:
+        for (const roaring_run& r : std::get<2>(c).runs)
+        {
+            set_range(w, r.start, r.last);
+        }
+        break;
+    }
+}
+
+inline roaring_bits to_bits(const roaring_container& c)
+{
+    if (c.index() == 1)
+    {
+        return std::get<1>(c);
+    }
+    roaring_bits b;
+    or_into(c, b.words.data());
+    b.card = cardinality(c);
+    return b;
+}
+
+inline roaring_array bits_to_array(const roaring_bits& b)
+{
+    roaring_array a;
+    a.values.reserve(b.card);
+    for (std::size_t i = 0; i < roaring_words; ++i)
+    {
+        for (std::uint64_t word = b.words[i]; word; word &= word - 1)
+        {
+            a.values.push_back(static_cast<std::uint16_t>(i * 64 + static_cast<std::size_t>(countr_zero(word))));
+        }
+    }
+    return a;
+}
+
+// Bitmap results drop back to an array once they fit in one.
+inline roaring_container from_bits(roaring_bits&& b)
+{
+    if (b.card <= roaring_array_max)
+    {
+        return bits_to_array(b);
+    }
+    return std::move(b);
+}
+
+inline std::size_t count_runs(const roaring_bits& b) noexcept
+{
+    std::size_t n = 0;
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < roaring_words; ++i)
+    {
+        const std::uint64_t w = b.words[i];
+        n += static_cast<std::size_t>(popcount(w & ~((w << 1) | carry)));
+        carry = w >> 63;
+    }
+    return n;
+}
+
+inline std::size_t count_runs(const roaring_array& a) noexcept
+{
+    std::size_t n = a.values.empty() ? 0 : 1;
+    for (std::size_t i = 1; i < a.values.size(); ++i)
+    {
+        n += a.values[i] != a.values[i - 1] + 1;
+    }
+    return n;
+}
+
+inline roaring_runs to_runs(const roaring_container& c)
+{
+    roaring_runs out;
+    bool open = false;
+    std::uint16_t start = 0;
+    std::uint16_t last = 0;
+    auto push = [&](const std::uint16_t v)
+    {
+        if (open && v == last + 1)
+        {
+            last = v;
+            return;
+        }
+        if (open)
+        {
+            out.runs.push_back({start, last});
+        }
+        start = last = v;
+        open = true;
+    };
+    for_each(c, push);
+    if (open)
+    {
+        out.runs.push_back({start, last});
+    }
+    return out;
+}
+
+// Size of the array or bitmap that would hold card values.
+inline std::size_t plain_bytes(const std::uint32_t card) noexcept
+{
+    return card <= roaring_array_max ? card * sizeof(std::uint16_t) : roaring_words * 8;
+}
+
+// Called after an edit adds a run: once the runs are no smaller than the array or
+// bitmap holding the same values, switch to that, so scattered edits to a run
+// container cannot grow it past 8 KB.
+inline void shrink_runs(roaring_container& c)
+{
+    if (std::get<2>(c).runs.size() * sizeof(roaring_run) >= plain_bytes(cardinality(c)))
+    {
+        c = from_bits(to_bits(c));
+    }
+}
+
+// Converts to whichever of array, bitmap or runs serialises smallest.
+inline void run_optimize(roaring_container& c)
+{
+    const std::uint32_t card = cardinality(c);
+    std::size_t runs = 0;
+    switch (c.index())
+    {
+    case 0:
+        runs = count_runs(std::get<0>(c));
+        break;
+    case 1:
+        runs = count_runs(std::get<1>(c));
+        break;
+    default:
+        runs = std::get<2>(c).runs.size();
+        break;
+    }
+
+    if (runs * sizeof(roaring_run) < plain_bytes(card))
+    {
+        if (c.index() != 2)
+        {
+            c = to_runs(c);
+        }
+    }
+    else if (c.index() == 2)
+    {
+        c = from_bits(to_bits(c));
+    }
+}
+
+inline std::size_t memory_bytes(const roaring_container& c) noexcept
+{
+    switch (c.index())
+    {
+    case 0:
+        return std::get<0>(c).values.capacity() * sizeof(std::uint16_t);
+    case 1:
+        return std::get<1>(c).words.capacity() * sizeof(std::uint64_t);
+    default:
+        return std::get<2>(c).runs.capacity() * sizeof(roaring_run);
+    }
+}
+
+inline bool add(roaring_container& c, const std::uint16_t x)
+{
+    switch (c.index())
+    {
+    case 0:
+    {
+        auto& v = std::get<0>(c).values;
+        auto it = std::lower_bound(v.begin(), v.end(), x);
+        if (it != v.end() && *it == x)
+        {
+            return false;
+        }
+        if (v.size() < roaring_array_max)
+        {
+            v.insert(it, x);
+            return true;
+        }
+        roaring_bits b = to_bits(c);
+        b.words[x / 64] |= std::uint64_t{1} << (x % 64);
+        ++b.card;
+        c = std::move(b);
+        return true;
+    }
+    case 1:
+    {
+        auto& b = std::get<1>(c);
+        std::uint64_t& w = b.words[x / 64];
+        const std::uint64_t bit = std::uint64_t{1} << (x % 64);
+        if (w & bit)
+        {
+            return false;
+        }
+        w |= bit;
+        ++b.card;
+        return true;
+    }
+    default:
+    {
+        auto& runs = std::get<2>(c).runs;
+        auto it = std::upper_bound(runs.begin(), runs.end(), x, [](const std::uint16_t v, const roaring_run& r)
+        {
+            return v < r.start;
+        });
+        const bool joins_next = it != runs.end() && it->start == x + 1;
+        if (it != runs.begin())
+        {
+            roaring_run& prev = *std::prev(it);
+            if (x <= prev.last)
+            {
+                return false;
+            }
+            if (x == prev.last + 1)
+            {
+                prev.last = joins_next ? it->last : x;
+                if (joins_next)
+                {
+                    runs.erase(it);
+                }
+                return true;
+            }
+        }
+        if (joins_next)
+        {
+            it->start = x;
+        }
+        else
+        {
+            runs.insert(it, {x, x});
+            shrink_runs(c);
+        }
+        return true;
+    }
+    }
+}
+
+inline bool remove(roaring_container& c, const std::uint16_t x)
+{
+    switch (c.index())
+    {
+    case 0:
+    {
+        auto& v = std::get<0>(c).values;
+        auto it = std::lower_bound(v.begin(), v.end(), x);
+        if (it == v.end() || *it != x)
+        {
+            return false;
+        }
+        v.erase(it);
+        return true;
+    }
+    case 1:
+    {
+        auto& b = std::get<1>(c);
+        std::uint64_t& w = b.words[x / 64];
+        const std::uint64_t bit = std::uint64_t{1} << (x % 64);
+        if (!(w & bit))
+        {
+            return false;
+        }
+        w &= ~bit;
+        if (--b.card <= roaring_array_max)
+        {
+            c = bits_to_array(b);
+        }
+        return true;
+    }
+    default:
+    {
+        auto& runs = std::get<2>(c).runs;
+        auto it = std::upper_bound(runs.begin(), runs.end(), x, [](const std::uint16_t v, const roaring_run& r)
+        {
+            return v < r.start;
+        });
+        if (it == runs.begin() || x > std::prev(it)->last)
+        {
+            return false;
+        }
+
+        --it;
+        if (it->start == it->last)
+        {
+            runs.erase(it);
+        }
+        else if (x == it->start)
+        {
+            ++it->start;
+        }
+        else if (x == it->last)
+        {
+            --it->last;
+        }
+        else
+        {
+            const roaring_run tail{static_cast<std::uint16_t>(x + 1), it->last};
+            it->last = static_cast<std::uint16_t>(x - 1);
+            runs.insert(std::next(it), tail);
+            shrink_runs(c);
+        }
+        return true;
+    }
+    }
+}
+
+// Sorted-array intersection; gallops through the larger side when sizes are skewed.
+inline roaring_array intersect_arrays(const std::vector<std::uint16_t>& a, const std::vector<std::uint16_t>& b)
+{
+    const auto& small = a.size() <= b.size() ? a : b;
+    const auto& large = a.size() <= b.size() ? b : a;
+    roaring_array out;
+
+    if (small.size() * 32 < large.size())
+    {
+        auto pos = large.begin();
+        for (const std::uint16_t v : small)
+        {
+            pos = std::lower_bound(pos, large.end(), v);
+            if (pos == large.end())
+            {
+                break;
+            }
+            if (*pos == v)
+            {
+                out.values.push_back(v);
+            }
+        }
+        return out;
+    }
+
+    out.values.reserve(small.size());
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out.values));
+    return out;
+}
+
+inline roaring_array filter_array(const roaring_array& a, const roaring_container& other, const bool keep_members)
+{
+    roaring_array out;
+    out.values.reserve(a.values.size());
+    for (const std::uint16_t v : a.values)
+    {
+        if (contains(other, v) == keep_members)
+        {
+            out.values.push_back(v);
+        }
+    }
+    return out;
+}
+
+inline roaring_container intersect(const roaring_container& a, const roaring_container& b)
+{
+    if (a.index() == 0 && b.index() == 0)
+    {
+        return intersect_arrays(std::get<0>(a).values, std::get<0>(b).values);
+    }
+    if (a.index() == 0)
+    {
+        return filter_array(std::get<0>(a), b, true);
+    }
+    if (b.index() == 0)
+    {
+        return filter_array(std::get<0>(b), a, true);
+    }
+
+    if (a.index() == 2 && b.index() == 2)
+    {
+        const auto& ra = std::get<2>(a).runs;
+        const auto& rb = std::get<2>(b).runs;
+        roaring_runs out;
+        for (std::size_t i = 0, j = 0; i < ra.size() && j < rb.size();)
+        {
+            const std::uint16_t start = std::max(ra[i].start, rb[j].start);
+            const std::uint16_t last = std::min(ra[i].last, rb[j].last);
+            if (start <= last)
+            {
+                out.runs.push_back({start, last});
+            }
+            ra[i].last < rb[j].last ? ++i : ++j;
+        }
+        return out;
+    }
+
+    roaring_bits out = to_bits(a);
+    const roaring_bits other = to_bits(b);
+    apply_words<bit_and>(out.words.data(), other.words.data(), roaring_words);
+    out.card = static_cast<std::uint32_t>(popcount_words(out.words.data(), roaring_words));
+    return from_bits(std::move(out));
+}
+
+inline roaring_container unite(const roaring_container& a, const roaring_container& b)
+{
+    if (a.index() == 0 && b.index() == 0)
+    {
+        const auto& va = std::get<0>(a).values;
+        const auto& vb = std::get<0>(b).values;
+        if (va.size() + vb.size() <= roaring_array_max)
+        {
+            roaring_array out;
+            out.values.reserve(va.size() + vb.size());
+            std::set_union(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(out.values));
+            return out;
+        }
+    }
+
+    if (a.index() == 2 && b.index() == 2)
+    {
+        const auto& ra = std::get<2>(a).runs;
+        const auto& rb = std::get<2>(b).runs;
+        roaring_runs out;
+        out.runs.reserve(ra.size() + rb.size());
+        for (std::size_t i = 0, j = 0; i < ra.size() || j < rb.size();)
+        {
+            const roaring_run next = j == rb.size() || (i < ra.size() && ra[i].start <= rb[j].start) ? ra[i++] : rb[j++];
+            if (!out.runs.empty() && next.start <= static_cast<std::uint32_t>(out.runs.back().last) + 1)
+            {
+                out.runs.back().last = std::max(out.runs.back().last, next.last);
+            }
+            else
+            {
+                out.runs.push_back(next);
+            }
+        }
+        return out;
+    }
+
+    roaring_bits out = to_bits(a);
+    or_into(b, out.words.data());
+    out.card = static_cast<std::uint32_t>(popcount_words(out.words.data(), roaring_words));
+    return from_bits(std::move(out));
+}
+
+inline roaring_container subtract(const roaring_container& a, const roaring_container& b)
+{
+    if (a.index() == 0 && b.index() == 0)
+    {
+        const auto& va = std::get<0>(a).values;
+        const auto& vb = std::get<0>(b).values;
+        roaring_array out;
+        out.values.reserve(va.size());
+        std::set_difference(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(out.values));
+        return out;
+    }
+    if (a.index() == 0)
+    {
+        return filter_array(std::get<0>(a), b, false);
+    }
+
+    roaring_bits out = to_bits(a);
+    switch (b.index())
+    {
+    case 0:
+        for (const std::uint16_t v : std::get<0>(b).values)
+        {
+            out.words[v / 64] &= ~(std::uint64_t{1} << (v % 64));
+        }
+        break;
+    case 1:
+        apply_words<bit_and_not>(out.words.data(), std::get<1>(b).words.data(), roaring_words);
+        break;
+    default:
+        for (const roaring_run& r : std::get<2>(b).runs)
+        {
+            clear_range(out.words.data(), r.start, r.last);
+        }
+        break;
+    }
+    out.card = static_cast<std::uint32_t>(popcount_words(out.words.data(), roaring_words));
+    return from_bits(std::move(out));
+}
+}
+}
+
+class roaring_bitmap
+{
+public:
+    roaring_bitmap() = default;
+
+    explicit roaring_bitmap(const dynamic_bitset& bits)
+    {
+        if (bits.size() > (std::size_t{1} << 32))
+        {
+            throw std::length_error("roaring_bitmap: dynamic_bitset larger than 2^32 bits");
+        }
+
+        const std::uint64_t* w = bits.data();
+        const std::size_t nwords = bits.bits_.size();
+        for (std::size_t first = 0; first < nwords; first += mib::detail::roaring_words)
+        {
+            const std::size_t count = std::min(mib::detail::roaring_words, nwords - first);
+            const auto card = static_cast<std::uint32_t>(mib::detail::popcount_words(w + first, count));
+            if (card == 0)
+            {
+                continue;
+            }
+
+            mib::detail::roaring_bits b;
+            std::copy(w + first, w + first + count, b.words.begin());
+            b.card = card;
+
+            keys_.push_back(static_cast<std::uint16_t>(first / mib::detail::roaring_words));
+            containers_.push_back(mib::detail::from_bits(std::move(b)));
+            mib::detail::run_optimize(containers_.back());
+        }
+    }
+
+    roaring_bitmap(const std::initializer_list<std::uint32_t> values)
+    {
+        for (const std::uint32_t v : values)
+        {
+            add(v);
+        }
+    }
+
+    bool add(const std::uint32_t x)
+    {
+        const std::uint16_t key = high(x);
+        auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+        const auto i = static_cast<std::size_t>(it - keys_.begin());
+        if (it == keys_.end() || *it != key)
+        {
+            keys_.insert(it, key);
+            containers_.insert(containers_.begin() + static_cast<std::ptrdiff_t>(i), mib::detail::roaring_array{{low(x)}});
+            return true;
+        }
+        return mib::detail::add(containers_[i], low(x));
+    }
+
+    bool remove(const std::uint32_t x)
+    {
+        const std::size_t i = find_key(high(x));
+        if (i == npos_key || !mib::detail::remove(containers_[i], low(x)))
+        {
+            return false;
+        }
+        if (mib::detail::cardinality(containers_[i]) == 0)
+        {
+            keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(i));
+            containers_.erase(containers_.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool contains(const std::uint32_t x) const
+    {
+        const std::size_t i = find_key(high(x));
+        return i != npos_key && mib::detail::contains(containers_[i], low(x));
+    }
+
+    [[nodiscard]] std::size_t cardinality() const noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& c : containers_)
+        {
+            n += mib::detail::cardinality(c);
+        }
+        return n;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return keys_.empty();
+    }
+
+    // Calls f(uint32_t) for every value in ascending order.
+    template<typename F>
+    void for_each(F f) const
+    {
+        for (std::size_t i = 0; i < keys_.size(); ++i)
+        {
+            const std::uint32_t base = static_cast<std::uint32_t>(keys_[i]) << 16;
+            auto emit = [&f, base](const std::uint16_t v)
+            {
+                f(base | v);
+            };
+            mib::detail::for_each(containers_[i], emit);
+        }
+    }
+
+    [[nodiscard]] std::vector<std::uint32_t> to_vector() const
+    {
+        std::vector<std::uint32_t> out;
+        out.reserve(cardinality());
+        for_each([&out](const std::uint32_t v)
+        {
+            out.push_back(v);
+        });
+        return out;
+    }
+
+    // Sized to one past the largest value unless a size is given.
+    [[nodiscard]] dynamic_bitset to_dynamic_bitset() const
+    {
+        if (keys_.empty())
+        {
+            return dynamic_bitset();
+        }
+        const std::uint32_t last = static_cast<std::uint32_t>(keys_.back()) << 16 | mib::detail::last_value(containers_.back());
+        return to_dynamic_bitset(static_cast<std::size_t>(last) + 1);
+    }
+
+    [[nodiscard]] dynamic_bitset to_dynamic_bitset(const std::size_t nbits) const
+    {
+        dynamic_bitset out(nbits);
+        std::vector<std::uint64_t> chunk(mib::detail::roaring_words);
+        for (std::size_t i = 0; i < keys_.size(); ++i)
+        {
+            const std::size_t first = static_cast<std::size_t>(keys_[i]) * mib::detail::roaring_words;
+            if (first >= out.bits_.size())
+            {
+                break;
+            }
+
+            std::fill(chunk.begin(), chunk.end(), 0);
+            mib::detail::or_into(containers_[i], chunk.data());
+            const std::size_t count = std::min(mib::detail::roaring_words, out.bits_.size() - first);
+            std::copy(chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(count), out.bits_.begin() + static_cast<std::ptrdiff_t>(first));
+        }
+        out.clear_tail();
+        return out;
+    }
+
+    // Re-picks the smallest representation per chunk, including run containers.
+    void run_optimize()
+    {
+        for (auto& c : containers_)
+        {
+            mib::detail::run_optimize(c);
+        }
+    }
+
+    roaring_bitmap& operator&=(const roaring_bitmap& o)
+    {
+        return *this = *this & o;
+    }
+
+    roaring_bitmap& operator|=(const roaring_bitmap& o)
+    {
+        return *this = *this | o;
+    }
+
+    roaring_bitmap& operator-=(const roaring_bitmap& o)
+    {
+        return *this = *this - o;
+    }
+
+    friend roaring_bitmap operator&(const roaring_bitmap& a, const roaring_bitmap& b)
+    {
+        roaring_bitmap out;
+        for (std::size_t i = 0, j = 0; i < a.keys_.size() && j < b.keys_.size();)
+        {
+            if (a.keys_[i] < b.keys_[j])
+            {
+                ++i;
+            }
+            else if (b.keys_[j] < a.keys_[i])
+            {
+                ++j;
+            }
+            else
+            {
+                out.push_nonempty(a.keys_[i], mib::detail::intersect(a.containers_[i], b.containers_[j]));
+                ++i;
+                ++j;
+            }
+        }
+        return out;
+    }
+
+    friend roaring_bitmap operator|(const roaring_bitmap& a, const roaring_bitmap& b)
+    {
+        roaring_bitmap out;
+        std::size_t i = 0;
+        std::size_t j = 0;
+        while (i < a.keys_.size() || j < b.keys_.size())
+        {
+            if (j == b.keys_.size() || (i < a.keys_.size() && a.keys_[i] < b.keys_[j]))
+            {
+                out.push_nonempty(a.keys_[i], a.containers_[i]);
+                ++i;
+            }
+            else if (i == a.keys_.size() || b.keys_[j] < a.keys_[i])
+            {
+                out.push_nonempty(b.keys_[j], b.containers_[j]);
+                ++j;
+            }
+            else
+            {
+                out.push_nonempty(a.keys_[i], mib::detail::unite(a.containers_[i], b.containers_[j]));
+                ++i;
+                ++j;
+            }
+        }
+        return out;
+    }
+
+    friend roaring_bitmap operator-(const roaring_bitmap& a, const roaring_bitmap& b)
+    {
+        roaring_bitmap out;
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < a.keys_.size(); ++i)
+        {
+            while (j < b.keys_.size() && b.keys_[j] < a.keys_[i])
+            {
+                ++j;
+            }
+            if (j < b.keys_.size() && b.keys_[j] == a.keys_[i])
+            {
+                out.push_nonempty(a.keys_[i], mib::detail::subtract(a.containers_[i], b.containers_[j]));
+            }
+            else
+            {
+                out.push_nonempty(a.keys_[i], a.containers_[i]);
+            }
+        }
+        return out;
+    }
+
+    bool operator==(const roaring_bitmap& o) const
+    {
+        return keys_ == o.keys_ && to_vector() == o.to_vector();
+    }
+
+    bool operator!=(const roaring_bitmap& o) const
+    {
+        return !(*this == o);
+    }
+
+    // Heap bytes held by the containers plus the key and container arrays.
+    [[nodiscard]] std::size_t memory_bytes() const noexcept
+    {
+        std::size_t n = keys_.capacity() * sizeof(std::uint16_t) + containers_.capacity() * sizeof(mib::detail::roaring_container);
+        for (const auto& c : containers_)
+        {
+            n += mib::detail::memory_bytes(c);
+        }
+        return n;
+    }
+
+    // Number of array, bitmap and run containers, in that order.
+    [[nodiscard]] std::array<std::size_t, 3> container_counts() const noexcept
+    {
+        std::array<std::size_t, 3> n{};
+        for (const auto& c : containers_)
+        {
+            ++n[c.index()];
+        }
+        return n;
+    }
+
+private:
+    static constexpr std::size_t npos_key = static_cast<std::size_t>(-1);
+
+    static std::uint16_t high(const std::uint32_t x) noexcept
+    {
+        return static_cast<std::uint16_t>(x >> 16);
+    }
+
+    static std::uint16_t low(const std::uint32_t x) noexcept
+    {
+        return static_cast<std::uint16_t>(x & 0xffff);
+    }
+
+    std::size_t find_key(const std::uint16_t key) const noexcept
+    {
+        auto it = std::lower_bound(keys_.begin(), keys_.end(), key);
+        return it != keys_.end() && *it == key ? static_cast<std::size_t>(it - keys_.begin()) : npos_key;
+    }
+
+    void push_nonempty(const std::uint16_t key, mib::detail::roaring_container c)
+    {
+        if (mib::detail::cardinality(c) != 0)
+        {
+            keys_.push_back(key);
+            containers_.push_back(std::move(c));
+        }
+    }
+
+    std::vector<std::uint16_t> keys_;
+    std::vector<mib::detail::roaring_container> containers_;
+};
@@ -1,98 +1,795 @@
 #pragma once
 
+#include <new>
+#include <mutex>
+#include <atomic>
 #include <string>
-#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <string_view>
 
-class rope
+namespace mib
 {
+namespace detail
+{
+struct null_mutex
+{
+    void lock() noexcept {}
+    void unlock() noexcept {}
+};
+
+struct rope_slab_stats
+{
+    std::size_t bytes_reserved = 0;
+    std::size_t bytes_in_use = 0;
+    std::size_t blocks_in_use = 0;
+};
+
+// Size-classed slab for rope nodes. Freed blocks go back to their class's free list;
+// chunks are kept for the lifetime of the slab.
+template<bool ThreadSafe>
+class rope_slab
+{
+public:
+    static constexpr std::size_t granularity = 32;
+    static constexpr std::size_t class_count = 40;
+    static constexpr std::size_t max_block = granularity * class_count;
+    static constexpr std::size_t chunk_size = 256 * 1024;
+
+    rope_slab() = default;
+    rope_slab(const rope_slab&) = delete;
+    rope_slab& operator=(const rope_slab&) = delete;
+
+    ~rope_slab()
+    {
+        while (chunks_)
+        {
+            chunk* next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+    }
+
+    void* allocate(const std::size_t bytes)
+    {
+        const std::size_t cls = size_class(bytes);
+        std::lock_guard<lock_type> guard(lock_);
+
+        stats_.bytes_in_use += class_size(cls);
+        ++stats_.blocks_in_use;
+
+        if (free_block* b = free_[cls])
+        {
+            free_[cls] = b->next;
+            return b;
+        }
+
+        if (static_cast<std::size_t>(end_ - cur_) < class_size(cls))
+        {
+            auto* c = static_cast<chunk*>(::operator new(chunk_size));
+            c->next = chunks_;
+            chunks_ = c;
+            cur_ = reinterpret_cast<char*>(c) + sizeof(chunk);
+            end_ = reinterpret_cast<char*>(c) + chunk_size;
+            stats_.bytes_reserved += chunk_size;
+        }
+
+        void* p = cur_;
+        cur_ += class_size(cls);
+        return p;
+    }
+
+    void deallocate(void* p, const std::size_t bytes) noexcept
+    {
+        const std::size_t cls = size_class(bytes);
+        auto* b = static_cast<free_block*>(p);
+        std::lock_guard<lock_type> guard(lock_);
+
+        b->next = free_[cls];
+        free_[cls] = b;
+        stats_.bytes_in_use -= class_size(cls);
+        --stats_.blocks_in_use;
+    }
+
+    rope_slab_stats stats()
+    {
+        std::lock_guard<lock_type> guard(lock_);
+        return stats_;
+    }
+
+    static constexpr std::size_t block_size(const std::size_t bytes) noexcept
+    {
+        return class_size(size_class(bytes));
+    }
+
+private:
+    using lock_type = std::conditional_t<ThreadSafe, std::mutex, null_mutex>;
+
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct alignas(std::max_align_t) chunk
+    {
+        chunk* next;
+    };
+
+    static constexpr std::size_t size_class(const std::size_t bytes) noexcept
+    {
+        return (bytes - 1) / granularity;
+    }
+
+    static constexpr std::size_t class_size(const std::size_t cls) noexcept
+    {
+        return (cls + 1) * granularity;
+    }
+
+    free_block* free_[class_count] = {};
+    chunk* chunks_ = nullptr;
+    char* cur_ = nullptr;
+    char* end_ = nullptr;
+    rope_slab_stats stats_;
+    lock_type lock_;
+};
+}
+
+struct rope_memory_stats
+{
+    std::size_t leaves = 0;
+    std::size_t internal_nodes = 0;
+    std::size_t text_bytes = 0;
+    std::size_t node_bytes = 0;
+    double bytes_per_node = 0.0;
+    double overhead_per_text_byte = 0.0;
+};
+}
+
+// Persistent AVL-balanced rope: nodes are immutable once built, so edits return
+// new spines that share every untouched subtree, and copies/substr are cheap.
+// Nodes are intrusively refcounted (atomically when ThreadSafe) and leaves keep their
+// bytes inline after the header.
+//
+// Nodes come from a size-classed slab whose chunks are reused but never handed back to
+// the system. rope shares one process-wide slab, so every node allocation and release
+// takes its mutex. local_rope has one unlocked slab per thread: a local_rope, its copies
+// and its substrings must all be used and destroyed on the thread that created them.
+template<bool ThreadSafe = true>
+class basic_rope
+{
+    using refcount_type = std::conditional_t<ThreadSafe, std::atomic<std::uint32_t>, std::uint32_t>;
+    using slab_type = mib::detail::rope_slab<ThreadSafe>;
+
     struct Node
     {
-        std::shared_ptr<Node> left;
-        std::shared_ptr<Node> right;
+        refcount_type refs{1};
+        std::int32_t height = 0;
+        std::size_t len = 0;
 
-        std::string s;
-        size_t len = 0;
+        [[nodiscard]] bool is_leaf() const noexcept
+        {
+            return height == 0;
+        }
 
-        explicit Node(const std::string& str) : s(str), len(str.size()) {}
-        Node(std::shared_ptr<Node> l, std::shared_ptr<Node> r) : left(std::move(l)), right(std::move(r))
+        [[nodiscard]] const char* bytes() const noexcept
         {
-            len = 0;
-            if (left)
-            {
-                len += left->len;
-            }
-            if (right)
-            {
-                len += right->len;
-            }
+            return reinterpret_cast<const char*>(this + 1);
+        }
+
+        char* bytes() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    class node_ptr
+    {
+    public:
+        node_ptr() = default;
+        explicit node_ptr(Node* n) noexcept : p_(n) {}
+
+        node_ptr(const node_ptr& o) noexcept : p_(o.p_)
+        {
+            retain(p_);
         }
+
+        node_ptr(node_ptr&& o) noexcept : p_(std::exchange(o.p_, nullptr)) {}
+
+        node_ptr& operator=(node_ptr o) noexcept
+        {
+            std::swap(p_, o.p_);
+            return *this;
+        }
+
+        ~node_ptr()
+        {
+            release(p_);
+        }
+
+        Node* get() const noexcept { return p_; }
+        Node* operator->() const noexcept { return p_; }
+        explicit operator bool() const noexcept { return p_ != nullptr; }
+
+    private:
+        Node* p_ = nullptr;
+    };
+
+    struct Inner : Node
+    {
+        node_ptr left;
+        node_ptr right;
     };
 
 public:
-    rope() = default;
-    explicit rope(const std::string& s) : root_(std::make_shared<Node>(s)) {}
+    static constexpr std::size_t max_leaf = 1024;
 
-    rope& append(const rope& r)
+    class const_iterator
     {
-        if (!root_)
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using reference = const char&;
+        using pointer = const char*;
+
+        const_iterator() = default;
+
+        reference operator*() const
         {
-            root_ = r.root_; return *this;
+            return leaf_->bytes()[off_];
         }
-        if (!r.root_)
+
+        const_iterator& operator++()
         {
+            if (++off_ == leaf_->len)
+            {
+                next_leaf();
+            }
             return *this;
         }
-        root_ = std::make_shared<Node>(root_, r.root_);
+
+        const_iterator operator++(int)
+        {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const const_iterator& o) const noexcept
+        {
+            return leaf_ == o.leaf_ && off_ == o.off_;
+        }
+
+        bool operator!=(const const_iterator& o) const noexcept
+        {
+            return !(*this == o);
+        }
+
+    private:
+        friend class basic_rope;
+
+        const_iterator(const Node* root, std::size_t pos)
+        {
+            if (!root || pos >= root->len)
+            {
+                return;
+            }
+
+            const Node* n = root;
+            while (!n->is_leaf())
+            {
+                if (pos < left(n)->len)
+                {
+                    pending_.push_back(right(n).get());
+                    n = left(n).get();
+                }
+                else
+                {
+                    pos -= left(n)->len;
+                    n = right(n).get();
+                }
+            }
+            leaf_ = n;
+            off_ = pos;
+        }
+
+        void next_leaf()
+        {
+            off_ = 0;
+            if (pending_.empty())
+            {
+                leaf_ = nullptr;
+                return;
+            }
+
+            const Node* n = pending_.back();
+            pending_.pop_back();
+            while (!n->is_leaf())
+            {
+                pending_.push_back(right(n).get());
+                n = left(n).get();
+            }
+            leaf_ = n;
+        }
+
+        std::vector<const Node*> pending_;
+        const Node* leaf_ = nullptr;
+        std::size_t off_ = 0;
+    };
+
+    basic_rope() = default;
+    explicit basic_rope(const std::string& s) : root_(build(s)) {}
+
+    basic_rope& append(const basic_rope& r)
+    {
+        root_ = join(root_, r.root_);
         return *this;
     }
 
-    [[nodiscard]] size_t size() const
+    [[nodiscard]] std::size_t size() const
     {
         return root_ ? root_->len : 0;
     }
 
+    [[nodiscard]] bool empty() const
+    {
+        return !root_;
+    }
+
+    [[nodiscard]] int depth() const
+    {
+        return root_ ? root_->height : 0;
+    }
+
     [[nodiscard]] std::string str() const
     {
         std::string out;
-        if (!root_)
+        out.reserve(size());
+        for_each_chunk([&out](const std::string_view chunk)
         {
-            return out;
+            out.append(chunk);
+        });
+        return out;
+    }
+
+    [[nodiscard]] char char_at(std::size_t i) const
+    {
+        if (i >= size())
+        {
+            throw std::out_of_range("rope::char_at");
         }
 
-        out.reserve(root_->len);
-        append_to_string(root_, out);
+        const Node* n = root_.get();
+        while (!n->is_leaf())
+        {
+            if (i < left(n)->len)
+            {
+                n = left(n).get();
+            }
+            else
+            {
+                i -= left(n)->len;
+                n = right(n).get();
+            }
+        }
+        return n->bytes()[i];
+    }
 
+    char operator[](const std::size_t i) const
+    {
+        return char_at(i);
+    }
+
+    basic_rope& insert(const std::size_t pos, const basic_rope& r)
+    {
+        check_pos(pos);
+        auto [l, rest] = split(root_, pos);
+        root_ = join_merge(join_merge(l, r.root_), rest);
+        return *this;
+    }
+
+    basic_rope& insert(const std::size_t pos, const std::string& s)
+    {
+        return insert(pos, basic_rope(s));
+    }
+
+    basic_rope& erase(const std::size_t pos, std::size_t count)
+    {
+        check_pos(pos);
+        count = std::min(count, size() - pos);
+
+        auto [l, rest] = split(root_, pos);
+        root_ = join_merge(l, split(rest, count).second);
+        return *this;
+    }
+
+    // Shares every subtree that lies wholly inside the range.
+    [[nodiscard]] basic_rope substr(const std::size_t pos, std::size_t count) const
+    {
+        check_pos(pos);
+        count = std::min(count, size() - pos);
+
+        basic_rope out;
+        out.root_ = split(split(root_, pos).second, count).first;
         return out;
     }
 
-    rope operator+(const rope& other) const
+    template<typename F>
+    void for_each_chunk(F&& f) const
+    {
+        for_each_leaf(root_.get(), f);
+    }
+
+    const_iterator begin() const
     {
-        rope r;
-        r.root_ = std::make_shared<Node>(root_, other.root_);
+        return const_iterator(root_.get(), 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
+    const_iterator iterator_at(const std::size_t pos) const
+    {
+        return const_iterator(root_.get(), pos);
+    }
+
+    basic_rope operator+(const basic_rope& other) const
+    {
+        basic_rope r;
+        r.root_ = join(root_, other.root_);
         return r;
     }
 
-    rope& operator+=(const rope& other)
+    basic_rope& operator+=(const basic_rope& other)
     {
         return append(other);
     }
 
+    // Counts every node reachable from this rope; subtrees shared with snapshots are included.
+    [[nodiscard]] mib::rope_memory_stats memory_stats() const
+    {
+        mib::rope_memory_stats st;
+        count_nodes(root_.get(), st);
+
+        const std::size_t nodes = st.leaves + st.internal_nodes;
+        st.bytes_per_node = nodes ? static_cast<double>(st.node_bytes) / static_cast<double>(nodes) : 0.0;
+        st.overhead_per_text_byte = st.text_bytes
+            ? static_cast<double>(st.node_bytes - st.text_bytes) / static_cast<double>(st.text_bytes)
+            : 0.0;
+        return st;
+    }
+
+    // For local_rope, the calling thread's slab.
+    static mib::detail::rope_slab_stats arena_stats()
+    {
+        return slab().stats();
+    }
+
 private:
-    void append_to_string(const std::shared_ptr<Node>& n, std::string& out) const
+    // Frees the thread's slab at thread exit unless nodes from it are still alive, e.g.
+    // in a local_rope with static storage duration.
+    struct thread_slab
+    {
+        slab_type* slab = new slab_type();
+
+        ~thread_slab()
+        {
+            if (slab->stats().blocks_in_use == 0)
+            {
+                delete slab;
+            }
+        }
+    };
+
+    // The shared slab is intentionally leaked so ropes with static storage duration can
+    // outlive it.
+    static slab_type& slab()
+    {
+        if constexpr (ThreadSafe)
+        {
+            static slab_type* s = new slab_type();
+            return *s;
+        }
+        else
+        {
+            thread_local thread_slab s;
+            return *s.slab;
+        }
+    }
+
+    static const node_ptr& left(const Node* n) noexcept
+    {
+        return static_cast<const Inner*>(n)->left;
+    }
+
+    static const node_ptr& right(const Node* n) noexcept
+    {
+        return static_cast<const Inner*>(n)->right;
+    }
+
+    static void retain(Node* n) noexcept
+    {
+        if (!n)
+        {
+            return;
+        }
+
+        if constexpr (ThreadSafe)
+        {
+            n->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ++n->refs;
+        }
+    }
+
+    static void release(Node* n) noexcept
+    {
+        if (!n)
+        {
+            return;
+        }
+
+        if constexpr (ThreadSafe)
+        {
+            if (n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                return;
+            }
+        }
+        else
+        {
+            if (--n->refs != 0)
+            {
+                return;
+            }
+        }
+
+        if (n->is_leaf())
+        {
+            const std::size_t bytes = sizeof(Node) + n->len;
+            n->~Node();
+            slab().deallocate(n, bytes);
+        }
+        else
+        {
+            auto* in = static_cast<Inner*>(n);
+            in->~Inner();
+            slab().deallocate(in, sizeof(Inner));
+        }
+    }
+
+    void check_pos(const std::size_t pos) const
+    {
+        if (pos > size())
+        {
+            throw std::out_of_range("rope: position out of range");
+        }
+    }
+
+    static int height(const node_ptr& n) noexcept
+    {
+        return n ? n->height : -1;
+    }
+
+    static node_ptr leaf(const char* a, const std::size_t na, const char* b = nullptr, const std::size_t nb = 0)
+    {
+        void* raw = slab().allocate(sizeof(Node) + na + nb);
+        Node* n = ::new (raw) Node();
+        n->len = na + nb;
+        std::memcpy(n->bytes(), a, na);
+        if (nb)
+        {
+            std::memcpy(n->bytes() + na, b, nb);
+        }
+        return node_ptr(n);
+    }
+
+    static node_ptr concat(node_ptr l, node_ptr r)
+    {
+        void* raw = slab().allocate(sizeof(Inner));
+        Inner* n = ::new (raw) Inner();
+        n->len = l->len + r->len;
+        n->height = 1 + std::max(l->height, r->height);
+        n->left = std::move(l);
+        n->right = std::move(r);
+        return node_ptr(n);
+    }
+
+    // Chunks s into leaves of max_leaf bytes and pairs them up level by level.
+    static node_ptr build(const std::string& s)
+    {
+        if (s.empty())
+        {
+            return node_ptr();
+        }
+
+        std::vector<node_ptr> level;
+        const std::size_t leaves = (s.size() + max_leaf - 1) / max_leaf;
+        level.reserve(leaves);
+        for (std::size_t i = 0; i < leaves; ++i)
+        {
+            const std::size_t begin = s.size() * i / leaves;
+            const std::size_t end = s.size() * (i + 1) / leaves;
+            level.push_back(leaf(s.data() + begin, end - begin));
+        }
+
+        while (level.size() > 1)
+        {
+            std::vector<node_ptr> next;
+            next.reserve((level.size() + 1) / 2);
+            for (std::size_t i = 0; i + 1 < level.size(); i += 2)
+            {
+                next.push_back(concat(std::move(level[i]), std::move(level[i + 1])));
+            }
+            if (level.size() % 2)
+            {
+                next.back() = concat(std::move(next.back()), std::move(level.back()));
+            }
+            level.swap(next);
+        }
+        return level.front();
+    }
+
+    // Children may differ in height by at most two; one single or double rotation fixes it.
+    static node_ptr balance(node_ptr l, node_ptr r)
+    {
+        if (height(l) > height(r) + 1)
+        {
+            const node_ptr& ll = left(l.get());
+            const node_ptr& lr = right(l.get());
+            if (height(ll) >= height(lr))
+            {
+                return concat(ll, concat(lr, std::move(r)));
+            }
+            return concat(concat(ll, left(lr.get())), concat(right(lr.get()), std::move(r)));
+        }
+
+        if (height(r) > height(l) + 1)
+        {
+            const node_ptr& rl = left(r.get());
+            const node_ptr& rr = right(r.get());
+            if (height(rr) >= height(rl))
+            {
+                return concat(concat(std::move(l), rl), rr);
+            }
+            return concat(concat(std::move(l), left(rl.get())), concat(right(rl.get()), rr));
+        }
+
+        return concat(std::move(l), std::move(r));
+    }
+
+    static node_ptr join(const node_ptr& a, const node_ptr& b)
+    {
+        if (!a)
+        {
+            return b;
+        }
+        if (!b)
+        {
+            return a;
+        }
+
+        if (a->is_leaf() && b->is_leaf() && a->len + b->len <= max_leaf)
+        {
+            return leaf(a->bytes(), a->len, b->bytes(), b->len);
+        }
+
+        if (height(a) > height(b) + 1)
+        {
+            return balance(left(a.get()), join(right(a.get()), b));
+        }
+        if (height(b) > height(a) + 1)
+        {
+            return balance(join(a, left(b.get())), right(b.get()));
+        }
+        return concat(a, b);
+    }
+
+    // Like join, but first fuses the two leaves meeting at the seam when they fit in one,
+    // so repeated edits at the same spot do not fragment the text into tiny leaves.
+    static node_ptr join_merge(const node_ptr& a, const node_ptr& b)
+    {
+        if (!a || !b)
+        {
+            return a ? a : b;
+        }
+
+        const Node* last = a.get();
+        while (!last->is_leaf())
+        {
+            last = right(last).get();
+        }
+
+        const Node* first = b.get();
+        while (!first->is_leaf())
+        {
+            first = left(first).get();
+        }
+
+        if (last->len + first->len > max_leaf || (a->is_leaf() && b->is_leaf()))
+        {
+            return join(a, b);
+        }
+
+        node_ptr merged = leaf(last->bytes(), last->len, first->bytes(), first->len);
+        return join(join(split(a, a->len - last->len).first, merged), split(b, first->len).second);
+    }
+
+    static std::pair<node_ptr, node_ptr> split(const node_ptr& n, const std::size_t pos)
+    {
+        if (!n || pos == 0)
+        {
+            return {node_ptr(), n};
+        }
+        if (pos >= n->len)
+        {
+            return {n, node_ptr()};
+        }
+
+        if (n->is_leaf())
+        {
+            return {leaf(n->bytes(), pos), leaf(n->bytes() + pos, n->len - pos)};
+        }
+
+        const node_ptr& l = left(n.get());
+        if (pos < l->len)
+        {
+            auto [ll, lr] = split(l, pos);
+            return {std::move(ll), join(lr, right(n.get()))};
+        }
+
+        auto [rl, rr] = split(right(n.get()), pos - l->len);
+        return {join(l, rl), std::move(rr)};
+    }
+
+    template<typename F>
+    static void for_each_leaf(const Node* n, F& f)
     {
         if (!n)
         {
             return;
         }
-        if (!n->left && !n->right)
+        if (n->is_leaf())
         {
-            out += n->s; return;
+            f(std::string_view(n->bytes(), n->len));
+            return;
         }
+        for_each_leaf(left(n).get(), f);
+        for_each_leaf(right(n).get(), f);
+    }
 
-        append_to_string(n->left, out);
-        append_to_string(n->right, out);
+    static void count_nodes(const Node* n, mib::rope_memory_stats& st)
+    {
+        if (!n)
+        {
+            return;
+        }
+        if (n->is_leaf())
+        {
+            ++st.leaves;
+            st.text_bytes += n->len;
+            st.node_bytes += slab_type::block_size(sizeof(Node) + n->len);
+            return;
+        }
+        ++st.internal_nodes;
+        st.node_bytes += slab_type::block_size(sizeof(Inner));
+        count_nodes(left(n).get(), st);
+        count_nodes(right(n).get(), st);
     }
 
-    std::shared_ptr<Node> root_;
+    node_ptr root_;
 };
+
+using rope = basic_rope<true>;
+using local_rope = basic_rope<false>;
@@ -1,35 +1,498 @@
 #pragma once
 #include <vector>
-#include <functional>
+#include <limits>
+#include <cstddef>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "bit_ops.h"
+
+// Monoids supply identity() and an associative combine(); repeat(x, n) is x combined
+// with itself n times and is only needed by the lazy tags below.
+namespace mib
+{
+template<typename T>
+struct sum_monoid
+{
+    using value_type = T;
+    static T identity() { return T{}; }
+    static T combine(const T& a, const T& b) { return a + b; }
+    static T repeat(const T& x, const std::size_t n) { return x * static_cast<T>(n); }
+};
 
 template<typename T>
-class segment_tree 
+struct min_monoid
+{
+    using value_type = T;
+    static T identity() { return std::numeric_limits<T>::max(); }
+    static T combine(const T& a, const T& b) { return std::min(a, b); }
+    static T repeat(const T& x, std::size_t) { return x; }
+};
+
+template<typename T>
+struct max_monoid
+{
+    using value_type = T;
+    static T identity() { return std::numeric_limits<T>::lowest(); }
+    static T combine(const T& a, const T& b) { return std::max(a, b); }
+    static T repeat(const T& x, std::size_t) { return x; }
+};
+
+// Lazy tags: apply(f, v, len) maps the aggregate v of len elements, and
+// compose(outer, inner) is the tag equivalent to applying inner then outer.
+template<typename Monoid>
+struct range_add
+{
+    using value_type = typename Monoid::value_type;
+    using tag_type = value_type;
+    static tag_type identity() { return tag_type{}; }
+
+    static value_type apply(const tag_type& f, const value_type& v, const std::size_t len)
+    {
+        return v + Monoid::repeat(f, len);
+    }
+
+    static tag_type compose(const tag_type& outer, const tag_type& inner) { return outer + inner; }
+};
+
+template<typename Monoid>
+struct range_assign
+{
+    using value_type = typename Monoid::value_type;
+    using tag_type = std::optional<value_type>;
+    static tag_type identity() { return std::nullopt; }
+
+    static value_type apply(const tag_type& f, const value_type& v, const std::size_t len)
+    {
+        return f ? Monoid::repeat(*f, len) : v;
+    }
+
+    static tag_type compose(const tag_type& outer, const tag_type& inner) { return outer ? outer : inner; }
+};
+}
+
+// Iterative bottom-up tree over a power-of-two leaf row; all ranges are half-open.
+template<typename T, typename Monoid = mib::sum_monoid<T>>
+class segment_tree
 {
+    static_assert(std::is_same_v<T, typename Monoid::value_type>, "segment_tree: Monoid must operate on T");
+
 public:
     segment_tree() = default;
     ~segment_tree() = default;
 
-    explicit segment_tree(const std::vector<T>& a)
+    explicit segment_tree(const std::size_t n) : segment_tree(std::vector<T>(n, Monoid::identity())) {}
+
+    explicit segment_tree(const std::vector<T>& a) : n_(a.size())
+    {
+        while (size_ < n_)
+        {
+            size_ <<= 1;
+        }
+
+        tree_.assign(2 * size_, Monoid::identity());
+        std::copy(a.begin(), a.end(), tree_.begin() + static_cast<std::ptrdiff_t>(size_));
+        for (std::size_t i = size_ - 1; i >= 1; --i)
+        {
+            pull(i);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return n_;
+    }
+
+    void set(std::size_t i, const T& x)
+    {
+        i += size_;
+        tree_[i] = x;
+        for (i >>= 1; i; i >>= 1)
+        {
+            pull(i);
+        }
+    }
+
+    [[nodiscard]] const T& get(const std::size_t i) const
+    {
+        return tree_[i + size_];
+    }
+
+    // Combines [l, r) in order; the identity for an empty range.
+    [[nodiscard]] T query(std::size_t l, std::size_t r) const
     {
-        int n_ = 1;
-        while (n_ < a.size())
+        T left = Monoid::identity();
+        T right = Monoid::identity();
+        for (l += size_, r += size_; l < r; l >>= 1, r >>= 1)
         {
-            n_ <<= 1;
+            if (l & 1)
+            {
+                left = Monoid::combine(left, tree_[l++]);
+            }
+            if (r & 1)
+            {
+                right = Monoid::combine(tree_[--r], right);
+            }
+        }
+        return Monoid::combine(left, right);
+    }
+
+    [[nodiscard]] T query_all() const
+    {
+        return tree_[1];
+    }
+
+    // Largest r such that pred(query(l, r)) holds; pred must be monotone and pred(identity) true.
+    template<typename Pred>
+    [[nodiscard]] std::size_t max_right(std::size_t l, Pred pred) const
+    {
+        if (l == n_)
+        {
+            return n_;
         }
 
-        tree_.assign(2 * n_, T{});
+        l += size_;
+        T acc = Monoid::identity();
+        do
+        {
+            while (l % 2 == 0)
+            {
+                l >>= 1;
+            }
+            if (!pred(Monoid::combine(acc, tree_[l])))
+            {
+                while (l < size_)
+                {
+                    l <<= 1;
+                    if (pred(Monoid::combine(acc, tree_[l])))
+                    {
+                        acc = Monoid::combine(acc, tree_[l]);
+                        ++l;
+                    }
+                }
+                return l - size_;
+            }
+            acc = Monoid::combine(acc, tree_[l]);
+            ++l;
+        } while ((l & (~l + 1)) != l);
+        return n_;
+    }
 
-        for (size_t i = 0; i < a.size(); ++i)
+    // Smallest l such that pred(query(l, r)) holds; same requirements as max_right.
+    template<typename Pred>
+    [[nodiscard]] std::size_t min_left(std::size_t r, Pred pred) const
+    {
+        if (r == 0)
         {
-            tree_[n_ + i] = a[i];
+            return 0;
         }
-        for (size_t i = n_ - 1; i >= 1; --i)
+
+        r += size_;
+        T acc = Monoid::identity();
+        do
         {
-            tree_[i] = tree_[i << 1] + tree_[i << 1 | 1];
-            if (i == 1) 
+            --r;
+            while (r > 1 && r % 2)
+            {
+                r >>= 1;
+            }
+            if (!pred(Monoid::combine(tree_[r], acc)))
             {
-                break;
+                while (r < size_)
+                {
+                    r = 2 * r + 1;
+                    if (pred(Monoid::combine(tree_[r], acc)))
+                    {
+                        acc = Monoid::combine(tree_[r], acc);
+                        --r;
+                    }
+                }
+                return r + 1 - size_;
             }
+            acc = Monoid::combine(tree_[r], acc);
+        } while ((r & (~r + 1)) != r);
+        return 0;
+    }
+
+private:
+    void pull(const std::size_t i)
+    {
+        tree_[i] = Monoid::combine(tree_[i << 1], tree_[i << 1 | 1]);
+    }
+
+    std::size_t n_ = 0;
+    std::size_t size_ = 1;
+    std::vector<T> tree_ = std::vector<T>(2, Monoid::identity());
+};
+
+// Same layout with a pending tag per internal node. Updates and queries push tags
+// down along the two boundary paths only, then work bottom-up like segment_tree.
+template<typename Monoid, typename Tag>
+class lazy_segment_tree
+{
+public:
+    using value_type = typename Monoid::value_type;
+    using tag_type = typename Tag::tag_type;
+
+    lazy_segment_tree() : lazy_segment_tree(std::size_t{0}) {}
+
+    explicit lazy_segment_tree(const std::size_t n)
+        : lazy_segment_tree(std::vector<value_type>(n, Monoid::identity()))
+    {}
+
+    explicit lazy_segment_tree(const std::vector<value_type>& a) : n_(a.size())
+    {
+        while ((std::size_t{1} << log_) < n_)
+        {
+            ++log_;
         }
+        size_ = std::size_t{1} << log_;
+
+        tree_.assign(2 * size_, Monoid::identity());
+        lazy_.assign(size_, Tag::identity());
+        std::copy(a.begin(), a.end(), tree_.begin() + static_cast<std::ptrdiff_t>(size_));
+        for (std::size_t i = size_ - 1; i >= 1; --i)
+        {
+            pull(i);
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return n_;
+    }
+
+    void set(std::size_t i, const value_type& x)
+    {
+        i += size_;
+        push_path(i);
+        tree_[i] = x;
+        pull_path(i);
+    }
+
+    [[nodiscard]] value_type get(std::size_t i)
+    {
+        i += size_;
+        push_path(i);
+        return tree_[i];
     }
+
+    [[nodiscard]] value_type query(std::size_t l, std::size_t r)
+    {
+        if (l == r)
+        {
+            return Monoid::identity();
+        }
+
+        l += size_;
+        r += size_;
+        push_bounds(l, r);
+
+        value_type left = Monoid::identity();
+        value_type right = Monoid::identity();
+        for (; l < r; l >>= 1, r >>= 1)
+        {
+            if (l & 1)
+            {
+                left = Monoid::combine(left, tree_[l++]);
+            }
+            if (r & 1)
+            {
+                right = Monoid::combine(tree_[--r], right);
+            }
+        }
+        return Monoid::combine(left, right);
+    }
+
+    [[nodiscard]] value_type query_all() const
+    {
+        return tree_[1];
+    }
+
+    void apply(std::size_t i, const tag_type& f)
+    {
+        i += size_;
+        push_path(i);
+        tree_[i] = Tag::apply(f, tree_[i], 1);
+        pull_path(i);
+    }
+
+    // Applies f to every element of [l, r).
+    void apply(std::size_t l, std::size_t r, const tag_type& f)
+    {
+        if (l == r)
+        {
+            return;
+        }
+
+        l += size_;
+        r += size_;
+        push_bounds(l, r);
+
+        for (std::size_t a = l, b = r; a < b; a >>= 1, b >>= 1)
+        {
+            if (a & 1)
+            {
+                apply_node(a++, f);
+            }
+            if (b & 1)
+            {
+                apply_node(--b, f);
+            }
+        }
+
+        for (std::size_t i = 1; i <= log_; ++i)
+        {
+            if (((l >> i) << i) != l)
+            {
+                pull(l >> i);
+            }
+            if (((r >> i) << i) != r)
+            {
+                pull((r - 1) >> i);
+            }
+        }
+    }
+
+    template<typename Pred>
+    [[nodiscard]] std::size_t max_right(std::size_t l, Pred pred)
+    {
+        if (l == n_)
+        {
+            return n_;
+        }
+
+        l += size_;
+        push_path(l);
+        value_type acc = Monoid::identity();
+        do
+        {
+            while (l % 2 == 0)
+            {
+                l >>= 1;
+            }
+            if (!pred(Monoid::combine(acc, tree_[l])))
+            {
+                while (l < size_)
+                {
+                    push(l);
+                    l <<= 1;
+                    if (pred(Monoid::combine(acc, tree_[l])))
+                    {
+                        acc = Monoid::combine(acc, tree_[l]);
+                        ++l;
+                    }
+                }
+                return l - size_;
+            }
+            acc = Monoid::combine(acc, tree_[l]);
+            ++l;
+        } while ((l & (~l + 1)) != l);
+        return n_;
+    }
+
+    template<typename Pred>
+    [[nodiscard]] std::size_t min_left(std::size_t r, Pred pred)
+    {
+        if (r == 0)
+        {
+            return 0;
+        }
+
+        r += size_;
+        push_path(r - 1);
+        value_type acc = Monoid::identity();
+        do
+        {
+            --r;
+            while (r > 1 && r % 2)
+            {
+                r >>= 1;
+            }
+            if (!pred(Monoid::combine(tree_[r], acc)))
+            {
+                while (r < size_)
+                {
+                    push(r);
+                    r = 2 * r + 1;
+                    if (pred(Monoid::combine(tree_[r], acc)))
+                    {
+                        acc = Monoid::combine(tree_[r], acc);
+                        --r;
+                    }
+                }
+                return r + 1 - size_;
+            }
+            acc = Monoid::combine(tree_[r], acc);
+        } while ((r & (~r + 1)) != r);
+        return 0;
+    }
+
+private:
+    std::size_t node_len(const std::size_t k) const noexcept
+    {
+        return size_ >> (63 - mib::detail::countl_zero(k));
+    }
+
+    void pull(const std::size_t k)
+    {
+        tree_[k] = Monoid::combine(tree_[k << 1], tree_[k << 1 | 1]);
+    }
+
+    void apply_node(const std::size_t k, const tag_type& f)
+    {
+        tree_[k] = Tag::apply(f, tree_[k], node_len(k));
+        if (k < size_)
+        {
+            lazy_[k] = Tag::compose(f, lazy_[k]);
+        }
+    }
+
+    void push(const std::size_t k)
+    {
+        apply_node(k << 1, lazy_[k]);
+        apply_node(k << 1 | 1, lazy_[k]);
+        lazy_[k] = Tag::identity();
+    }
+
+    // Pushes every tag above leaf slot i.
+    void push_path(const std::size_t i)
+    {
+        for (std::size_t s = log_; s >= 1; --s)
+        {
+            push(i >> s);
+        }
+    }
+
+    void pull_path(const std::size_t i)
+    {
+        for (std::size_t s = 1; s <= log_; ++s)
+        {
+            pull(i >> s);
+        }
+    }
+
+    // Pushes tags above the boundaries of [l, r) that are not node-aligned.
+    void push_bounds(const std::size_t l, const std::size_t r)
+    {
+        for (std::size_t s = log_; s >= 1; --s)
+        {
+            if (((l >> s) << s) != l)
+            {
+                push(l >> s);
+            }
+            if (((r >> s) << s) != r)
+            {
+                push((r - 1) >> s);
+            }
+        }
+    }
+
+    std::size_t n_ = 0;
+    std::size_t log_ = 0;
+    std::size_t size_ = 1;
+    std::vector<value_type> tree_;
+    std::vector<tag_type> lazy_;
 };
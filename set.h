@@ -6,6 +6,8 @@
 #include <initializer_list>
 #include <utility>
 #include <algorithm>
+#include <vector>
+#include <type_traits>
 
 template<
     class T,
@@ -83,7 +85,7 @@ public:
         using reference = const T&;
 
         const_iterator() : node_(nullptr), tree_(nullptr) {}
-            explicit const_iterator(const iterator& it);
+        const_iterator(const iterator& it);
 
         reference operator*() const;
         pointer operator->() const;
@@ -132,7 +134,7 @@ public:
     set& operator=(set&& other) noexcept;
     set& operator=(std::initializer_list<value_type> ilist);
 
-    static allocator_type get_allocator() noexcept;
+    allocator_type get_allocator() const noexcept;
 
     iterator begin() noexcept;
     const_iterator begin() const noexcept;
@@ -166,6 +168,9 @@ public:
 
     void insert(std::initializer_list<value_type> ilist);
 
+    template<class Range>
+    void insert_range(Range&& range);
+
     template<class... Args>
     std::pair<iterator, bool> emplace(Args&&... args);
 
@@ -241,6 +246,20 @@ private:
     std::pair<Node*, bool> insert_node(const value_type& value);
     std::pair<Node*, bool> insert_node(value_type&& value);
 
+    Node* find_slot(const value_type& value, Node*& parent) const;
+    Node* find_slot(const_iterator hint, const value_type& value, Node*& parent) const;
+    void attach(Node* parent, Node* z);
+
+    template<class InputIt>
+    void build_from(InputIt first, InputIt last);
+    template<class InputIt>
+    Node* build_streaming(InputIt& first, size_type n, size_type depth, size_type red_depth,
+                          std::vector<Node*>& made, bool& ascending);
+    void build_from_nodes(std::vector<Node*>& nodes);
+    static size_type deepest_level(size_type n);
+    static Node* build_balanced(Node* const* nodes, size_type n);
+    static Node* build_subtree(Node* const* nodes, size_type n, size_type depth, size_type red_depth);
+
     void erase_node(Node* z);
 
     void rotate_left(Node* node);
@@ -549,10 +568,7 @@ set<T, Compare, Allocator>::set(const set &other)
     , comp_(other.comp_)
     , alloc_(other.alloc_)
 {
-    for (const T& val : other)
-    {
-        insert(val);
-    }
+    insert(other.begin(), other.end());
 }
 
 
@@ -565,10 +581,7 @@ set<T, Compare, Allocator>::set(const set &other, const Allocator &alloc)
     , comp_(other.comp_)
     , alloc_(alloc)
 {
-    for (const T& val : other)
-    {
-        insert(val);
-    }
+    insert(other.begin(), other.end());
 }
 
 
@@ -638,10 +651,7 @@ set<T, Compare, Allocator> & set<T, Compare, Allocator>::operator=(const set &ot
     alloc_ = other.alloc_;
     comp_ = other.comp_;
 
-    for (const auto &value : other)
-    {
-        insert(value);
-    }
+    insert(other.begin(), other.end());
 
     return *this;
 }
@@ -675,10 +685,7 @@ template<class T, class Compare, class Allocator>
 set<T, Compare, Allocator> & set<T, Compare, Allocator>::operator=(std::initializer_list<value_type> ilist)
 {
     clear();
-    for (const auto &value : ilist)
-    {
-        insert(value);
-    }
+    insert(ilist);
     return *this;
 }
 
@@ -774,9 +781,9 @@ typename set<T, Compare, Allocator>::size_type set<T, Compare, Allocator>::max_s
 
 template<class T, class Compare, class Allocator>
 typename set<T, Compare, Allocator>::allocator_type
-set<T, Compare, Allocator>::get_allocator() noexcept
+set<T, Compare, Allocator>::get_allocator() const noexcept
 {
-    return Allocator();
+    return allocator_type(alloc_);
 }
 
 template<class T, class Compare, class Allocator>
@@ -909,6 +916,8 @@ void set<T, Compare, Allocator>::swap(set &other) noexcept
     }
 
     std::swap(root_, other.root_);
+    std::swap(leftmost_, other.leftmost_);
+    std::swap(rightmost_, other.rightmost_);
     std::swap(size_, other.size_);
     std::swap(comp_, other.comp_);
 
@@ -1311,69 +1320,43 @@ template<class T, class Compare, class Allocator>
 std::pair<typename set<T, Compare, Allocator>::Node*, bool>
 set<T, Compare, Allocator>::insert_node(const value_type &value)
 {
-    Node* y = nullptr;
-    Node* x = root_;
-
-    while (x)
+    Node* parent = nullptr;
+    if (Node* existing = find_slot(value, parent))
     {
-        y = x;
-        if (comp_(value, x->value))
-        {
-            x = x->left;
-        }
-        else if (comp_(x->value, value))
-        {
-            x = x->right;
-        }
-        else
-        {
-            return {x, false};
-        }
+        return {existing, false};
     }
 
     Node* z = create_node(value);
+    attach(parent, z);
+    return {z, true};
+}
 
-    z->parent = y;
-    z->left = z->right = nullptr;
-    z->is_black = false;
-
-    if (!y)
-    {
-        root_ = z;
-    }
-    else if (comp_(z->value, y->value))
-    {
-        y->left = z;
-    }
-    else
-    {
-        y->right = z;
-    }
-
-    ++size_;
-    if (!leftmost_ || comp_(z->value, leftmost_->value))
-    {
-        leftmost_ = z;
-    }
-    if (!rightmost_ || comp_(rightmost_->value, z->value))
+template<class T, class Compare, class Allocator>
+std::pair<typename set<T, Compare, Allocator>::Node*, bool>
+set<T, Compare, Allocator>::insert_node(value_type &&value)
+{
+    Node* parent = nullptr;
+    if (Node* existing = find_slot(value, parent))
     {
-        rightmost_ = z;
+        return {existing, false};
     }
 
-    fix_insert(z);
+    Node* z = create_node(std::move(value));
+    attach(parent, z);
     return {z, true};
 }
 
+// Returns the node equal to value, or nullptr with parent set to where it would go.
 template<class T, class Compare, class Allocator>
-std::pair<typename set<T, Compare, Allocator>::Node*, bool>
-set<T, Compare, Allocator>::insert_node(value_type &&value)
+typename set<T, Compare, Allocator>::Node*
+set<T, Compare, Allocator>::find_slot(const value_type &value, Node *&parent) const
 {
-    Node* y = nullptr;
+    parent = nullptr;
     Node* x = root_;
 
     while (x)
     {
-        y = x;
+        parent = x;
         if (comp_(value, x->value))
         {
             x = x->left;
@@ -1384,41 +1367,90 @@ set<T, Compare, Allocator>::insert_node(value_type &&value)
         }
         else
         {
-            return {x, false};
+            return x;
         }
     }
+    return nullptr;
+}
 
-    Node* z = create_node(std::move(value));
-
-    z->parent = y;
-    z->left = z->right = nullptr;
-    z->is_black = false;
-
-    if (!y)
+// hint is an element next to where value belongs, on either side (the standard one
+// is the element after). A right hint costs two comparisons plus, away from the ends,
+// a short walk to the neighbouring node; a wrong one falls back to a search from the
+// root.
+template<class T, class Compare, class Allocator>
+typename set<T, Compare, Allocator>::Node*
+set<T, Compare, Allocator>::find_slot(const_iterator hint, const value_type &value, Node *&parent) const
+{
+    Node* h = hint.node_;
+    if (!h)
     {
-        root_ = z;
+        if (!root_)
+        {
+            parent = nullptr;
+            return nullptr;
+        }
+        if (comp_(rightmost_->value, value))
+        {
+            parent = rightmost_;
+            return nullptr;
+        }
     }
-    else if (comp_(z->value, y->value))
+    else if (comp_(value, h->value))
     {
-        y->left = z;
+        Node* before = h == leftmost_ ? nullptr : predecessor(h);
+        if (!before || comp_(before->value, value))
+        {
+            // The new node hangs off whichever of the two has a free inner link.
+            parent = h->left ? before : h;
+            return nullptr;
+        }
+    }
+    else if (comp_(h->value, value))
+    {
+        Node* after = h == rightmost_ ? nullptr : successor(h);
+        if (!after || comp_(value, after->value))
+        {
+            parent = h->right ? after : h;
+            return nullptr;
+        }
     }
     else
     {
-        y->right = z;
+        return h;
     }
+    return find_slot(value, parent);
+}
 
-    ++size_;
-    if (!leftmost_ || comp_(z->value, leftmost_->value))
+template<class T, class Compare, class Allocator>
+void set<T, Compare, Allocator>::attach(Node *parent, Node *z)
+{
+    z->parent = parent;
+    z->left = z->right = nullptr;
+    z->is_black = false;
+
+    if (!parent)
+    {
+        root_ = leftmost_ = rightmost_ = z;
+    }
+    else if (comp_(z->value, parent->value))
     {
-        leftmost_ = z;
+        parent->left = z;
+        if (parent == leftmost_)
+        {
+            leftmost_ = z;
+        }
     }
-    if (!rightmost_ || comp_(rightmost_->value, z->value))
+    else
     {
-        rightmost_ = z;
+        parent->right = z;
+        if (parent == rightmost_)
+        {
+            rightmost_ = z;
+        }
     }
 
+    ++size_;
     fix_insert(z);
-    return {z, true};
 }
 
 template<class T, class Compare, class Allocator>
@@ -1443,27 +1475,304 @@ set<T, Compare, Allocator>::insert(value_type &&value)
 }
 
 template<class T, class Compare, class Allocator>
-typename set<T, Compare, Allocator>::iterator set<T, Compare, Allocator>::insert(const_iterator, const value_type &value)
+typename set<T, Compare, Allocator>::iterator set<T, Compare, Allocator>::insert(const_iterator hint, const value_type &value)
 {
-    return insert(value).first;
+    Node* parent = nullptr;
+    if (Node* existing = find_slot(hint, value, parent))
+    {
+        return iterator(existing, this);
+    }
+
+    Node* z = create_node(value);
+    attach(parent, z);
+    return iterator(z, this);
 }
 
 template<class T, class Compare, class Allocator>
-typename set<T, Compare, Allocator>::iterator set<T, Compare, Allocator>::insert(const_iterator, value_type &&value)
+typename set<T, Compare, Allocator>::iterator set<T, Compare, Allocator>::insert(const_iterator hint, value_type &&value)
 {
-    return insert(std::move(value)).first;
+    Node* parent = nullptr;
+    if (Node* existing = find_slot(hint, value, parent))
+    {
+        return iterator(existing, this);
+    }
+
+    Node* z = create_node(std::move(value));
+    attach(parent, z);
+    return iterator(z, this);
 }
 
 template<class T, class Compare, class Allocator>
 template<class InputIt>
 void set<T, Compare, Allocator>::insert(InputIt first, InputIt last)
 {
+    if (!root_)
+    {
+        build_from(first, last);
+        return;
+    }
+
+    // Sorted input lands next to the previous element, so each hint is usually right.
+    const_iterator hint = cend();
     for (; first != last; ++first)
     {
-        insert(*first);
+        hint = insert(hint, *first);
     }
 }
 
+template<class T, class Compare, class Allocator>
+template<class Range>
+void set<T, Compare, Allocator>::insert_range(Range &&range)
+{
+    using std::begin;
+    using std::end;
+
+    insert(begin(range), end(range));
+}
+
+// Fills an empty set from [first, last). Sorted input from a forward iterator takes a
+// single O(n) pass: the size is known, so each node is created and linked straight
+// into its place in a balanced tree as an in-order walk of that tree reaches it.
+// Anything else is gathered and handed to build_from_nodes.
+template<class T, class Compare, class Allocator>
+template<class InputIt>
+void set<T, Compare, Allocator>::build_from(InputIt first, InputIt last)
+{
+    std::vector<Node*> nodes;
+    try
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            if (!count)
+            {
+                return;
+            }
+
+            nodes.reserve(count);
+            bool ascending = true;
+            Node* root = build_streaming(first, count, 0, deepest_level(count), nodes, ascending);
+            if (ascending)
+            {
+                root_ = root;
+                root_->parent = nullptr;
+                size_ = count;
+                leftmost_ = nodes.front();
+                rightmost_ = nodes.back();
+                return;
+            }
+            for (; first != last; ++first)
+            {
+                nodes.push_back(create_node(*first));
+            }
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                nodes.push_back(nullptr);
+                nodes.back() = create_node(*first);
+            }
+        }
+    }
+    catch (...)
+    {
+        for (Node* node : nodes)
+        {
+            destroy_node(node);
+        }
+        throw;
+    }
+
+    build_from_nodes(nodes);
+}
+
+// Builds the subtree of n nodes at depth in the shape build_balanced gives, taking the
+// values from first in order. Every node created goes into made, which has room
+// reserved; at the first value not above its predecessor it clears ascending and
+// stops, leaving the links unfinished.
+template<class T, class Compare, class Allocator>
+template<class InputIt>
+typename set<T, Compare, Allocator>::Node *
+set<T, Compare, Allocator>::build_streaming(InputIt& first, const size_type n, const size_type depth,
+                                            const size_type red_depth, std::vector<Node*>& made, bool& ascending)
+{
+    if (!n)
+    {
+        return nullptr;
+    }
+
+    const size_type left_count = (n - 1) / 2;
+    Node* left = build_streaming(first, left_count, depth + 1, red_depth, made, ascending);
+    if (!ascending)
+    {
+        return nullptr;
+    }
+
+    Node* root = create_node(*first);
+    ++first;
+    made.push_back(root);
+    if (made.size() > 1 && !comp_(made[made.size() - 2]->value, root->value))
+    {
+        ascending = false;
+        return nullptr;
+    }
+
+    root->left = left;
+    if (left)
+    {
+        left->parent = root;
+    }
+    root->right = build_streaming(first, n - left_count - 1, depth + 1, red_depth, made, ascending);
+    if (root->right)
+    {
+        root->right->parent = root;
+    }
+    root->is_black = !(depth && depth == red_depth);
+    return root;
+}
+
+// Links nodes created from unsorted input, given in input order, into the set. Nodes
+// breaking the ascending run are sorted on their own and merged back, so nearly sorted
+// input stays close to linear. Input positions travel with the nodes so that equal
+// values meet in input order and, as with inserting one at a time, the first is kept.
+template<class T, class Compare, class Allocator>
+void set<T, Compare, Allocator>::build_from_nodes(std::vector<Node*>& nodes)
+{
+    const auto by_value = [this](const Node* a, const Node* b)
+    {
+        return comp_(a->value, b->value);
+    };
+
+    // Keep the ascending run in place and set aside what breaks it: a node smaller than
+    // the last kept one displaces that one if it still fits after the one before, so a
+    // single out-of-place node costs one set-aside rather than everything after it.
+    std::vector<size_type> run_pos(nodes.size());
+    std::vector<std::pair<Node*, size_type>> rest;
+    size_type n = 0;
+    for (size_type i = 0; i < nodes.size(); ++i)
+    {
+        Node* node = nodes[i];
+        if (!n || by_value(nodes[n - 1], node))
+        {
+            run_pos[n] = i;
+            nodes[n++] = node;
+        }
+        else if (!by_value(node, nodes[n - 1]))
+        {
+            destroy_node(node);
+        }
+        else if (n == 1 || by_value(nodes[n - 2], node))
+        {
+            rest.emplace_back(nodes[n - 1], run_pos[n - 1]);
+            run_pos[n - 1] = i;
+            nodes[n - 1] = node;
+        }
+        else
+        {
+            rest.emplace_back(node, i);
+        }
+    }
+
+    if (!rest.empty())
+    {
+        std::sort(rest.begin(), rest.end(), [&](const std::pair<Node*, size_type>& a, const std::pair<Node*, size_type>& b)
+        {
+            return by_value(a.first, b.first) || (!by_value(b.first, a.first) && a.second < b.second);
+        });
+
+        // Merge from the back: the run only moves towards the end, so nothing is
+        // overwritten before it is read.
+        size_type i = n;
+        size_type j = rest.size();
+        size_type out = n + rest.size();
+        while (j)
+        {
+            const std::pair<Node*, size_type>& r = rest[j - 1];
+            if (i && (by_value(r.first, nodes[i - 1]) || (!by_value(nodes[i - 1], r.first) && r.second < run_pos[i - 1])))
+            {
+                --i;
+                nodes[--out] = nodes[i];
+            }
+            else
+            {
+                nodes[--out] = r.first;
+                --j;
+            }
+        }
+
+        const size_type total = n + rest.size();
+        n = 0;
+        for (size_type k = 0; k < total; ++k)
+        {
+            if (n && !by_value(nodes[n - 1], nodes[k]))
+            {
+                destroy_node(nodes[k]);
+                continue;
+            }
+            nodes[n++] = nodes[k];
+        }
+    }
+
+    root_ = build_balanced(nodes.data(), n);
+    leftmost_ = n ? nodes[0] : nullptr;
+    rightmost_ = n ? nodes[n - 1] : nullptr;
+    size_ = n;
+}
+
+template<class T, class Compare, class Allocator>
+typename set<T, Compare, Allocator>::size_type
+set<T, Compare, Allocator>::deepest_level(const size_type n)
+{
+    size_type deepest = 0;
+    while ((n >> (deepest + 1)) != 0)
+    {
+        ++deepest;
+    }
+    return deepest;
+}
+
+// Minimal-height tree over n nodes in order. Every null link then sits on one of the
+// two lowest levels, so a red deepest level over black everything else is valid.
+template<class T, class Compare, class Allocator>
+typename set<T, Compare, Allocator>::Node *
+set<T, Compare, Allocator>::build_balanced(Node *const *nodes, const size_type n)
+{
+    Node* root = build_subtree(nodes, n, 0, deepest_level(n));
+    if (root)
+    {
+        root->parent = nullptr;
+    }
+    return root;
+}
+
+template<class T, class Compare, class Allocator>
+typename set<T, Compare, Allocator>::Node *
+set<T, Compare, Allocator>::build_subtree(Node *const *nodes, const size_type n, const size_type depth,
+                                          const size_type red_depth)
+{
+    if (!n)
+    {
+        return nullptr;
+    }
+
+    const size_type left_count = (n - 1) / 2;
+    Node* root = nodes[left_count];
+
+    root->left = build_subtree(nodes, left_count, depth + 1, red_depth);
+    if (root->left)
+    {
+        root->left->parent = root;
+    }
+    root->right = build_subtree(nodes + left_count + 1, n - left_count - 1, depth + 1, red_depth);
+    if (root->right)
+    {
+        root->right->parent = root;
+    }
+    root->is_black = !(depth && depth == red_depth);
+    return root;
+}
+
 template<class T, class Compare, class Allocator>
 void set<T, Compare, Allocator>::insert(std::initializer_list<value_type> ilist)
 {
@@ -1480,9 +1789,10 @@ std::pair<typename set<T, Compare, Allocator>::iterator, bool> set<T, Compare, A
 
 template<class T, class Compare, class Allocator>
 template<class... Args>
-typename set<T, Compare, Allocator>::iterator set<T, Compare, Allocator>::emplace_hint(const_iterator, Args&&... args)
+typename set<T, Compare, Allocator>::iterator set<T, Compare, Allocator>::emplace_hint(const_iterator hint, Args&&... args)
 {
-    return emplace(std::forward<Args>(args)...).first;
+    value_type v(std::forward<Args>(args)...);
+    return insert(hint, std::move(v));
 }
 
 template<class T, class Compare, class Allocator>
@@ -1,36 +1,361 @@
 #pragma once
 
-#include <vector>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <functional>
 
-template<typename K, typename V>
-class skip_list 
+template<typename K, typename V, typename Compare = std::less<K>>
+class skip_list
 {
 public:
-    void insert(const K& k, const V& v) 
+    static constexpr int max_level = 32;
+
+private:
+    struct Node
+    {
+        K key;
+        V value;
+        int height;
+        Node** forward;
+
+        Node(const K& k, const V& v, const int h, Node** links) : key(k), value(v), height(h), forward(links)
+        {
+            for (int i = 0; i < h; ++i)
+            {
+                forward[i] = nullptr;
+            }
+        }
+    };
+
+    struct Head
+    {
+        Node* forward[max_level] = {};
+    };
+
+    template<bool Const>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, std::conditional_t<Const, const V&, V&>>;
+        using pointer = void;
+
+        basic_iterator() = default;
+
+        const K& key() const
+        {
+            return node_->key;
+        }
+
+        std::conditional_t<Const, const V&, V&> value() const
+        {
+            return node_->value;
+        }
+
+        reference operator*() const
+        {
+            return reference(node_->key, node_->value);
+        }
+
+        basic_iterator& operator++()
+        {
+            node_ = node_->forward[0];
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            basic_iterator tmp = *this;
+            node_ = node_->forward[0];
+            return tmp;
+        }
+
+        bool operator==(const basic_iterator& o) const noexcept
+        {
+            return node_ == o.node_;
+        }
+
+        bool operator!=(const basic_iterator& o) const noexcept
+        {
+            return node_ != o.node_;
+        }
+
+    private:
+        friend class skip_list;
+        explicit basic_iterator(Node* n) : node_(n) {}
+
+        Node* node_ = nullptr;
+    };
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    skip_list() = default;
+    explicit skip_list(const Compare& comp, const std::uint64_t seed = 0x9E3779B97F4A7C15ull) : comp_(comp), rng_(seed) {}
+
+    skip_list(const skip_list& other) : comp_(other.comp_), rng_(other.rng_)
     {
-        for (auto& kv : data_) 
+        Node* update[max_level];
+        for (int i = 0; i < max_level; ++i)
+        {
+            update[i] = nullptr;
+        }
+
+        for (Node* n = other.head_.forward[0]; n; n = n->forward[0])
         {
-            if (kv.first == k) 
-            { 
-                kv.second = v; 
-                return; 
+            Node* copy = create_node(n->key, n->value, n->height);
+            for (int i = 0; i < n->height; ++i)
+            {
+                (update[i] ? update[i]->forward[i] : head_.forward[i]) = copy;
+                update[i] = copy;
             }
         }
-        data_.emplace_back(k, v);
+        level_ = other.level_;
+        size_ = other.size_;
+    }
+
+    skip_list(skip_list&& other) noexcept
+        : head_(other.head_), level_(other.level_), size_(other.size_), comp_(std::move(other.comp_)), rng_(other.rng_)
+    {
+        other.head_ = Head{};
+        other.level_ = 1;
+        other.size_ = 0;
     }
 
-    V* find(const K& k) 
+    skip_list& operator=(skip_list other) noexcept
     {
-        for (auto& kv : data_) 
+        std::swap(head_, other.head_);
+        std::swap(level_, other.level_);
+        std::swap(size_, other.size_);
+        std::swap(comp_, other.comp_);
+        std::swap(rng_, other.rng_);
+        return *this;
+    }
+
+    ~skip_list()
+    {
+        clear();
+    }
+
+    void clear() noexcept
+    {
+        Node* n = head_.forward[0];
+        while (n)
         {
-            if (kv.first == k) 
+            Node* next = n->forward[0];
+            destroy_node(n);
+            n = next;
+        }
+        head_ = Head{};
+        level_ = 1;
+        size_ = 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    iterator begin() noexcept
+    {
+        return iterator(head_.forward[0]);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(head_.forward[0]);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator();
+    }
+
+    void insert(const K& k, const V& v)
+    {
+        Node* update[max_level];
+        Node* cur = find_predecessors(k, update);
+
+        if (cur && !comp_(k, cur->key))
+        {
+            cur->value = v;
+            return;
+        }
+
+        const int h = random_level();
+        if (h > level_)
+        {
+            for (int i = level_; i < h; ++i)
             {
-                return &kv.second;
+                update[i] = nullptr;
             }
+            level_ = h;
         }
-        return nullptr;
+
+        Node* n = create_node(k, v, h);
+        for (int i = 0; i < h; ++i)
+        {
+            Node*& link = update[i] ? update[i]->forward[i] : head_.forward[i];
+            n->forward[i] = link;
+            link = n;
+        }
+        ++size_;
+    }
+
+    V* find(const K& k)
+    {
+        Node* n = lower_node(k);
+        return n && !comp_(k, n->key) ? &n->value : nullptr;
+    }
+
+    const V* find(const K& k) const
+    {
+        Node* n = lower_node(k);
+        return n && !comp_(k, n->key) ? &n->value : nullptr;
+    }
+
+    bool contains(const K& k) const
+    {
+        return find(k) != nullptr;
+    }
+
+    iterator lower_bound(const K& k)
+    {
+        return iterator(lower_node(k));
+    }
+
+    const_iterator lower_bound(const K& k) const
+    {
+        return const_iterator(lower_node(k));
+    }
+
+    template<typename F>
+    void for_each_range(const K& lo, const K& hi, F&& f) const
+    {
+        for (const Node* n = lower_node(lo); n && comp_(n->key, hi); n = n->forward[0])
+        {
+            f(n->key, n->value);
+        }
+    }
+
+    bool erase(const K& k)
+    {
+        Node* update[max_level];
+        Node* cur = find_predecessors(k, update);
+
+        if (!cur || comp_(k, cur->key))
+        {
+            return false;
+        }
+
+        for (int i = 0; i < cur->height; ++i)
+        {
+            Node*& link = update[i] ? update[i]->forward[i] : head_.forward[i];
+            link = cur->forward[i];
+        }
+
+        while (level_ > 1 && !head_.forward[level_ - 1])
+        {
+            --level_;
+        }
+
+        destroy_node(cur);
+        --size_;
+        return true;
     }
 
 private:
-    std::vector<std::pair<K,V>> data_;
+    Node* find_predecessors(const K& k, Node** update) const
+    {
+        Node* pred = nullptr;
+        for (int i = level_ - 1; i >= 0; --i)
+        {
+            Node* next = pred ? pred->forward[i] : head_.forward[i];
+            while (next && comp_(next->key, k))
+            {
+                pred = next;
+                next = next->forward[i];
+            }
+            update[i] = pred;
+        }
+        return pred ? pred->forward[0] : head_.forward[0];
+    }
+
+    Node* lower_node(const K& k) const
+    {
+        Node* pred = nullptr;
+        for (int i = level_ - 1; i >= 0; --i)
+        {
+            Node* next = pred ? pred->forward[i] : head_.forward[i];
+            while (next && comp_(next->key, k))
+            {
+                pred = next;
+                next = next->forward[i];
+            }
+        }
+        return pred ? pred->forward[0] : head_.forward[0];
+    }
+
+    int random_level() noexcept
+    {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 7;
+        rng_ ^= rng_ << 17;
+
+        std::uint64_t r = rng_;
+        int h = 1;
+        while ((r & 3) == 0 && h < max_level)
+        {
+            ++h;
+            r >>= 2;
+        }
+        return h;
+    }
+
+    static Node* create_node(const K& k, const V& v, const int h)
+    {
+        void* raw = ::operator new(sizeof(Node) + h * sizeof(Node*));
+        auto** links = reinterpret_cast<Node**>(static_cast<char*>(raw) + sizeof(Node));
+
+        try
+        {
+            return ::new (raw) Node(k, v, h, links);
+        }
+        catch (...)
+        {
+            ::operator delete(raw);
+            throw;
+        }
+    }
+
+    static void destroy_node(Node* n) noexcept
+    {
+        n->~Node();
+        ::operator delete(n);
+    }
+
+    Head head_;
+    int level_ = 1;
+    size_type size_ = 0;
+    Compare comp_;
+    std::uint64_t rng_ = 0x9E3779B97F4A7C15ull;
 };
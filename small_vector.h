@@ -1,61 +1,562 @@
 #pragma once
-#include <vector>
+#include <new>
+#include <memory>
 #include <cstddef>
+#include <cstring>
 #include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
 
+#include "growth_policy.h"
+#include "relocatable.h"
+
+// Keeps up to N elements in the object itself and only touches the heap past that.
 template<typename T, std::size_t N = 8>
 class small_vector
 {
 public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
     small_vector() noexcept = default;
+
+    explicit small_vector(const size_type count)
+    {
+        resize(count);
+    }
+
+    small_vector(const size_type count, const T& value)
+    {
+        assign(count, value);
+    }
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    small_vector(InputIt first, InputIt last)
+    {
+        append(first, last);
+    }
+
+    small_vector(std::initializer_list<T> init)
+    {
+        append(init.begin(), init.end());
+    }
+
+    small_vector(const small_vector& other)
+    {
+        reserve(other.size_);
+        copy_construct(data_, other.data_, other.size_);
+        size_ = other.size_;
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        take(std::move(other));
+    }
+
     ~small_vector()
+    {
+        destroy_range(data_, data_ + size_);
+        release_heap();
+    }
+
+    small_vector& operator=(const small_vector& other)
+    {
+        if (this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other)
+        {
+            destroy_range(data_, data_ + size_);
+            release_heap();
+            size_ = 0;
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    void assign(const size_type count, const T& value)
     {
         clear();
+        if (count > capacity_)
+        {
+            reallocate(count);
+        }
+        std::uninitialized_fill_n(data_, count, value);
+        size_ = count;
     }
 
-    void push_back(const T& v)
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    void assign(InputIt first, InputIt last)
     {
-        data().push_back(v);
+        clear();
+        append(first, last);
     }
-    void push_back(T&& v)
+
+    T& operator[](const size_type i) noexcept
+    {
+        return data_[i];
+    }
+
+    const T& operator[](const size_type i) const noexcept
+    {
+        return data_[i];
+    }
+
+    T& at(const size_type i)
     {
-        data().push_back(std::move(v));
+        if (i >= size_)
+        {
+            throw std::out_of_range("small_vector::at");
+        }
+        return data_[i];
     }
-    template<class... Args> void emplace_back(Args&&... args)
+
+    const T& at(const size_type i) const
     {
-        data().emplace_back(std::forward<Args>(args)...);
+        if (i >= size_)
+        {
+            throw std::out_of_range("small_vector::at");
+        }
+        return data_[i];
     }
 
+    T& front() noexcept { return data_[0]; }
+    const T& front() const noexcept { return data_[0]; }
+    T& back() noexcept { return data_[size_ - 1]; }
+    const T& back() const noexcept { return data_[size_ - 1]; }
+    T* data() noexcept { return data_; }
+    const T* data() const noexcept { return data_; }
+
+    iterator begin() noexcept { return data_; }
+    const_iterator begin() const noexcept { return data_; }
+    const_iterator cbegin() const noexcept { return data_; }
+    iterator end() noexcept { return data_ + size_; }
+    const_iterator end() const noexcept { return data_ + size_; }
+    const_iterator cend() const noexcept { return data_ + size_; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
     [[nodiscard]] std::size_t size() const noexcept
     {
-        return data().size();
+        return size_;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return capacity_;
     }
+
     [[nodiscard]] bool empty() const noexcept
     {
-        return data().empty();
+        return size_ == 0;
+    }
+
+    [[nodiscard]] bool is_inline() const noexcept
+    {
+        return data_ == inline_data();
     }
-    T& operator[](std::size_t i)
+
+    void reserve(const size_type n)
     {
-        return data()[i];
+        if (n > capacity_)
+        {
+            reallocate(n);
+        }
     }
-    const T& operator[](std::size_t i) const
+
+    void shrink_to_fit()
     {
-        return data()[i];
+        if (is_inline() || size_ == capacity_)
+        {
+            return;
+        }
+        reallocate(size_ <= N ? N : size_);
+    }
+
+    void push_back(const T& v)
+    {
+        emplace_back(v);
+    }
+
+    void push_back(T&& v)
+    {
+        emplace_back(std::move(v));
+    }
+
+    template<class... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (size_ == capacity_)
+        {
+            return grow_and_append(std::forward<Args>(args)...);
+        }
+
+        T* p = ::new (static_cast<void*>(data_ + size_)) T(std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    void pop_back() noexcept
+    {
+        --size_;
+        data_[size_].~T();
+    }
+
+    template<class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        const size_type index = static_cast<size_type>(pos - data_);
+        if (index == size_)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return data_ + index;
+        }
+
+        T tmp(std::forward<Args>(args)...);
+        if (size_ == capacity_)
+        {
+            reallocate(next_capacity(size_ + 1));
+        }
+
+        T* p = data_ + index;
+        if constexpr (relocate_bitwise)
+        {
+            std::memmove(static_cast<void*>(p + 1), static_cast<const void*>(p), (size_ - index) * sizeof(T));
+            ::new (static_cast<void*>(p)) T(std::move(tmp));
+        }
+        else
+        {
+            ::new (static_cast<void*>(data_ + size_)) T(std::move(data_[size_ - 1]));
+            std::move_backward(p, data_ + size_ - 1, data_ + size_);
+            *p = std::move(tmp);
+        }
+        ++size_;
+        return p;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator insert(const_iterator pos, const size_type count, const T& value)
+    {
+        const size_type index = static_cast<size_type>(pos - data_);
+        const T copy(value);
+        const size_type old_size = size_;
+
+        reserve(size_ + count);
+        for (size_type i = 0; i < count; ++i)
+        {
+            ::new (static_cast<void*>(data_ + size_)) T(copy);
+            ++size_;
+        }
+        std::rotate(data_ + index, data_ + old_size, data_ + size_);
+        return data_ + index;
+    }
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_type index = static_cast<size_type>(pos - data_);
+        const size_type old_size = size_;
+
+        append(first, last);
+        std::rotate(data_ + index, data_ + old_size, data_ + size_);
+        return data_ + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* f = data_ + (first - data_);
+        T* l = data_ + (last - data_);
+        if (f == l)
+        {
+            return f;
+        }
+
+        T* new_end = std::move(l, data_ + size_, f);
+        destroy_range(new_end, data_ + size_);
+        size_ = static_cast<size_type>(new_end - data_);
+        return f;
+    }
+
+    void resize(const size_type count)
+    {
+        if (count < size_)
+        {
+            destroy_range(data_ + count, data_ + size_);
+        }
+        else if (count > size_)
+        {
+            reserve(count);
+            std::uninitialized_value_construct(data_ + size_, data_ + count);
+        }
+        size_ = count;
+    }
+
+    void resize(const size_type count, const T& value)
+    {
+        if (count < size_)
+        {
+            destroy_range(data_ + count, data_ + size_);
+        }
+        else if (count > size_)
+        {
+            const T copy(value);
+            reserve(count);
+            std::uninitialized_fill(data_ + size_, data_ + count, copy);
+        }
+        size_ = count;
     }
 
     void clear() noexcept
     {
-        data().clear();
+        destroy_range(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    void swap(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend bool operator==(const small_vector& a, const small_vector& b)
+    {
+        return a.size_ == b.size_ && std::equal(a.begin(), a.end(), b.begin());
+    }
+
+    friend bool operator!=(const small_vector& a, const small_vector& b)
+    {
+        return !(a == b);
     }
 
 private:
-    std::vector<T> storage_;
-    std::vector<T>& data()
+    static constexpr bool relocate_bitwise = mib::is_trivially_relocatable_v<T> && std::is_nothrow_move_constructible_v<T>;
+
+    T* inline_data() noexcept
     {
-        return storage_;
+        return std::launder(reinterpret_cast<T*>(inline_));
     }
-    const std::vector<T>& data() const
+
+    const T* inline_data() const noexcept
     {
-        return storage_;
+        return std::launder(reinterpret_cast<const T*>(inline_));
     }
+
+    size_type next_capacity(const size_type required) const noexcept
+    {
+        return mib::default_growth::next_capacity(capacity_, required, sizeof(T));
+    }
+
+    static T* allocate(const size_type n)
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+        else
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+    }
+
+    static void deallocate(T* p) noexcept
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    static void destroy_range(T* first, T* last) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for (; first != last; ++first)
+            {
+                first->~T();
+            }
+        }
+    }
+
+    static void copy_construct(T* dest, const T* src, const size_type n)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (n)
+            {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_copy_n(src, n, dest);
+        }
+    }
+
+    // Moves n elements into raw storage and ends their lifetime at src.
+    static void relocate(T* dest, T* src, const size_type n) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if constexpr (relocate_bitwise)
+        {
+            if (n)
+            {
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_move_n(src, n, dest);
+            destroy_range(src, src + n);
+        }
+    }
+
+    void release_heap() noexcept
+    {
+        if (!is_inline())
+        {
+            deallocate(data_);
+            data_ = inline_data();
+            capacity_ = N;
+        }
+    }
+
+    void reallocate(const size_type new_cap)
+    {
+        T* new_data = new_cap <= N ? inline_data() : allocate(new_cap);
+        if (new_data == data_)
+        {
+            return;
+        }
+
+        relocate(new_data, data_, size_);
+        if (!is_inline())
+        {
+            deallocate(data_);
+        }
+        data_ = new_data;
+        capacity_ = new_cap <= N ? N : new_cap;
+    }
+
+    // The new element is built first so that arguments referring into the old buffer stay valid.
+    template<class... Args>
+    T& grow_and_append(Args&&... args)
+    {
+        const size_type new_cap = next_capacity(size_ + 1);
+        T* new_data = allocate(new_cap);
+
+        try
+        {
+            ::new (static_cast<void*>(new_data + size_)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate(new_data);
+            throw;
+        }
+
+        relocate(new_data, data_, size_);
+        if (!is_inline())
+        {
+            deallocate(data_);
+        }
+        data_ = new_data;
+        capacity_ = new_cap;
+        return data_[size_++];
+    }
+
+    template<typename InputIt>
+    void append(InputIt first, InputIt last)
+    {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+        {
+            const auto n = static_cast<size_type>(std::distance(first, last));
+            if (size_ + n > capacity_)
+            {
+                reallocate(next_capacity(size_ + n));
+            }
+            std::uninitialized_copy(first, last, data_ + size_);
+            size_ += n;
+        }
+        else
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+    }
+
+    void take(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        if (!other.is_inline())
+        {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            other.data_ = other.inline_data();
+            other.capacity_ = N;
+            other.size_ = 0;
+            return;
+        }
+
+        relocate(data_, other.data_, other.size_);
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    T* data_ = inline_data();
+    size_type size_ = 0;
+    size_type capacity_ = N;
+    alignas(T) unsigned char inline_[sizeof(T) * (N ? N : 1)];
 };
@@ -0,0 +1,12 @@
+#pragma once
+
+namespace mib
+{
+// Tag for flat containers: the input is already sorted by the comparator and free of duplicates.
+struct sorted_unique_t
+{
+    explicit sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+}
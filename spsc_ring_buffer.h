@@ -0,0 +1,175 @@
+#pragma once
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+// Single producer, single consumer. Indices grow without wrapping and are masked on
+// access; each side keeps a private copy of the other side's index and only reloads
+// the shared atomic when that copy says the buffer is full (or empty).
+template<typename T>
+class spsc_ring_buffer
+{
+public:
+    static constexpr std::size_t cache_line = 64;
+
+    explicit spsc_ring_buffer(const std::size_t capacity)
+        : mask_(round_up_pow2(capacity) - 1)
+        , slots_(static_cast<T*>(::operator new((mask_ + 1) * sizeof(T), std::align_val_t(slot_align))))
+    {}
+
+    spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+    spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+
+    ~spsc_ring_buffer()
+    {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            const std::size_t w = write_.load(std::memory_order_relaxed);
+            for (std::size_t r = read_.load(std::memory_order_relaxed); r != w; ++r)
+            {
+                slots_[r & mask_].~T();
+            }
+        }
+        ::operator delete(slots_, std::align_val_t(slot_align));
+    }
+
+    template<typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        const std::size_t w = write_.load(std::memory_order_relaxed);
+        if (w - cached_read_ > mask_)
+        {
+            cached_read_ = read_.load(std::memory_order_acquire);
+            if (w - cached_read_ > mask_)
+            {
+                return false;
+            }
+        }
+
+        ::new (static_cast<void*>(slots_ + (w & mask_))) T(std::forward<Args>(args)...);
+        write_.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& v)
+    {
+        return try_emplace(v);
+    }
+
+    bool try_push(T&& v)
+    {
+        return try_emplace(std::move(v));
+    }
+
+    bool try_pop(T& out)
+    {
+        const std::size_t r = read_.load(std::memory_order_relaxed);
+        if (r == cached_write_)
+        {
+            cached_write_ = write_.load(std::memory_order_acquire);
+            if (r == cached_write_)
+            {
+                return false;
+            }
+        }
+
+        T& slot = slots_[r & mask_];
+        out = std::move(slot);
+        slot.~T();
+        read_.store(r + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Publishes up to n elements with a single release store; returns how many fit.
+    template<typename InputIt>
+    std::size_t push_n(InputIt first, const std::size_t n)
+    {
+        const std::size_t w = write_.load(std::memory_order_relaxed);
+        std::size_t free = capacity() - (w - cached_read_);
+        if (free < n)
+        {
+            cached_read_ = read_.load(std::memory_order_acquire);
+            free = capacity() - (w - cached_read_);
+        }
+
+        const std::size_t count = std::min(n, free);
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            ::new (static_cast<void*>(slots_ + ((w + i) & mask_))) T(*first);
+        }
+
+        if (count)
+        {
+            write_.store(w + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    template<typename OutputIt>
+    std::size_t pop_n(OutputIt out, const std::size_t n)
+    {
+        const std::size_t r = read_.load(std::memory_order_relaxed);
+        std::size_t available = cached_write_ - r;
+        if (available < n)
+        {
+            cached_write_ = write_.load(std::memory_order_acquire);
+            available = cached_write_ - r;
+        }
+
+        const std::size_t count = std::min(n, available);
+        for (std::size_t i = 0; i < count; ++i, ++out)
+        {
+            T& slot = slots_[(r + i) & mask_];
+            *out = std::move(slot);
+            slot.~T();
+        }
+
+        if (count)
+        {
+            read_.store(r + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    // Exact only when called from the producer or consumer with the other side idle.
+    [[nodiscard]] std::size_t size_approx() const noexcept
+    {
+        const std::size_t r = read_.load(std::memory_order_acquire);
+        return write_.load(std::memory_order_acquire) - r;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_approx() == 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return mask_ + 1;
+    }
+
+private:
+    static constexpr std::size_t slot_align = alignof(T) > cache_line ? alignof(T) : cache_line;
+
+    static std::size_t round_up_pow2(const std::size_t n) noexcept
+    {
+        std::size_t cap = 1;
+        while (cap < n)
+        {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    const std::size_t mask_;
+    T* const slots_;
+
+    alignas(cache_line) std::atomic<std::size_t> write_{0};
+    std::size_t cached_read_ = 0;
+
+    alignas(cache_line) std::atomic<std::size_t> read_{0};
+    std::size_t cached_write_ = 0;
+};
@@ -1,17 +1,184 @@
 #pragma once
+#include <new>
+#include <limits>
 #include <cstddef>
+#include <cstdint>
 #include <utility>
+#include <iterator>
 #include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+namespace mib
+{
+namespace detail
+{
+template<std::size_t Capacity>
+using static_vector_size_t =
+    std::conditional_t<Capacity <= std::numeric_limits<std::uint8_t>::max(), std::uint8_t,
+    std::conditional_t<Capacity <= std::numeric_limits<std::uint16_t>::max(), std::uint16_t,
+    std::conditional_t<Capacity <= std::numeric_limits<std::uint32_t>::max(), std::uint32_t, std::size_t>>>;
+
+template<typename T, std::size_t Capacity>
+inline constexpr bool static_vector_is_trivial = std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>;
+
+// Trivial elements live in a plain array, which keeps the vector itself trivially
+// copyable and usable in constant expressions.
+template<typename T, std::size_t Capacity, bool Trivial = static_vector_is_trivial<T, Capacity>>
+struct static_vector_storage
+{
+    using size_type = static_vector_size_t<Capacity>;
+
+    constexpr T* ptr() noexcept { return data_; }
+    constexpr const T* ptr() const noexcept { return data_; }
+
+    template<typename... Args>
+    constexpr void construct(const std::size_t i, Args&&... args)
+    {
+        data_[i] = T(std::forward<Args>(args)...);
+    }
+
+    constexpr void destroy(std::size_t) noexcept {}
+
+    T data_[Capacity ? Capacity : 1] = {};
+    size_type size_ = 0;
+};
 
 template<typename T, std::size_t Capacity>
-class static_vector
+struct static_vector_storage<T, Capacity, false>
 {
+    using size_type = static_vector_size_t<Capacity>;
+
+    static_vector_storage() noexcept {}
+
+    static_vector_storage(const static_vector_storage& other)
+    {
+        for (; size_ < other.size_; ++size_)
+        {
+            construct(size_, other.ptr()[size_]);
+        }
+    }
+
+    static_vector_storage(static_vector_storage&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    {
+        for (; size_ < other.size_; ++size_)
+        {
+            construct(size_, std::move(other.ptr()[size_]));
+        }
+    }
+
+    static_vector_storage& operator=(const static_vector_storage& other)
+    {
+        if (this != &other)
+        {
+            assign_from(other.ptr(), other.size_);
+        }
+        return *this;
+    }
+
+    static_vector_storage& operator=(static_vector_storage&& other) noexcept(std::is_nothrow_move_assignable_v<T> && std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != &other)
+        {
+            assign_from(std::make_move_iterator(other.ptr()), other.size_);
+        }
+        return *this;
+    }
+
+    ~static_vector_storage()
+    {
+        while (size_)
+        {
+            destroy(--size_);
+        }
+    }
+
+    T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(raw_)); }
+    const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(raw_)); }
+
+    template<typename... Args>
+    void construct(const std::size_t i, Args&&... args)
+    {
+        ::new (static_cast<void*>(raw_ + i * sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(const std::size_t i) noexcept
+    {
+        ptr()[i].~T();
+    }
+
+    template<typename It>
+    void assign_from(It src, const size_type n)
+    {
+        const size_type common = n < size_ ? n : size_;
+        for (size_type i = 0; i < common; ++i, ++src)
+        {
+            ptr()[i] = *src;
+        }
+        for (; size_ < n; ++size_, ++src)
+        {
+            construct(size_, *src);
+        }
+        while (size_ > n)
+        {
+            destroy(--size_);
+        }
+    }
+
+    alignas(T) unsigned char raw_[sizeof(T) * (Capacity ? Capacity : 1)];
+    size_type size_ = 0;
+};
+}
+}
+
+template<typename T, std::size_t Capacity>
+class static_vector : private mib::detail::static_vector_storage<T, Capacity>
+{
+    using base = mib::detail::static_vector_storage<T, Capacity>;
+
+    using base::ptr;
+    using base::construct;
+    using base::destroy;
+    using base::size_;
+
 public:
-    static_vector() : sz_(0) {}
+    using value_type = T;
+    using size_type = typename base::size_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr static_vector() noexcept = default;
+
+    constexpr static_vector(const std::size_t count, const T& value)
+    {
+        check_capacity(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            push_unchecked(value);
+        }
+    }
 
-    [[nodiscard]] std::size_t size() const noexcept
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    constexpr static_vector(InputIt first, InputIt last)
     {
-        return sz_;
+        for (; first != last; ++first)
+        {
+            push_back(*first);
+        }
+    }
+
+    constexpr static_vector(std::initializer_list<T> init) : static_vector(init.begin(), init.end()) {}
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept
+    {
+        return size_;
     }
 
     static constexpr std::size_t capacity() noexcept
@@ -19,42 +186,321 @@ public:
         return Capacity;
     }
 
-    void push_back(const T& v)
+    static constexpr std::size_t max_size() noexcept
     {
-        if (sz_ >= Capacity)
+        return Capacity;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    [[nodiscard]] constexpr bool full() const noexcept
+    {
+        return size_ == Capacity;
+    }
+
+    constexpr T* data() noexcept { return ptr(); }
+    constexpr const T* data() const noexcept { return ptr(); }
+
+    constexpr iterator begin() noexcept { return ptr(); }
+    constexpr const_iterator begin() const noexcept { return ptr(); }
+    constexpr const_iterator cbegin() const noexcept { return ptr(); }
+    constexpr iterator end() noexcept { return ptr() + size_; }
+    constexpr const_iterator end() const noexcept { return ptr() + size_; }
+    constexpr const_iterator cend() const noexcept { return ptr() + size_; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    constexpr T& operator[](const std::size_t i)
+    {
+        return ptr()[i];
+    }
+    constexpr const T& operator[](const std::size_t i) const
+    {
+        return ptr()[i];
+    }
+
+    constexpr T& at(const std::size_t i)
+    {
+        if (i >= size_)
         {
-            throw std::out_of_range("static_vector overflow");
+            throw std::out_of_range("static_vector::at");
         }
-        new(&data_[sz_]) T(v);
-        ++sz_;
+        return ptr()[i];
     }
 
-    void pop_back()
+    constexpr const T& at(const std::size_t i) const
     {
-        if (sz_)
+        if (i >= size_)
         {
-            --sz_;
-            get_at(sz_).~T();
+            throw std::out_of_range("static_vector::at");
         }
+        return ptr()[i];
+    }
+
+    constexpr T& front() { return ptr()[0]; }
+    constexpr const T& front() const { return ptr()[0]; }
+    constexpr T& back() { return ptr()[size_ - 1]; }
+    constexpr const T& back() const { return ptr()[size_ - 1]; }
+
+    constexpr void push_back(const T& v)
+    {
+        emplace_back(v);
     }
 
-    T& operator[](const std::size_t i)
+    constexpr void push_back(T&& v)
     {
-        return get_at(i);
+        emplace_back(std::move(v));
     }
-    const T& operator[](const std::size_t i) const
+
+    template<typename... Args>
+    constexpr T& emplace_back(Args&&... args)
+    {
+        check_capacity(size_ + 1u);
+        return push_unchecked(std::forward<Args>(args)...);
+    }
+
+    // Non-throwing variant for hot paths: returns nullptr when full.
+    template<typename... Args>
+    constexpr T* try_emplace_back(Args&&... args)
     {
-        return get_at(i);
+        if (full())
+        {
+            return nullptr;
+        }
+        return &push_unchecked(std::forward<Args>(args)...);
     }
+
+    constexpr void pop_back()
+    {
+        if (size_)
+        {
+            --size_;
+            destroy(size_);
+        }
+    }
+
+    template<typename... Args>
+    constexpr iterator emplace(const_iterator pos, Args&&... args)
+    {
+        const std::size_t index = static_cast<std::size_t>(pos - ptr());
+        check_capacity(size_ + 1u);
+
+        if (index == size_)
+        {
+            push_unchecked(std::forward<Args>(args)...);
+            return ptr() + index;
+        }
+
+        T tmp(std::forward<Args>(args)...);
+        construct(size_, std::move(ptr()[size_ - 1]));
+        for (std::size_t i = size_ - 1; i > index; --i)
+        {
+            ptr()[i] = std::move(ptr()[i - 1]);
+        }
+        ptr()[index] = std::move(tmp);
+        ++size_;
+        return ptr() + index;
+    }
+
+    constexpr iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    constexpr iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    constexpr iterator insert(const_iterator pos, const std::size_t count, const T& value)
+    {
+        const std::size_t index = static_cast<std::size_t>(pos - ptr());
+        const std::size_t old_size = size_;
+        check_capacity(size_ + count);
+
+        const T copy(value);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            push_unchecked(copy);
+        }
+        rotate_tail(index, old_size);
+        return ptr() + index;
+    }
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    constexpr iterator insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        const std::size_t index = static_cast<std::size_t>(pos - ptr());
+        const std::size_t old_size = size_;
+
+        for (; first != last; ++first)
+        {
+            push_back(*first);
+        }
+        rotate_tail(index, old_size);
+        return ptr() + index;
+    }
+
+    constexpr iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    constexpr iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr iterator erase(const_iterator first, const_iterator last)
+    {
+        const auto f = static_cast<std::size_t>(first - ptr());
+        const auto l = static_cast<std::size_t>(last - ptr());
+        if (f == l)
+        {
+            return ptr() + f;
+        }
+
+        std::size_t out = f;
+        for (std::size_t i = l; i < size_; ++i, ++out)
+        {
+            ptr()[out] = std::move(ptr()[i]);
+        }
+        while (size_ > out)
+        {
+            --size_;
+            destroy(size_);
+        }
+        return ptr() + f;
+    }
+
+    constexpr void resize(const std::size_t count)
+    {
+        check_capacity(count);
+        while (size_ > count)
+        {
+            pop_back();
+        }
+        while (size_ < count)
+        {
+            push_unchecked();
+        }
+    }
+
+    constexpr void resize(const std::size_t count, const T& value)
+    {
+        check_capacity(count);
+        while (size_ > count)
+        {
+            pop_back();
+        }
+        while (size_ < count)
+        {
+            push_unchecked(value);
+        }
+    }
+
+    constexpr void clear() noexcept
+    {
+        while (size_)
+        {
+            --size_;
+            destroy(size_);
+        }
+    }
+
+    constexpr void assign(const std::size_t count, const T& value)
+    {
+        clear();
+        resize(count, value);
+    }
+
+    template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+    constexpr void assign(InputIt first, InputIt last)
+    {
+        clear();
+        for (; first != last; ++first)
+        {
+            push_back(*first);
+        }
+    }
+
+    constexpr void swap(static_vector& other)
+    {
+        static_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend constexpr bool operator==(const static_vector& a, const static_vector& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            if (!(a[i] == b[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend constexpr bool operator!=(const static_vector& a, const static_vector& b)
+    {
+        return !(a == b);
+    }
+
 private:
-    alignas(T) unsigned char data_[sizeof(T)*Capacity]{};
-    std::size_t sz_;
-    T& get_at(const std::size_t i)
+    static constexpr void check_capacity(const std::size_t n)
     {
-        return *reinterpret_cast<T*>(data_ + sizeof(T)*i);
+        if (n > Capacity)
+        {
+            throw std::out_of_range("static_vector overflow");
+        }
+    }
+
+    template<typename... Args>
+    constexpr T& push_unchecked(Args&&... args)
+    {
+        construct(size_, std::forward<Args>(args)...);
+        ++size_;
+        return ptr()[size_ - 1];
     }
-    const T& get_at(const std::size_t i) const
+
+    // Rotates [old_size, size) in front of [index, old_size).
+    constexpr void rotate_tail(const std::size_t index, const std::size_t old_size)
     {
-        return *reinterpret_cast<const T*>(data_ + sizeof(T)*i);
+        std::size_t first = index;
+        std::size_t middle = old_size;
+        std::size_t next = middle;
+
+        if (first == middle || middle == size_)
+        {
+            return;
+        }
+
+        while (first != next)
+        {
+            T tmp(std::move(ptr()[first]));
+            ptr()[first] = std::move(ptr()[next]);
+            ptr()[next] = std::move(tmp);
+            ++first;
+            ++next;
+            if (next == size_)
+            {
+                next = middle;
+            }
+            else if (first == middle)
+            {
+                middle = next;
+            }
+        }
     }
 };
@@ -1,93 +1,188 @@
 #pragma once
-#include <vector>
+#include <tuple>
 #include <utility>
 #include <optional>
+#include <stdexcept>
 #include <functional>
+#include <initializer_list>
 
-template<typename K, typename V, typename Hash = std::hash<K>>
-class unordered_map 
+#include "flat_hash_table.h"
+
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class unordered_map
 {
+    using table_type = mib::flat_hash_table<mib::map_slot_policy<K, V>, Hash, KeyEqual>;
+
+    template<typename Q>
+    using enable_transparent = std::enable_if_t<mib::detail::is_transparent_lookup<Hash, KeyEqual, Q>::value, int>;
+
 public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using iterator = typename table_type::iterator;
+    using const_iterator = typename table_type::const_iterator;
+
     unordered_map() = default;
-    std::optional<V> get(const K& key) const 
+
+    explicit unordered_map(const size_type bucket_hint, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual())
+        : table_(bucket_hint, hash, eq)
+    {}
+
+    unordered_map(std::initializer_list<value_type> init)
     {
-        if (buckets_.empty()) 
+        reserve(init.size());
+        for (const auto& kv : init)
         {
-            return {};
+            insert(kv.first, kv.second);
         }
+    }
 
-        const auto& bucket = buckets_[Hash{}(key) % buckets_.size()];
-
-        for (const auto& kv : bucket) 
+    std::optional<V> get(const K& key) const
+    {
+        const auto it = table_.find(key);
+        if (it == table_.end())
         {
-            if (kv.first == key) 
-            {
-                return kv.second;
-            }
+            return {};
         }
-        return {};
+        return it->second;
     }
 
-    void insert(const K& key, const V& val) 
+    template<typename Q, enable_transparent<Q> = 0>
+    std::optional<V> get(const Q& key) const
     {
-        if (buckets_.empty()) 
+        const auto it = table_.find(key);
+        if (it == table_.end())
         {
-            buckets_.resize(16);
+            return {};
         }
+        return it->second;
+    }
 
-        auto& bucket = buckets_[Hash{}(key) % buckets_.size()];
-        for (auto& kv : bucket) 
+    void insert(const K& key, const V& val)
+    {
+        auto [it, inserted] = try_emplace(key, val);
+        if (!inserted)
         {
-            if (kv.first == key) 
-            { 
-                kv.second = val; 
-                return; 
-            }
+            it->second = val;
         }
+    }
 
-        bucket.emplace_back(key, val);
-        ++size_;
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        return table_.emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        return table_.emplace_key(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    V& operator[](const K& key)
+    {
+        return try_emplace(key).first->second;
+    }
 
-        if (size_ > buckets_.size()) 
+    V& at(const K& key)
+    {
+        const auto it = table_.find(key);
+        if (it == table_.end())
         {
-            rehash(buckets_.size() * 2);
+            throw std::out_of_range("unordered_map::at");
         }
+        return it->second;
     }
 
-    bool contains(const K& key) const 
+    const V& at(const K& key) const
     {
-        if (buckets_.empty()) 
+        const auto it = table_.find(key);
+        if (it == table_.end())
         {
-            return false;
+            throw std::out_of_range("unordered_map::at");
         }
+        return it->second;
+    }
 
-        const auto& bucket = buckets_[Hash{}(key) % buckets_.size()];
+    bool contains(const K& key) const
+    {
+        return table_.contains(key);
+    }
 
-        for (const auto& kv : bucket) 
-        {
-            if (kv.first == key) 
-            {
-                return true;
-            }
-        }
+    template<typename Q, enable_transparent<Q> = 0>
+    bool contains(const Q& key) const
+    {
+        return table_.contains(key);
+    }
 
-        return false;
+    iterator find(const K& key)
+    {
+        return table_.find(key);
     }
 
-private:
-    void rehash(std::size_t new_bucket_count) 
+    const_iterator find(const K& key) const
     {
-        std::vector<std::vector<std::pair<K,V>>> new_buckets(new_bucket_count);
-        for (const auto& bucket : buckets_) 
-        {
-            for (const auto& kv : bucket) 
-            {
-                new_buckets[Hash{}(kv.first) % new_bucket_count].push_back(kv);
-            }
-        }
-        buckets_.swap(new_buckets);
+        return table_.find(key);
+    }
+
+    template<typename Q, enable_transparent<Q> = 0>
+    iterator find(const Q& key)
+    {
+        return table_.find(key);
+    }
+
+    template<typename Q, enable_transparent<Q> = 0>
+    const_iterator find(const Q& key) const
+    {
+        return table_.find(key);
+    }
+
+    size_type erase(const K& key)
+    {
+        return table_.erase_key(key);
     }
 
-    std::vector<std::vector<std::pair<K,V>>> buckets_;
-    std::size_t size_ = 0;
+    template<typename Q, enable_transparent<Q> = 0>
+    size_type erase(const Q& key)
+    {
+        return table_.erase_key(key);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return table_.erase(pos);
+    }
+
+    iterator erase(iterator pos)
+    {
+        return table_.erase(pos);
+    }
+
+    iterator begin() noexcept { return table_.begin(); }
+    const_iterator begin() const noexcept { return table_.begin(); }
+    const_iterator cbegin() const noexcept { return table_.begin(); }
+    iterator end() noexcept { return table_.end(); }
+    const_iterator end() const noexcept { return table_.end(); }
+    const_iterator cend() const noexcept { return table_.end(); }
+
+    [[nodiscard]] size_type size() const noexcept { return table_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return table_.empty(); }
+    [[nodiscard]] size_type capacity() const noexcept { return table_.capacity(); }
+    [[nodiscard]] float load_factor() const noexcept { return table_.load_factor(); }
+    [[nodiscard]] mib::flat_hash_stats memory_stats() const { return table_.stats(); }
+
+    void reserve(const size_type n) { table_.reserve(n); }
+    void rehash(const size_type n) { table_.rehash(n); }
+    void clear() noexcept { table_.clear(); }
+    void swap(unordered_map& other) noexcept { table_.swap(other.table_); }
+
+    hasher hash_function() const { return table_.hash_function(); }
+    key_equal key_eq() const { return table_.key_eq(); }
+
+private:
+    table_type table_;
 };
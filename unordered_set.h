@@ -1,56 +1,109 @@
 #pragma once
-#include <vector>
+#include <utility>
 #include <functional>
-#include <algorithm>
+#include <initializer_list>
 
-template<typename T, typename Hash = std::hash<T>>
-class unordered_set 
+#include "flat_hash_table.h"
+
+template<typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class unordered_set
 {
+    using table_type = mib::flat_hash_table<mib::set_slot_policy<T>, Hash, KeyEqual>;
+
+    template<typename Q>
+    using enable_transparent = std::enable_if_t<mib::detail::is_transparent_lookup<Hash, KeyEqual, Q>::value, int>;
+
 public:
-    unordered_set(): buckets_(16), size_(0) {}
+    using key_type = T;
+    using value_type = T;
+    using size_type = std::size_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using iterator = typename table_type::const_iterator;
+    using const_iterator = typename table_type::const_iterator;
+
+    unordered_set() = default;
+
+    explicit unordered_set(const size_type bucket_hint, const Hash& hash = Hash(), const KeyEqual& eq = KeyEqual())
+        : table_(bucket_hint, hash, eq)
+    {}
 
-    void insert(const T& v) 
+    unordered_set(std::initializer_list<T> init)
     {
-        if (contains(v)) 
+        reserve(init.size());
+        for (const auto& v : init)
         {
-            return;
+            insert(v);
         }
+    }
 
-        if (size_ + 1 > buckets_.size()) 
-        {
-            rehash(buckets_.size() * 2);
-        }   
-        auto& bucket = buckets_[Hash{}(v) % buckets_.size()];
+    std::pair<iterator, bool> insert(const T& v)
+    {
+        return table_.emplace_key(v, v);
+    }
 
-        bucket.push_back(v);
-        ++size_;
+    std::pair<iterator, bool> insert(T&& v)
+    {
+        return table_.emplace_key(v, std::move(v));
     }
 
-    bool contains(const T& v) const 
+    bool contains(const T& v) const
     {
-        if (buckets_.empty()) 
-        {
-            return false;
-        }
-        
-        const auto& bucket = buckets_[Hash{}(v) % buckets_.size()];
-        return std::find(bucket.begin(), bucket.end(), v) != bucket.end();
+        return table_.contains(v);
     }
 
-private:
-    void rehash(std::size_t new_bucket_count) 
+    template<typename Q, enable_transparent<Q> = 0>
+    bool contains(const Q& v) const
     {
-        std::vector<std::vector<T>> new_buckets(new_bucket_count);
-        for (const auto& bucket : buckets_) 
-        {
-            for (const auto& val : bucket) 
-            {
-                new_buckets[Hash{}(val) % new_bucket_count].push_back(val);
-            }
-        }
-        buckets_.swap(new_buckets);
+        return table_.contains(v);
+    }
+
+    const_iterator find(const T& v) const
+    {
+        return table_.find(v);
     }
 
-    std::vector<std::vector<T>> buckets_;
-    std::size_t size_;
+    template<typename Q, enable_transparent<Q> = 0>
+    const_iterator find(const Q& v) const
+    {
+        return table_.find(v);
+    }
+
+    size_type erase(const T& v)
+    {
+        return table_.erase_key(v);
+    }
+
+    template<typename Q, enable_transparent<Q> = 0>
+    size_type erase(const Q& v)
+    {
+        return table_.erase_key(v);
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return table_.erase(pos);
+    }
+
+    const_iterator begin() const noexcept { return table_.begin(); }
+    const_iterator cbegin() const noexcept { return table_.begin(); }
+    const_iterator end() const noexcept { return table_.end(); }
+    const_iterator cend() const noexcept { return table_.end(); }
+
+    [[nodiscard]] size_type size() const noexcept { return table_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return table_.empty(); }
+    [[nodiscard]] size_type capacity() const noexcept { return table_.capacity(); }
+    [[nodiscard]] float load_factor() const noexcept { return table_.load_factor(); }
+    [[nodiscard]] mib::flat_hash_stats memory_stats() const { return table_.stats(); }
+
+    void reserve(const size_type n) { table_.reserve(n); }
+    void rehash(const size_type n) { table_.rehash(n); }
+    void clear() noexcept { table_.clear(); }
+    void swap(unordered_set& other) noexcept { table_.swap(other.table_); }
+
+    hasher hash_function() const { return table_.hash_function(); }
+    key_equal key_eq() const { return table_.key_eq(); }
+
+private:
+    table_type table_;
 };
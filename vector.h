@@ -6,8 +6,12 @@
 #include <initializer_list>
 #include <algorithm>
 #include <stdexcept>
+#include <cstring>
 
-template <typename T, typename Alloc = std::allocator<T>>
+#include "growth_policy.h"
+#include "relocatable.h"
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = mib::default_growth>
 class vector {
 public:
     using value_type             = T;
@@ -23,6 +27,7 @@ public:
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
     using difference_type        = typename traits_type::difference_type;
     using size_type              = typename traits_type::size_type;
+    using growth_policy          = Growth;
 
     constexpr vector() noexcept(std::is_nothrow_default_constructible_v<allocator_type>);
     explicit vector(const allocator_type& alloc) noexcept;
@@ -161,9 +166,15 @@ private:
 
     void destroy_elements(pointer first, pointer last) noexcept;
     void move_range(pointer dest, pointer first, pointer last) noexcept;
+    void relocate_range(pointer first, pointer last, pointer dest) noexcept;
 
     static void copy_range(pointer dest, const_pointer first, const_pointer last);
+    size_type recommend(size_type required) const;
     void reallocate_grow(size_type new_cap);
+    pointer open_gap(size_type index, size_type n);
+
+    template <class... Args>
+    void realloc_append(Args&&... args);
 
     template <typename InputIt>
     void construct_from_range(InputIt first, InputIt last, std::true_type /*is_forward_or_better*/);
@@ -174,18 +185,18 @@ private:
     void check_range(size_type pos) const;
 };
 
-template<typename T, typename Alloc>
-constexpr vector<T, Alloc>::vector() noexcept(std::is_nothrow_default_constructible_v<allocator_type>)
+template<typename T, typename Alloc, typename Growth>
+constexpr vector<T, Alloc, Growth>::vector() noexcept(std::is_nothrow_default_constructible_v<allocator_type>)
     : alloc_(), data_(nullptr), size_(0), capacity_(0)
 {}
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(const allocator_type &alloc) noexcept
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(const allocator_type &alloc) noexcept
     : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
 {}
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(size_type n, const allocator_type &alloc)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(size_type n, const allocator_type &alloc)
     : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
 {
     if (n > 0)
@@ -199,8 +210,8 @@ vector<T, Alloc>::vector(size_type n, const allocator_type &alloc)
     }
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(size_type n, const value_type &value, const allocator_type &alloc)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(size_type n, const value_type &value, const allocator_type &alloc)
     : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
 {
     if (n > 0)
@@ -214,9 +225,9 @@ vector<T, Alloc>::vector(size_type n, const value_type &value, const allocator_t
     }
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt, typename>
-vector<T, Alloc>::vector(InputIt first, InputIt last, const allocator_type &alloc)
+vector<T, Alloc, Growth>::vector(InputIt first, InputIt last, const allocator_type &alloc)
     : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
 {
     size_type n = std::distance(first, last);
@@ -233,8 +244,8 @@ vector<T, Alloc>::vector(InputIt first, InputIt last, const allocator_type &allo
     }
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(std::initializer_list<value_type> il, const allocator_type &alloc)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(std::initializer_list<value_type> il, const allocator_type &alloc)
     : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
 {
     size_type n = il.size();
@@ -251,8 +262,8 @@ vector<T, Alloc>::vector(std::initializer_list<value_type> il, const allocator_t
     }
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(const vector &other)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(const vector &other)
     : alloc_(traits_type::select_on_container_copy_construction(other.alloc_))
     , size_(other.size_)
     , capacity_(other.capacity_)
@@ -264,8 +275,8 @@ vector<T, Alloc>::vector(const vector &other)
     }
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(const vector &other, const allocator_type &alloc)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(const vector &other, const allocator_type &alloc)
     : alloc_(alloc)
 {
     size_ = other.size();
@@ -275,8 +286,8 @@ vector<T, Alloc>::vector(const vector &other, const allocator_type &alloc)
 }
 
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(vector &&other) noexcept
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(vector &&other) noexcept(std::is_nothrow_move_constructible_v<allocator_type>)
     : alloc_(std::move(other.alloc_)),
       data_(other.data_),
       size_(other.size_),
@@ -287,8 +298,8 @@ vector<T, Alloc>::vector(vector &&other) noexcept
     other.capacity_ = 0;
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::vector(vector &&other, const allocator_type &alloc)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::vector(vector &&other, const allocator_type &alloc)
     : alloc_(alloc)
 {
     if (alloc_ == other.alloc_)
@@ -310,8 +321,8 @@ vector<T, Alloc>::vector(vector &&other, const allocator_type &alloc)
     }
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>::~vector()
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>::~vector()
 {
     if (data_ != nullptr)
     {
@@ -323,8 +334,8 @@ vector<T, Alloc>::~vector()
     }
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>& vector<T, Alloc>::operator=(const vector &other)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(const vector &other)
 {
     if (this != &other)
     {
@@ -359,10 +370,10 @@ vector<T, Alloc>& vector<T, Alloc>::operator=(const vector &other)
     return *this;
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>& vector<T, Alloc>::operator=(vector &&other) noexcept(
-    traits_type::propagate_on_container_move_assignment::value ||
-    std::is_nothrow_move_assignable<allocator_type>::value)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(vector &&other) noexcept(
+    std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value ||
+    std::is_nothrow_move_assignable_v<allocator_type>)
 {
     if (this != &other)
     {
@@ -391,8 +402,8 @@ vector<T, Alloc>& vector<T, Alloc>::operator=(vector &&other) noexcept(
     return *this;
 }
 
-template<typename T, typename Alloc>
-vector<T, Alloc>& vector<T, Alloc>::operator=(std::initializer_list<value_type> il)
+template<typename T, typename Alloc, typename Growth>
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(std::initializer_list<value_type> il)
 {
     for (size_type i = 0; i < size_; ++i)
     {
@@ -417,9 +428,9 @@ vector<T, Alloc>& vector<T, Alloc>::operator=(std::initializer_list<value_type>
     return *this;
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt, typename>
-void vector<T, Alloc>::assign(InputIt first, InputIt last)
+void vector<T, Alloc, Growth>::assign(InputIt first, InputIt last)
 {
     clear();
 
@@ -434,8 +445,8 @@ void vector<T, Alloc>::assign(InputIt first, InputIt last)
     std::uninitialized_copy(first, last, data_);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::assign(size_type n, const value_type &val)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::assign(size_type n, const value_type &val)
 {
     clear();
     if (n > capacity_)
@@ -449,264 +460,209 @@ void vector<T, Alloc>::assign(size_type n, const value_type &val)
     std::uninitialized_fill_n(data_, n, val);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::assign(std::initializer_list<value_type> il)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::assign(std::initializer_list<value_type> il)
 {
     assign(il.begin(), il.end());
 }
 
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::reference vector<T, Alloc>::at(size_type pos)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::reference vector<T, Alloc, Growth>::at(size_type pos)
 {
     check_range(pos);
     return data_[pos];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reference vector<T, Alloc>::at(size_type pos) const
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reference vector<T, Alloc, Growth>::at(size_type pos) const
 {
     check_range(pos);
     return data_[pos];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::reference vector<T, Alloc>::operator[](size_type pos) noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::reference vector<T, Alloc, Growth>::operator[](size_type pos) noexcept
 {
     return data_[pos];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reference vector<T, Alloc>::operator[](size_type pos) const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reference vector<T, Alloc, Growth>::operator[](size_type pos) const noexcept
 {
     return data_[pos];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::reference vector<T, Alloc>::front()
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::reference vector<T, Alloc, Growth>::front()
 {
     return data_[0];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reference vector<T, Alloc>::front() const
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reference vector<T, Alloc, Growth>::front() const
 {
     return data_[0];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::reference vector<T, Alloc>::back()
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::reference vector<T, Alloc, Growth>::back()
 {
     return data_[size_ - 1];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reference vector<T, Alloc>::back() const
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reference vector<T, Alloc, Growth>::back() const
 {
     return data_[size_ - 1];
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::pointer vector<T, Alloc>::data() noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::pointer vector<T, Alloc, Growth>::data() noexcept
 {
     return data_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_pointer vector<T, Alloc>::data() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_pointer vector<T, Alloc, Growth>::data() const noexcept
 {
     return data_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator vector<T, Alloc>::begin() noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::begin() noexcept
 {
     return data_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_iterator vector<T, Alloc>::begin() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::begin() const noexcept
 {
     return data_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_iterator vector<T, Alloc>::cbegin() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::cbegin() const noexcept
 {
     return data_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator vector<T, Alloc>::end() noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::end() noexcept
 {
     return data_ + size_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_iterator vector<T, Alloc>::end() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::end() const noexcept
 {
     return data_ + size_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_iterator vector<T, Alloc>::cend() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_iterator vector<T, Alloc, Growth>::cend() const noexcept
 {
     return data_ + size_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::reverse_iterator vector<T, Alloc>::rbegin() noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::reverse_iterator vector<T, Alloc, Growth>::rbegin() noexcept
 {
     return reverse_iterator(end());
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::rbegin() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::rbegin() const noexcept
 {
     return const_reverse_iterator(end());
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::crbegin() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::crbegin() const noexcept
 {
     return const_reverse_iterator(end());
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::reverse_iterator vector<T, Alloc>::rend() noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::reverse_iterator vector<T, Alloc, Growth>::rend() noexcept
 {
     return reverse_iterator(begin());
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::rend() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::rend() const noexcept
 {
     return const_reverse_iterator(begin());
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::const_reverse_iterator vector<T, Alloc>::crend() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::const_reverse_iterator vector<T, Alloc, Growth>::crend() const noexcept
 {
     return const_reverse_iterator(begin());
 }
 
-template<typename T, typename Alloc>
-bool vector<T, Alloc>::empty() const noexcept
+template<typename T, typename Alloc, typename Growth>
+bool vector<T, Alloc, Growth>::empty() const noexcept
 {
     return size_ == 0;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::size_type vector<T, Alloc>::size() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::size_type vector<T, Alloc, Growth>::size() const noexcept
 {
     return size_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::size_type vector<T, Alloc>::max_size() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::size_type vector<T, Alloc, Growth>::max_size() const noexcept
 {
     return traits_type::max_size(alloc_);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::reserve(size_type new_cap)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::reserve(size_type new_cap)
 {
     if (new_cap <= capacity_)
     {
         return;
     }
 
-    pointer new_data = alloc_.allocate(new_cap);
-    size_type i = 0;
-
-    try
+    if (new_cap > max_size())
     {
-        if (size_ > 0 && data_ != nullptr)
-        {
-            for (size_type size = 0; size < size_; ++size)
-            {
-                if (data[i] != nullptr)
-                {
-                    traits_type::construct(alloc_, new_data + size, std::move_if_noexcept(data_[size]));
-                }
-            }
-        }
-    }
-    catch (...)
-    {
-        for (size_type j = 0; j < i; ++j)
-        {
-            traits_type::destroy(alloc_, new_data + j);
-        }
-        alloc_.deallocate(new_data, new_cap);
-        throw;
+        throw std::length_error("vector::reserve: new_cap > max_size()");
     }
 
-    for (size_type size = 0; size < size_; ++size)
-    {
-        traits_type::destroy(alloc_, data_ + size);
-    }
-
-    if (data_ != nullptr)
-    {
-        alloc_.deallocate(data_, capacity_);
-    }
-
-    data_ = new_data;
-    capacity_ = new_cap;
+    reallocate_grow(new_cap);
 }
 
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::size_type vector<T, Alloc>::capacity() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::size_type vector<T, Alloc, Growth>::capacity() const noexcept
 {
     return capacity_;
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::shrink_to_fit()
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::shrink_to_fit()
 {
-    if (capacity_ > size_)
+    if (capacity_ == size_)
     {
-        if (size_ == 0)
-        {
-            if (data_ != nullptr)
-            {
-                alloc_.deallocate(data_, capacity_);
-                data_ = nullptr;
-                capacity_ = 0;
-            }
-        }
-        else
-        {
-            pointer new_data = alloc_.allocate(size_);
-
-            if (data_ != nullptr && size_ > 0)
-            {
-                for (size_type i = 0; i < size_; ++i)
-                {
-                    if (data_[i] != nullptr)
-                    {
-                        traits_type::construct(alloc_, new_data + i, std::move_if_noexcept(data_[i]));
-                    }
-                }
-            }
-
-            for (size_type i = 0; i < size_; ++i)
-            {
-                traits_type::destroy(alloc_, data_ + i);
-            }
-
-            alloc_.deallocate(data_, capacity_);
+        return;
+    }
 
-            data_ = new_data;
-            capacity_ = size_;
-        }
+    if (size_ == 0)
+    {
+        deallocate(data_, capacity_);
+        data_ = nullptr;
+        capacity_ = 0;
+        return;
     }
+
+    reallocate_grow(size_);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::clear() noexcept
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::clear() noexcept
 {
     for (size_type i = 0; i < size_; ++i)
     {
@@ -715,126 +671,46 @@ void vector<T, Alloc>::clear() noexcept
     size_ = 0;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(const_iterator pos, const value_type &value)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(const_iterator pos, const value_type &value)
 {
-    size_type index = pos - begin();
-
-    if (size_ == capacity_)
-    {
-        size_type new_cap;
-        if (capacity_ == 0)
-        {
-            new_cap = 1;
-        }
-        else
-        {
-            new_cap = capacity_ * 2;
-        }
-        reserve(new_cap);
-    }
-
-    for (size_type i = size_; i > index; --i)
-    {
-        if (i == size_)
-        {
-            traits_type::construct(alloc_, data_ + i, std::move_if_noexcept(data_[i - 1]));
-        }
-        else
-        {
-            data_[i] = std::move_if_noexcept(data_[i - 1]);
-        }
-    }
-
-    if (index < size_)
-    {
-        data_[index] = value;
-    }
-    else
-    {
-        traits_type::construct(alloc_, data_ + index, value);
-    }
-    ++size_;
-
-    return begin() + index;
+    return emplace(pos, value);
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(const_iterator pos, value_type &&value)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(const_iterator pos, value_type &&value)
 {
-    size_type index = pos - begin();
-    if (size_ == capacity_)
-    {
-        size_type new_cap;
-        if (capacity_ == 0)
-        {
-            new_cap = 1;
-        }
-        else
-        {
-            new_cap = capacity_ * 2;
-        }
-        reserve(new_cap);
-    }
-
-    for (size_type i = size_; i > index; --i)
-    {
-        if (i == size_)
-        {
-            traits_type::construct(alloc_, data_ + i, std::move_if_noexcept(data_[i - 1]));
-        }
-        else
-        {
-            data_[i] = std::move_if_noexcept(data_[i - 1]);
-        }
-    }
-
-    if (index < size_)
-    {
-        data_[index] = std::move_if_noexcept(value);
-    }
-    else
-    {
-        traits_type::construct(alloc_, data_ + index, value);
-    }
-    ++size_;
-
-    return begin() + index;
+    return emplace(pos, std::move(value));
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator
-vector<T, Alloc>::insert(const_iterator pos, size_type n, const value_type &value)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, size_type n, const value_type &value)
 {
     size_type index = pos - begin();
-    size_type insert_pos = index;
 
-    if (size_ + n > capacity_)
+    if (n == 0)
     {
-        size_type new_cap = std::max(capacity_ * 2, size_ + n);
-        reserve(new_cap);
+        return begin() + index;
     }
 
-    for (size_type i = size_; i > index; --i)
-    {
-        traits_type::construct(alloc_, data_ + i + n - 1, std::move_if_noexcept(data_[i - 1]));
-        traits_type::destroy(alloc_, data_ + i - 1);
-    }
+    value_type tmp(value);
+    pointer gap = open_gap(index, n);
 
     for (size_type i = 0; i < n; ++i)
     {
-        traits_type::construct(alloc_, data_ + index + i, value);
+        traits_type::construct(alloc_, gap + i, tmp);
     }
 
     size_ += n;
 
-    return begin() + insert_pos;
+    return gap;
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt, typename>
-typename vector<T, Alloc>::iterator
-vector<T, Alloc>::insert(const_iterator pos, InputIt first, InputIt last)
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, InputIt first, InputIt last)
 {
     size_type insert_pos = pos - data_;
     size_type count = std::distance(first, last);
@@ -844,139 +720,76 @@ vector<T, Alloc>::insert(const_iterator pos, InputIt first, InputIt last)
         return data_ + insert_pos;
     }
 
-    if (size_ + count > capacity_)
+    pointer insert_ptr = open_gap(insert_pos, count);
+
+    for (pointer p = insert_ptr; first != last; ++first, ++p)
     {
-        reallocate_grow(size_ + count);
+        traits_type::construct(alloc_, p, *first);
     }
 
-    pointer insert_ptr = data_ + insert_pos;
-    move_range(insert_ptr + count, insert_ptr, data_ + size_);
-
-    copy_range(insert_ptr, first, last);
-
     size_ += count;
     return insert_ptr;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator
-vector<T, Alloc>::insert(const_iterator pos, std::initializer_list<value_type> il)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::insert(const_iterator pos, std::initializer_list<value_type> il)
 {
     return insert(pos, il.begin(), il.end());
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<class ... Args>
-typename vector<T, Alloc>::iterator
-vector<T, Alloc>::emplace(const_iterator pos, Args &&...args)
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::emplace(const_iterator pos, Args &&...args)
 {
     size_type insert_pos = pos - data_;
 
-    if (size_ == capacity_)
+    if (insert_pos == size_)
     {
-        reallocate_grow(size_ + 1);
+        emplace_back(std::forward<Args>(args)...);
+        return data_ + insert_pos;
     }
 
-    pointer insert_ptr = data_ + insert_pos;
+    value_type tmp(std::forward<Args>(args)...);
+    pointer insert_ptr = open_gap(insert_pos, 1);
 
-    move_range(insert_ptr + 1, insert_ptr, data_ + size_);
-
-    alloc_.construct(insert_ptr, std::forward<Args>(args)...);
+    traits_type::construct(alloc_, insert_ptr, std::move(tmp));
 
     ++size_;
     return insert_ptr;
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<class ... Args>
-void vector<T, Alloc>::emplace_back(Args &&...args)
+void vector<T, Alloc, Growth>::emplace_back(Args &&...args)
 {
     if (size_ == capacity_)
     {
-        reallocate_grow(size_ + 1);
+        realloc_append(std::forward<Args>(args)...);
+        return;
     }
 
-    alloc_.construct(data_ + size_, std::forward<Args>(args)...);
+    traits_type::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
     ++size_;
 }
 
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::push_back(const value_type& value)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::push_back(const value_type& value)
 {
-    if (size_ >= capacity_)
-    {
-        size_type new_cap = (capacity_ == 0) ? 1 : capacity_ * 2;
-        T * new_data = alloc_.allocate(new_cap);
-
-        if (data_ != nullptr)
-        {
-            for (size_type i = 0; i < size_; ++i)
-            {
-                if (data[i] != nullptr)
-                {
-                    traits_type::construct(alloc_, new_data + i, data_[i]);
-                }
-                traits_type::destroy(alloc_, data_ + i);
-            }
-
-            alloc_.deallocate(data_, capacity_);
-        }
-
-        if (data_ != nullptr)
-        {
-            alloc_.deallocate(data_, capacity_);
-        }
-
-        data_ = new_data;
-        capacity_ = new_cap;
-    }
-
-    traits_type::construct(alloc_, data_ + size_, value);
-    ++size_;
+    emplace_back(value);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::push_back(value_type&& value)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::push_back(value_type&& value)
 {
-    if (size_ >= capacity_)
-    {
-        size_type new_cap;
-        if (capacity_ == 0)
-        {
-            new_cap = 1;
-        }
-        else
-        {
-            new_cap = capacity_ * 2;
-        }
-        T * new_data = alloc_.allocate(new_cap);
-
-        for (size_type i = 0; i < size_; ++i)
-        {
-            if (data[i] != nullptr)
-            {
-                traits_type::construct(alloc_, new_data + i, std::move_if_noexcept(data_[i]));
-            }
-            traits_type::destroy(alloc_, data_ + i);
-        }
-
-        if (data_ != nullptr)
-        {
-            alloc_.deallocate(data_, capacity_);
-        }
-
-        data_ = new_data;
-        capacity_ = new_cap;
-    }
-
-    traits_type::construct(alloc_, data_ + size_, std::move(value));
-    ++size_;
+    emplace_back(std::move(value));
 }
 
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::pop_back()
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::pop_back()
 {
     if (size_ > 0)
     {
@@ -985,9 +798,9 @@ void vector<T, Alloc>::pop_back()
     }
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator
-vector<T, Alloc>::erase(const_iterator pos)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator pos)
 {
     size_type index = pos - begin();
     pointer p = data_ + index;
@@ -1004,9 +817,9 @@ vector<T, Alloc>::erase(const_iterator pos)
     return begin() + index;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::iterator
-vector<T, Alloc>::erase(const_iterator first, const_iterator last)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::iterator
+vector<T, Alloc, Growth>::erase(const_iterator first, const_iterator last)
 {
     size_type start = first - begin();
     size_type count = last - first;
@@ -1032,8 +845,8 @@ vector<T, Alloc>::erase(const_iterator first, const_iterator last)
 }
 
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::resize(size_type count)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::resize(size_type count)
 {
     if (count == size_)
     {
@@ -1052,26 +865,7 @@ void vector<T, Alloc>::resize(size_type count)
     {
         if (count > capacity_)
         {
-            size_type new_capacity = std::max(count, capacity_ * 2);
-            T* new_data = alloc_.allocate(new_capacity);
-
-            for (size_type i = 0; i < size_; ++i)
-            {
-                if (data[i] != nullptr)
-                {
-                    new (new_data + i) T(std::move_if_noexcept(data_[i]));
-                }
-
-                (data_ + i)->~T();
-            }
-
-            if (data_ != nullptr)
-            {
-                alloc_.deallocate(data_, capacity_);
-            }
-
-            data_ = new_data;
-            capacity_ = new_capacity;
+            reallocate_grow(recommend(count));
         }
 
         for (size_type i = size_; i < count; ++i)
@@ -1083,8 +877,8 @@ void vector<T, Alloc>::resize(size_type count)
     }
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::resize(size_type count, const value_type &value)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::resize(size_type count, const value_type &value)
 {
     if (count < size_)
     {
@@ -1098,26 +892,7 @@ void vector<T, Alloc>::resize(size_type count, const value_type &value)
     {
         if (count > capacity_)
         {
-            size_type new_capacity = std::max(count, capacity_ * 2);
-            T* new_data = alloc_.allocate(new_capacity);
-
-            for (size_type i = 0; i < size_; ++i)
-            {
-                if (data[i] != nullptr)
-                {
-                    new (new_data + i) T(std::move_if_noexcept(data_[i]));
-                }
-
-                (data_ + i)->~T();
-            }
-
-            if (data_ != nullptr)
-            {
-                alloc_.deallocate(data_, capacity_);
-            }
-
-            data_ = new_data;
-            capacity_ = new_capacity;
+            reallocate_grow(recommend(count));
         }
 
         for (size_type i = size_; i < count; ++i)
@@ -1129,8 +904,8 @@ void vector<T, Alloc>::resize(size_type count, const value_type &value)
     }
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::swap(vector &other) noexcept(
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::swap(vector &other) noexcept(
     std::allocator_traits<Alloc>::propagate_on_container_swap::value ||
     std::is_nothrow_swappable_v<Alloc>)
 {
@@ -1146,20 +921,20 @@ void vector<T, Alloc>::swap(vector &other) noexcept(
     }
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::allocator_type vector<T, Alloc>::get_allocator() const noexcept
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::allocator_type vector<T, Alloc, Growth>::get_allocator() const noexcept
 {
     return alloc_;
 }
 
-template<typename T, typename Alloc>
-typename vector<T, Alloc>::pointer vector<T, Alloc>::allocate(size_type n)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::pointer vector<T, Alloc, Growth>::allocate(size_type n)
 {
-    return traits_type::allocate(n);
+    return traits_type::allocate(alloc_, n);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::deallocate(pointer p, size_type n) noexcept
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::deallocate(pointer p, size_type n) noexcept
 {
     if (p != nullptr)
     {
@@ -1167,52 +942,161 @@ void vector<T, Alloc>::deallocate(pointer p, size_type n) noexcept
     }
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::destroy_elements(pointer first, pointer last) noexcept
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::destroy_elements(pointer first, pointer last) noexcept
 {
     for (pointer p = first; p != last; ++p)
     {
-        traits_type::destroy(p, p);
+        traits_type::destroy(alloc_, p);
     }
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::move_range(pointer dest, pointer first, pointer last) noexcept
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::move_range(pointer dest, pointer first, pointer last) noexcept
 {
     for (; first != last; ++first, ++dest)::new (static_cast<void*>(dest)) T(std::move(*first));
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::copy_range(pointer dest, const_pointer first, const_pointer last)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::copy_range(pointer dest, const_pointer first, const_pointer last)
 {
     for (; first != last; ++first, ++dest)
         ::new (static_cast<void*>(dest)) T(*first);
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::reallocate_grow(size_type new_cap)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::relocate_range(pointer first, pointer last, pointer dest) noexcept
 {
-    pointer new_data = traits_type::allocate(alloc_, new_cap);
-
-    move_range(new_data, data_, data_ + size_);
+    if constexpr (mib::is_trivially_relocatable_v<T>)
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+        }
+    }
+    else
+    {
+        for (; first != last; ++first, ++dest)
+        {
+            traits_type::construct(alloc_, dest, std::move_if_noexcept(*first));
+            traits_type::destroy(alloc_, first);
+        }
+    }
+}
 
-    for (size_type i = 0; i < size_; ++i)
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::size_type vector<T, Alloc, Growth>::recommend(size_type required) const
+{
+    const size_type ms = max_size();
+    if (required > ms)
     {
-        traits_type::destroy(alloc_, data_ + i);
+        throw std::length_error("vector::recommend: required > max_size()");
     }
+    return std::min<size_type>(Growth::next_capacity(capacity_, required, sizeof(T)), ms);
+}
 
-    if (data_)
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::reallocate_grow(size_type new_cap)
+{
+    if constexpr (mib::is_trivially_relocatable_v<T> && mib::has_reallocate_v<Alloc>)
     {
-        traits_type::deallocate(alloc_, data_, capacity_);
+        data_ = data_ ? alloc_.reallocate(data_, capacity_, new_cap) : allocate(new_cap);
     }
+    else
+    {
+        pointer new_data = allocate(new_cap);
+
+        relocate_range(data_, data_ + size_, new_data);
+        deallocate(data_, capacity_);
 
-    data_ = new_data;
+        data_ = new_data;
+    }
     capacity_ = new_cap;
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
+typename vector<T, Alloc, Growth>::pointer vector<T, Alloc, Growth>::open_gap(size_type index, size_type n)
+{
+    if (size_ + n > capacity_)
+    {
+        const size_type new_cap = recommend(size_ + n);
+        pointer new_data = allocate(new_cap);
+
+        relocate_range(data_, data_ + index, new_data);
+        relocate_range(data_ + index, data_ + size_, new_data + index + n);
+        deallocate(data_, capacity_);
+
+        data_ = new_data;
+        capacity_ = new_cap;
+        return data_ + index;
+    }
+
+    if constexpr (mib::is_trivially_relocatable_v<T>)
+    {
+        std::memmove(static_cast<void*>(data_ + index + n), static_cast<const void*>(data_ + index), (size_ - index) * sizeof(T));
+    }
+    else
+    {
+        pointer old_end = data_ + size_;
+        pointer src = old_end;
+        pointer dst = old_end + n;
+
+        while (src != data_ + index)
+        {
+            --src;
+            --dst;
+            if (dst >= old_end)
+            {
+                traits_type::construct(alloc_, dst, std::move_if_noexcept(*src));
+            }
+            else
+            {
+                *dst = std::move_if_noexcept(*src);
+            }
+        }
+        destroy_elements(data_ + index, std::min(data_ + index + n, old_end));
+    }
+    return data_ + index;
+}
+
+template<typename T, typename Alloc, typename Growth>
+template<class ... Args>
+void vector<T, Alloc, Growth>::realloc_append(Args &&...args)
+{
+    const size_type new_cap = recommend(size_ + 1);
+
+    if constexpr (mib::is_trivially_relocatable_v<T> && mib::has_reallocate_v<Alloc>)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        reallocate_grow(new_cap);
+        traits_type::construct(alloc_, data_ + size_, std::move(tmp));
+    }
+    else
+    {
+        pointer new_data = allocate(new_cap);
+
+        try
+        {
+            traits_type::construct(alloc_, new_data + size_, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            traits_type::deallocate(alloc_, new_data, new_cap);
+            throw;
+        }
+
+        relocate_range(data_, data_ + size_, new_data);
+        deallocate(data_, capacity_);
+
+        data_ = new_data;
+        capacity_ = new_cap;
+    }
+    ++size_;
+}
+
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt>
-void vector<T, Alloc>::construct_from_range(InputIt first, InputIt last, std::true_type)
+void vector<T, Alloc, Growth>::construct_from_range(InputIt first, InputIt last, std::true_type)
 {
     size_ = static_cast<size_type>(first);
     capacity_ = size_;
@@ -1220,13 +1104,13 @@ void vector<T, Alloc>::construct_from_range(InputIt first, InputIt last, std::tr
 
     for (size_type i = 0; i < size_; ++i)
     {
-        alloc_.construct(data_ + i, static_cast<T>(last));
+        traits_type::construct(alloc_, data_ + i, static_cast<T>(last));
     }
 }
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc, typename Growth>
 template<typename InputIt>
-void vector<T, Alloc>::construct_from_range(InputIt first, InputIt last, std::false_type)
+void vector<T, Alloc, Growth>::construct_from_range(InputIt first, InputIt last, std::false_type)
 {
     size_ = std::distance(first, last);
     capacity_ = size_;
@@ -1235,12 +1119,12 @@ void vector<T, Alloc>::construct_from_range(InputIt first, InputIt last, std::fa
     size_type i = 0;
     for (auto it = first; it != last; ++it, ++i)
     {
-        alloc_.construct(data_ + i, *it);
+        traits_type::construct(alloc_, data_ + i, *it);
     }
 }
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::swap_alloc_and_data(vector &other) noexcept
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::swap_alloc_and_data(vector &other) noexcept
 {
     using std::swap;
 
@@ -1255,8 +1139,8 @@ void vector<T, Alloc>::swap_alloc_and_data(vector &other) noexcept
 }
 
 
-template<typename T, typename Alloc>
-void vector<T, Alloc>::check_range(size_type pos) const
+template<typename T, typename Alloc, typename Growth>
+void vector<T, Alloc, Growth>::check_range(size_type pos) const
 {
     if (pos >= size_)
     {
@@ -1264,8 +1148,8 @@ void vector<T, Alloc>::check_range(size_type pos) const
     }
 }
 
-template <typename T, typename Alloc>
-void swap(vector<T,Alloc>& a, vector<T,Alloc>& b) noexcept(noexcept(a.swap(b)))
+template <typename T, typename Alloc, typename Growth>
+void swap(vector<T,Alloc,Growth>& a, vector<T,Alloc,Growth>& b) noexcept(noexcept(a.swap(b)))
 {
     a.swap(b);
 }
\ No newline at end of file